@@ -282,6 +282,15 @@ static constexpr const uint PLUGIN_OPTION_SEND_PROGRAM_CHANGES = 0x200;
  */
 static constexpr const uint PLUGIN_OPTION_SKIP_SENDING_NOTES = 0x400;
 
+/*!
+ * Process both channels of a forced stereo plugin through a single instance, one channel after the other.
+ * Only valid for mono effects without internal per-channel state (delay lines, filters, envelopes, etc),
+ * as that state would otherwise be shared between channels.
+ * Plugins cannot declare that, so this is only available for a built-in list of known stateless plugins.
+ * Has no effect unless PLUGIN_OPTION_FORCE_STEREO is also set.
+ */
+static constexpr const uint PLUGIN_OPTION_FORCE_STEREO_SINGLE_INSTANCE = 0x800;
+
 /*!
  * Special flag to indicate that plugin options are not yet set.
  * This flag exists because 0x0 as an option value is a valid one, so we need something else to indicate "null-ness".
@@ -1260,7 +1269,26 @@ typedef enum {
      * @a value1   New width
      * @a value2   New height
      */
-    ENGINE_CALLBACK_EMBED_UI_RESIZED = 48
+    ENGINE_CALLBACK_EMBED_UI_RESIZED = 48,
+
+    /*!
+     * A plugin bridge is close to missing its deadlines or timing out.
+     * Sent at most once per second while the bridge keeps misbehaving.
+     * @a pluginId Plugin Id
+     * @a value1   Number of missed deadlines since the last warning
+     * @a value2   Worst round-trip time since the last warning, in microseconds
+     * @a value3   Number of page faults in the bridge process thread since the last warning
+     * @a valuef   Worst round-trip time relative to the block duration, in percent
+     */
+    ENGINE_CALLBACK_BRIDGE_HEALTH_WARNING = 49,
+
+    /*!
+     * Progress of an offline render started with carla_render_to_file().
+     * @a value1   Progress, in percent
+     * @a value2   1 when the render has finished, 0 otherwise
+     * @a valueStr Main output filename
+     */
+    ENGINE_CALLBACK_RENDER_PROGRESS = 50
 
 } EngineCallbackOpcode;
 
@@ -1551,7 +1579,53 @@ typedef enum {
     /*!
      * Treat loaded plugins as standalone (that is, there is no host UI to manage them)
      */
-    ENGINE_OPTION_PLUGINS_ARE_STANDALONE = 35
+    ENGINE_OPTION_PLUGINS_ARE_STANDALONE = 35,
+
+    /*!
+     * Automatically restart plugin bridges that stopped responding, restoring their last known state.
+     * Default is no.
+     */
+    ENGINE_OPTION_RESTART_HUNG_BRIDGES = 36,
+
+    /*!
+     * Keep JACK applications running when their plugin is removed, so that loading a project using
+     * the same applications reuses them instead of starting them again.
+     * Unused applications are closed after the next project load, or when the engine closes.
+     * Default is no.
+     */
+    ENGINE_OPTION_RESIDENT_JACK_APPS = 37,
+
+    /*!
+     * Process plugins as a pipeline over all CPU cores while rendering offline (rack mode only).
+     * Each plugin works on its own block at the same time, adding (number of plugins - 1) blocks of latency.
+     * Default is no.
+     */
+    ENGINE_OPTION_OFFLINE_PIPELINE = 38,
+
+    /*!
+     * Number of CPU cores each FluidSynth instance may use to render its voices.
+     * Values above 1 enable the FluidSynth parallel renderer, which runs its own realtime worker threads.
+     * Applies to SoundFonts loaded afterwards.
+     * Default is 1.
+     */
+    ENGINE_OPTION_FLUIDSYNTH_CPU_CORES = 39,
+
+    /*!
+     * Lock all process memory into RAM and prefault the stack of audio threads,
+     * so buffers allocated for plugins and the engine never page fault while processing.
+     * Applies when the engine starts.
+     * Default is no.
+     */
+    ENGINE_OPTION_LOCK_MEMORY = 40,
+
+    /*!
+     * Time in milliseconds over which automation and MIDI CC changes of plugin control ports are ramped.
+     * Ramps advance at a fixed control rate, so parameter events no longer need to split the audio block.
+     * Only applies to LADSPA, DSSI and LV2 control ports, set to 0 to apply changes as steps.
+     * Applies to plugins loaded afterwards.
+     * Default is 0.
+     */
+    ENGINE_OPTION_PARAMETER_SMOOTHING_TIME = 41
 
 } EngineOption;
 
@@ -248,12 +248,18 @@ struct CARLA_API EngineOptions {
     bool preferUiBridges;
     bool uisAlwaysOnTop;
     bool pluginsAreStandalone;
+    bool restartHungBridges;
+    bool residentJackApps;
+    bool offlinePipeline;
+    bool lockMemory;
     uint bgColor;
     uint fgColor;
     float uiScale;
 
     uint maxParameters;
     uint uiBridgesTimeout;
+    uint fluidSynthCpuCores;
+    uint parameterSmoothingTime;
     uint audioBufferSize;
     uint audioSampleRate;
     bool audioTripleBuffer;
@@ -801,6 +807,9 @@ protected:
      */
     CarlaEngineClient(ProtectedData* pData);
 
+    friend class CarlaEngineEventPort;
+    friend struct RackGraph;
+
     CARLA_DECLARE_NON_COPYABLE(CarlaEngineClient)
 #endif
 };
@@ -961,6 +970,14 @@ public:
      */
     virtual void clearXruns() const noexcept;
 
+    /*!
+     * Get the number of page faults taken by audio threads while processing, since the engine started.
+     * Only the threads running the engine process callback are counted, as a single total;
+     * worker threads of the offline rack pipeline are not included.
+     * Counting only happens while ENGINE_OPTION_LOCK_MEMORY is enabled, both values stay at 0 otherwise.
+     */
+    void getPageFaults(uint32_t& minor, uint32_t& major) const noexcept;
+
     /*!
      * Dynamically change buffer size and/or sample rate while engine is running.
      * @see ENGINE_DRIVER_DEVICE_VARIABLE_BUFFER_SIZE
@@ -1094,6 +1111,15 @@ public:
      * Clear the currently set project filename.
      */
     void clearCurrentProjectFilename() noexcept;
+
+    /*!
+     * Render the current project offline into a file, plus one stem file per listed plugin.
+     * Blocks until done, taking over processing from the audio driver in the meantime.
+     * @note Only available in rack and patchbay process modes.
+     * @note Stems are per plugin only, individual patchbay ports cannot be rendered as stems yet.
+     */
+    bool renderToFile(const char* filename, uint64_t startFrame, uint64_t endFrame,
+                      const uint* stemPluginIds, uint stemCount);
 #endif
 
     // -------------------------------------------------------------------
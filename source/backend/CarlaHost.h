@@ -298,6 +298,18 @@ typedef struct _CarlaRuntimeEngineInfo {
      */
     uint32_t xruns;
 
+    /*!
+     * Number of minor page faults taken by audio threads while processing, since the engine started.
+     * Only counted while ENGINE_OPTION_LOCK_MEMORY is enabled.
+     */
+    uint32_t minorPageFaults;
+
+    /*!
+     * Number of major page faults taken by audio threads while processing, since the engine started.
+     * These needed disk access and are a likely cause of xruns.
+     */
+    uint32_t majorPageFaults;
+
 } CarlaRuntimeEngineInfo;
 
 /*!
@@ -541,6 +553,23 @@ CARLA_API_EXPORT const char* carla_get_current_project_filename(CarlaHostHandle
  */
 CARLA_API_EXPORT void carla_clear_project_filename(CarlaHostHandle handle);
 
+/*!
+ * Render the current project offline into @a filename, as a 32-bit float stereo WAV file.
+ * Every plugin listed in @a stemPluginIds gets its output written to a separate stem file next to it,
+ * named after the plugin, in the same pass.
+ * Real-time processing is suspended while rendering, and progress is reported through ENGINE_CALLBACK_RENDER_PROGRESS.
+ * The render can be stopped with carla_cancel_engine_action().
+ * @param startFrame    First frame to render
+ * @param endFrame      Frame where rendering stops, must be bigger than @a startFrame
+ * @param stemPluginIds Plugin Ids to write as separate stems, can be null if @a stemCount is 0
+ * @param stemCount     Number of plugin Ids in @a stemPluginIds
+ * @note Only available in rack and patchbay process modes, and with internal transport.
+ * @note Stems are per plugin only, individual patchbay ports cannot be rendered as stems yet.
+ */
+CARLA_API_EXPORT bool carla_render_to_file(CarlaHostHandle handle, const char* filename,
+                                           uint64_t startFrame, uint64_t endFrame,
+                                           const uint* stemPluginIds, uint stemCount);
+
 /*!
  * Connect two patchbay ports.
  * @param groupIdA Output (source) group
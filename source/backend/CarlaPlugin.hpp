@@ -160,6 +160,12 @@ public:
      */
     virtual uint32_t getLatencyInFrames() const noexcept;
 
+    /*!
+     * Check if the plugin shares processing state with other plugins.
+     * Such plugins must never be processed at the same time as the others.
+     */
+    virtual bool isProcessStateShared() const noexcept;
+
     // -------------------------------------------------------------------
     // Information (count)
 
@@ -986,6 +992,12 @@ public:
     static CarlaPluginPtr newSFZero(const Initializer& init);
 
     static CarlaPluginPtr newJackApp(const Initializer& init);
+
+    /*!
+     * Close JACK applications kept resident for @a engine which were not reused.
+     * @see ENGINE_OPTION_RESIDENT_JACK_APPS
+     */
+    static void closeResidentJackApps(CarlaEngine* engine);
 #endif
 
     // -------------------------------------------------------------------
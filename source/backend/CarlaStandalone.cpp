@@ -388,6 +388,12 @@ static void carla_engine_init_common(const CarlaHostStandalone& standalone, Carl
     engine->setOption(CB::ENGINE_OPTION_CLIENT_NAME_PREFIX, 0, standalone.engineOptions.clientNamePrefix);
 
     engine->setOption(CB::ENGINE_OPTION_PLUGINS_ARE_STANDALONE, standalone.engineOptions.pluginsAreStandalone, nullptr);
+    engine->setOption(CB::ENGINE_OPTION_RESTART_HUNG_BRIDGES, standalone.engineOptions.restartHungBridges, nullptr);
+    engine->setOption(CB::ENGINE_OPTION_RESIDENT_JACK_APPS, standalone.engineOptions.residentJackApps, nullptr);
+    engine->setOption(CB::ENGINE_OPTION_OFFLINE_PIPELINE, standalone.engineOptions.offlinePipeline, nullptr);
+    engine->setOption(CB::ENGINE_OPTION_FLUIDSYNTH_CPU_CORES, static_cast<int>(standalone.engineOptions.fluidSynthCpuCores), nullptr);
+    engine->setOption(CB::ENGINE_OPTION_LOCK_MEMORY, standalone.engineOptions.lockMemory, nullptr);
+    engine->setOption(CB::ENGINE_OPTION_PARAMETER_SMOOTHING_TIME, static_cast<int>(standalone.engineOptions.parameterSmoothingTime), nullptr);
 #endif // BUILD_BRIDGE
 }
 
@@ -564,11 +570,14 @@ const CarlaRuntimeEngineInfo* carla_get_runtime_engine_info(CarlaHostHandle hand
     // reset
     retInfo.load = 0.0f;
     retInfo.xruns = 0;
+    retInfo.minorPageFaults = 0;
+    retInfo.majorPageFaults = 0;
 
     CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, &retInfo);
 
     retInfo.load = handle->engine->getDSPLoad();
     retInfo.xruns = handle->engine->getTotalXruns();
+    handle->engine->getPageFaults(retInfo.minorPageFaults, retInfo.majorPageFaults);
 
     return &retInfo;
 }
@@ -1006,6 +1015,36 @@ void carla_set_engine_option(CarlaHostHandle handle, EngineOption option, int va
             CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
             shandle.engineOptions.pluginsAreStandalone = (value != 0);
             break;
+
+        case CB::ENGINE_OPTION_RESTART_HUNG_BRIDGES:
+            CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+            shandle.engineOptions.restartHungBridges = (value != 0);
+            break;
+
+        case CB::ENGINE_OPTION_RESIDENT_JACK_APPS:
+            CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+            shandle.engineOptions.residentJackApps = (value != 0);
+            break;
+
+        case CB::ENGINE_OPTION_OFFLINE_PIPELINE:
+            CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+            shandle.engineOptions.offlinePipeline = (value != 0);
+            break;
+
+        case CB::ENGINE_OPTION_FLUIDSYNTH_CPU_CORES:
+            CARLA_SAFE_ASSERT_RETURN(value >= 1,);
+            shandle.engineOptions.fluidSynthCpuCores = static_cast<uint>(value);
+            break;
+
+        case CB::ENGINE_OPTION_LOCK_MEMORY:
+            CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+            shandle.engineOptions.lockMemory = (value != 0);
+            break;
+
+        case CB::ENGINE_OPTION_PARAMETER_SMOOTHING_TIME:
+            CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+            shandle.engineOptions.parameterSmoothingTime = static_cast<uint>(value);
+            break;
         }
     }
 
@@ -1095,6 +1134,20 @@ void carla_clear_project_filename(CarlaHostHandle handle)
     handle->engine->clearCurrentProjectFilename();
 }
 
+bool carla_render_to_file(CarlaHostHandle handle, const char* filename,
+                          uint64_t startFrame, uint64_t endFrame,
+                          const uint* stemPluginIds, uint stemCount)
+{
+    CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+    CARLA_SAFE_ASSERT_RETURN(stemPluginIds != nullptr || stemCount == 0, false);
+    CARLA_SAFE_ASSERT_WITH_LAST_ERROR_RETURN(handle->engine != nullptr, "Engine is not initialized", false);
+
+    carla_debug("carla_render_to_file(%p, \"%s\", " P_UINT64 ", " P_UINT64 ", %p, %u)",
+                handle, filename, startFrame, endFrame, stemPluginIds, stemCount);
+
+    return handle->engine->renderToFile(filename, startFrame, endFrame, stemPluginIds, stemCount);
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 
 bool carla_patchbay_connect(CarlaHostHandle handle, bool external, uint groupIdA, uint portIdA, uint groupIdB, uint portIdB)
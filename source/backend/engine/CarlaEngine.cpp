@@ -427,6 +427,10 @@ bool CarlaEngine::close()
         removeAllPlugins();
     }
 
+#if defined(HAVE_JACK) && !defined(BUILD_BRIDGE_ALTERNATIVE_ARCH)
+    CarlaPlugin::closeResidentJackApps(this);
+#endif
+
     pData->close();
 
     callback(true, true, ENGINE_CALLBACK_ENGINE_STOPPED, 0, 0, 0, 0, 0.0f, nullptr);
@@ -532,6 +536,16 @@ void CarlaEngine::clearXruns() const noexcept
 #endif
 }
 
+void CarlaEngine::getPageFaults(uint32_t& minor, uint32_t& major) const noexcept
+{
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    minor = pData->minorPageFaults;
+    major = pData->majorPageFaults;
+#else
+    minor = major = 0;
+#endif
+}
+
 bool CarlaEngine::showDeviceControlPanel() const noexcept
 {
     return false;
@@ -1571,6 +1585,9 @@ const EngineOptions& CarlaEngine::getOptions() const noexcept
 
 EngineTimeInfo CarlaEngine::getTimeInfo() const noexcept
 {
+    if (const EngineTimeInfo* const threadTimeInfo = ScopedThreadTimeInfo::get())
+        return *threadTimeInfo;
+
     return pData->timeInfo;
 }
 
@@ -2259,6 +2276,36 @@ void CarlaEngine::setOption(const EngineOption option, const int value, const ch
         CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
         pData->options.pluginsAreStandalone = (value != 0);
         break;
+
+    case ENGINE_OPTION_RESTART_HUNG_BRIDGES:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        pData->options.restartHungBridges = (value != 0);
+        break;
+
+    case ENGINE_OPTION_RESIDENT_JACK_APPS:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        pData->options.residentJackApps = (value != 0);
+        break;
+
+    case ENGINE_OPTION_OFFLINE_PIPELINE:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        pData->options.offlinePipeline = (value != 0);
+        break;
+
+    case ENGINE_OPTION_FLUIDSYNTH_CPU_CORES:
+        CARLA_SAFE_ASSERT_RETURN(value >= 1,);
+        pData->options.fluidSynthCpuCores = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_LOCK_MEMORY:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        pData->options.lockMemory = (value != 0);
+        break;
+
+    case ENGINE_OPTION_PARAMETER_SMOOTHING_TIME:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+        pData->options.parameterSmoothingTime = static_cast<uint>(value);
+        break;
     }
 }
 
@@ -3608,6 +3655,11 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
     }
 #endif
 
+#if defined(HAVE_JACK) && !defined(BUILD_BRIDGE_ALTERNATIVE_ARCH)
+    // resident JACK applications not reused by this project are no longer needed
+    CarlaPlugin::closeResidentJackApps(this);
+#endif
+
     if (pData->options.resetXruns)
         clearXruns();
 
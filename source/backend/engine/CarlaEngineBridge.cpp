@@ -32,12 +32,17 @@
 #include "CarlaBackendUtils.hpp"
 #include "CarlaBase64Utils.hpp"
 #include "CarlaBridgeUtils.hpp"
+#include "CarlaTimeUtils.hpp"
 #include "CarlaMIDI.h"
 
 #ifdef __SSE2_MATH__
 # include <xmmintrin.h>
 #endif
 
+#ifdef CARLA_OS_LINUX
+# include <sys/resource.h>
+#endif
+
 #include "water/files/File.h"
 #include "water/misc/Time.h"
 
@@ -112,7 +117,8 @@ public:
           fClosingDown(false),
           fIsOffline(false),
           fFirstIdle(true),
-          fLastPingTime(-1)
+          fLastPingTime(-1),
+          fHostApiVersion(CARLA_PLUGIN_BRIDGE_API_VERSION_MINIMUM)
     {
         carla_debug("CarlaEngineBridge::CarlaEngineBridge(\"%s\", \"%s\", \"%s\", \"%s\")", audioPoolBaseName, rtClientBaseName, nonRtClientBaseName, nonRtServerBaseName);
     }
@@ -200,6 +206,8 @@ public:
         const uint32_t apiVersion = fShmNonRtClientControl.readUInt();
         CARLA_SAFE_ASSERT_RETURN(apiVersion >= CARLA_PLUGIN_BRIDGE_API_VERSION_MINIMUM, false);
 
+        fHostApiVersion = apiVersion;
+
         const uint32_t shmRtClientDataSize = fShmNonRtClientControl.readUInt();
         CARLA_SAFE_ASSERT_INT2(shmRtClientDataSize == sizeof(BridgeRtClientData), shmRtClientDataSize, sizeof(BridgeRtClientData));
 
@@ -498,32 +506,9 @@ public:
                         fShmNonRtServerControl.commitWrite();
                     }
 
-                    // kPluginBridgeNonRtServerParameterData2
-                    {
-                        // uint/index, uint/size, str[] (name), uint/size, str[] (symbol), uint/size, str[] (unit)
-                        fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerParameterData2);
-                        fShmNonRtServerControl.writeUInt(i);
-
-                        if (! plugin->getParameterName(i, bufStr))
-                            std::snprintf(bufStr, STR_MAX, "Param %u", i+1);
-                        bufStrSize = carla_fixedValue(1U, 32U, static_cast<uint32_t>(std::strlen(bufStr)));
-                        fShmNonRtServerControl.writeUInt(bufStrSize);
-                        fShmNonRtServerControl.writeCustomData(bufStr, bufStrSize);
-
-                        if (! plugin->getParameterSymbol(i, bufStr))
-                            bufStr[0] = '\0';
-                        bufStrSize = carla_fixedValue(1U, 64U, static_cast<uint32_t>(std::strlen(bufStr)));
-                        fShmNonRtServerControl.writeUInt(bufStrSize);
-                        fShmNonRtServerControl.writeCustomData(bufStr, bufStrSize);
-
-                        if (! plugin->getParameterUnit(i, bufStr))
-                            bufStr[0] = '\0';
-                        bufStrSize = carla_fixedValue(1U, 32U, static_cast<uint32_t>(std::strlen(bufStr)));
-                        fShmNonRtServerControl.writeUInt(bufStrSize);
-                        fShmNonRtServerControl.writeCustomData(bufStr, bufStrSize);
-
-                        fShmNonRtServerControl.commitWrite();
-                    }
+                    // kPluginBridgeNonRtServerParameterData2, hosts using API 11 or later request it after loading
+                    if (fHostApiVersion < 11)
+                        writeParameterInfo(plugin, i);
 
                     // kPluginBridgeNonRtServerParameterRanges
                     {
@@ -1053,6 +1038,27 @@ public:
                 break;
             }
 
+            case kPluginBridgeNonRtClientGetParameterInfo: {
+                const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
+
+                for (uint32_t i=0, count=plugin->getParameterCount(); i<count; ++i)
+                {
+                    const ParameterData& paramData(plugin->getParameterData(i));
+
+                    if (paramData.type != PARAMETER_INPUT && paramData.type != PARAMETER_OUTPUT)
+                        continue;
+                    if ((paramData.hints & PARAMETER_IS_ENABLED) == 0)
+                        continue;
+
+                    writeParameterInfo(plugin, i);
+                    fShmNonRtServerControl.waitIfDataIsReachingLimit();
+                }
+
+                fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerParameterInfoDone);
+                fShmNonRtServerControl.commitWrite();
+                break;
+            }
+
             case kPluginBridgeNonRtClientPrepareForSave: {
                 if (! plugin->isEnabled())
                 {
@@ -1454,6 +1460,8 @@ protected:
 
                     CARLA_SAFE_ASSERT_BREAK(fShmAudioPool.data != nullptr);
 
+                    const int64_t procStartTime = carla_gettime_us();
+
                     if (plugin.get() != nullptr && plugin->isEnabled() && plugin->tryLock(fIsOffline))
                     {
                         const BridgeTimeInfo& bridgeTimeInfo(fShmRtClientControl.data->timeInfo);
@@ -1589,6 +1597,7 @@ protected:
                         carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
                     }
 
+                    updateTelemetry(procStartTime, frames);
                 }   break;
 
                 case kPluginBridgeRtClientQuit: {
@@ -1615,6 +1624,36 @@ protected:
         }
     }
 
+    // called from process thread above
+    void updateTelemetry(const int64_t procStartTime, const uint32_t frames) noexcept
+    {
+        BridgeRtClientTelemetry& telemetry(fShmRtClientControl.data->telemetry);
+
+        const int64_t procEndTime = carla_gettime_us();
+        const uint64_t procTime = procEndTime > procStartTime ? static_cast<uint64_t>(procEndTime - procStartTime) : 0;
+        const uint64_t deadline = static_cast<uint64_t>(static_cast<double>(frames) / pData->sampleRate * 1000000.0);
+
+        telemetry.processTime = procTime;
+
+        if (procTime > telemetry.maxProcessTime)
+            telemetry.maxProcessTime = procTime;
+
+        if (procTime > deadline && ! fIsOffline)
+            ++telemetry.missedDeadlines;
+
+#ifdef CARLA_OS_LINUX
+        struct rusage usage;
+        if (::getrusage(RUSAGE_THREAD, &usage) == 0)
+        {
+            telemetry.minorFaults = static_cast<uint64_t>(usage.ru_minflt);
+            telemetry.majorFaults = static_cast<uint64_t>(usage.ru_majflt);
+        }
+#endif
+
+        // must be last, server uses this to know new data is available
+        ++telemetry.blockCount;
+    }
+
     // called from process thread above
     EngineEvent* getNextFreeInputEvent() const noexcept
     {
@@ -1628,6 +1667,39 @@ protected:
         return nullptr;
     }
 
+    // kPluginBridgeNonRtServerParameterData2, server mutex must be locked
+    void writeParameterInfo(const CarlaPluginPtr& plugin, const uint32_t index)
+    {
+        char bufStr[STR_MAX+1];
+        carla_zeroChars(bufStr, STR_MAX+1);
+
+        uint32_t bufStrSize;
+
+        // uint/index, uint/size, str[] (name), uint/size, str[] (symbol), uint/size, str[] (unit)
+        fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerParameterData2);
+        fShmNonRtServerControl.writeUInt(index);
+
+        if (! plugin->getParameterName(index, bufStr))
+            std::snprintf(bufStr, STR_MAX, "Param %u", index+1);
+        bufStrSize = carla_fixedValue(1U, 32U, static_cast<uint32_t>(std::strlen(bufStr)));
+        fShmNonRtServerControl.writeUInt(bufStrSize);
+        fShmNonRtServerControl.writeCustomData(bufStr, bufStrSize);
+
+        if (! plugin->getParameterSymbol(index, bufStr))
+            bufStr[0] = '\0';
+        bufStrSize = carla_fixedValue(1U, 64U, static_cast<uint32_t>(std::strlen(bufStr)));
+        fShmNonRtServerControl.writeUInt(bufStrSize);
+        fShmNonRtServerControl.writeCustomData(bufStr, bufStrSize);
+
+        if (! plugin->getParameterUnit(index, bufStr))
+            bufStr[0] = '\0';
+        bufStrSize = carla_fixedValue(1U, 32U, static_cast<uint32_t>(std::strlen(bufStr)));
+        fShmNonRtServerControl.writeUInt(bufStrSize);
+        fShmNonRtServerControl.writeCustomData(bufStr, bufStrSize);
+
+        fShmNonRtServerControl.commitWrite();
+    }
+
     void latencyChanged(const uint32_t samples) noexcept override
     {
         const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
@@ -1654,6 +1726,7 @@ private:
     bool fIsOffline;
     bool fFirstIdle;
     int64_t fLastPingTime;
+    uint32_t fHostApiVersion;
 
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineBridge)
 };
@@ -96,6 +96,8 @@ CarlaEngineClient::ProtectedData::ProtectedData(const CarlaEngine& eng) noexcept
     :  engine(eng),
        active(false),
        latency(0),
+       rackEventsIn(nullptr),
+       rackEventsOut(nullptr),
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
        cvSourcePorts(),
        egraph(eg),
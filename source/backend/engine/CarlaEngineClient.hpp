@@ -35,6 +35,10 @@ struct CarlaEngineClient::ProtectedData {
     bool     active;
     uint32_t latency;
 
+    // rack mode event buffers, when not using the engine ones
+    EngineEvent* rackEventsIn;
+    EngineEvent* rackEventsOut;
+
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     CarlaEngineCVSourcePortsForStandalone cvSourcePorts;
     EngineInternalGraph& egraph;
@@ -210,11 +210,17 @@ EngineOptions::EngineOptions() noexcept
 #endif
       uisAlwaysOnTop(true),
       pluginsAreStandalone(false),
+      restartHungBridges(false),
+      residentJackApps(false),
+      offlinePipeline(false),
+      lockMemory(false),
       bgColor(0x000000ff),
       fgColor(0xffffffff),
       uiScale(1.0f),
       maxParameters(MAX_DEFAULT_PARAMETERS),
       uiBridgesTimeout(4000),
+      fluidSynthCpuCores(1),
+      parameterSmoothingTime(0),
       audioBufferSize(512),
       audioSampleRate(44100),
       audioTripleBuffer(false),
@@ -19,6 +19,7 @@
 #include "CarlaEngineInit.hpp"
 #include "CarlaEngineInternal.hpp"
 
+#include <cerrno>
 #include <ctime>
 #include <sys/time.h>
 
@@ -34,7 +35,11 @@ public:
     CarlaEngineDummy()
         : CarlaEngine(),
           CarlaThread("CarlaEngineDummy"),
-          fRunning(false)
+          fRunning(false),
+          fCycles(0),
+          fDeadlineMisses(0),
+          fWorstLateness(0),
+          fWorstCycleTime(0)
     {
         carla_debug("CarlaEngineDummy::CarlaEngineDummy()");
 
@@ -54,7 +59,7 @@ public:
         CARLA_SAFE_ASSERT_RETURN(clientName != nullptr && clientName[0] != '\0', false);
         carla_debug("CarlaEngineDummy::init(\"%s\")", clientName);
 
-        if (pData->options.processMode != ENGINE_PROCESS_MODE_CONTINUOUS_RACK)
+        if (pData->options.processMode != ENGINE_PROCESS_MODE_CONTINUOUS_RACK && pData->options.processMode != ENGINE_PROCESS_MODE_PATCHBAY)
         {
             setLastError("Invalid process mode");
             return false;
@@ -75,7 +80,8 @@ public:
 
         pData->graph.create(2, 2, 0, 0);
 
-        if (! startThread())
+        // optional realtime scheduling, so load tests see the same priorities as a real audio device
+        if (! startThread(std::getenv("CARLA_DUMMY_REALTIME") != nullptr))
         {
             close();
             setLastError("Failed to start dummy audio thread");
@@ -84,6 +90,9 @@ public:
 
         patchbayRefresh(true, false, false);
 
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+            refreshExternalGraphPorts<PatchbayGraph>(pData->graph.getPatchbayGraph(), false, false);
+
         callback(true, true,
                  ENGINE_CALLBACK_ENGINE_STARTED,
                  0,
@@ -135,11 +144,9 @@ public:
     // -------------------------------------------------------------------
     // Patchbay
 
-    bool patchbayRefresh(const bool sendHost, const bool sendOSC, const bool) override
+    template<class Graph>
+    bool refreshExternalGraphPorts(Graph* const graph, const bool sendHost, const bool sendOSC)
     {
-        CARLA_SAFE_ASSERT_RETURN(pData->graph.isReady(), false);
-
-        RackGraph* const graph = pData->graph.getRackGraph();
         CARLA_SAFE_ASSERT_RETURN(graph != nullptr, false);
 
         ExternalGraph& extGraph(graph->extGraph);
@@ -189,41 +196,81 @@ public:
         return true;
     }
 
+    bool patchbayRefresh(const bool sendHost, const bool sendOSC, const bool external) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(pData->graph.isReady(), false);
+
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_CONTINUOUS_RACK)
+            return refreshExternalGraphPorts<RackGraph>(pData->graph.getRackGraph(), sendHost, sendOSC);
+
+        if (sendHost)
+            pData->graph.setUsingExternalHost(external);
+        if (sendOSC)
+            pData->graph.setUsingExternalOSC(external);
+
+        if (external)
+            return refreshExternalGraphPorts<PatchbayGraph>(pData->graph.getPatchbayGraph(), sendHost, sendOSC);
+
+        return CarlaEngine::patchbayRefresh(sendHost, sendOSC, false);
+    }
+
     // -------------------------------------------------------------------
 
 protected:
-    static int64_t getTimeInMicroseconds() noexcept
+    // must use the same clock as sleepUntil()
+    static int64_t getTimeInNanoseconds() noexcept
     {
     #if defined(CARLA_OS_MAC) || defined(CARLA_OS_WIN)
         struct timeval tv;
         gettimeofday(&tv, nullptr);
 
-        return (tv.tv_sec * 1000000) + tv.tv_usec;
+        return (static_cast<int64_t>(tv.tv_sec) * 1000000 + tv.tv_usec) * 1000;
     #else
         struct timespec ts;
-    # ifdef CLOCK_MONOTONIC_RAW
-        clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
-    # else
         clock_gettime(CLOCK_MONOTONIC, &ts);
-    # endif
 
-        return (ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    #endif
+    }
+
+    // sleep until an absolute point in time, drift-free where the system allows
+    static void sleepUntil(const int64_t deadline) noexcept
+    {
+    #if defined(CARLA_OS_MAC) || defined(CARLA_OS_WIN)
+        const int64_t remaining = deadline - getTimeInNanoseconds();
+
+        if (remaining <= 0)
+            return;
+
+      # ifdef CARLA_OS_WIN
+        carla_msleep(static_cast<uint>(remaining / 1000000));
+      # else
+        struct timespec ts;
+        ts.tv_sec  = static_cast<time_t>(remaining / 1000000000);
+        ts.tv_nsec = static_cast<long>(remaining % 1000000000);
+        nanosleep(&ts, nullptr);
+      # endif
+    #else
+        struct timespec ts;
+        ts.tv_sec  = static_cast<time_t>(deadline / 1000000000);
+        ts.tv_nsec = static_cast<long>(deadline % 1000000000);
+
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
     #endif
     }
 
     void run() override
     {
         const uint32_t bufferSize = pData->bufferSize;
-        const int64_t cycleTime = static_cast<int64_t>(
-            static_cast<double>(bufferSize) / pData->sampleRate * 1000000 + 0.5);
+        const double cycleTime = static_cast<double>(bufferSize) / pData->sampleRate * 1000000000.0;
 
         int delay = 0;
         if (const char* const delaystr = std::getenv("CARLA_BRIDGE_DUMMY"))
             if ((delay = atoi(delaystr)) == 1)
                 delay = 0;
 
-        carla_stdout("CarlaEngineDummy audio thread started, cycle time: " P_INT64 "ms, delay %ds",
-                     cycleTime / 1000, delay);
+        carla_stdout("CarlaEngineDummy audio thread started, cycle time: %.3fms, delay %ds",
+                     cycleTime / 1000000.0, delay);
 
         float* audioIns[2] = {
             (float*)std::malloc(sizeof(float)*bufferSize),
@@ -243,39 +290,66 @@ protected:
         carla_zeroFloats(audioIns[1], bufferSize);
         carla_zeroStructs(pData->events.in,  kMaxEngineEventInternalCount);
 
-        int64_t oldTime, newTime;
+        fCycles = fDeadlineMisses = 0;
+        fWorstLateness = fWorstCycleTime = 0;
+
+        // deadlines are computed from an anchor point instead of accumulated, so they never drift.
+        // after a miss the anchor moves to the current time, like a real device continuing after an xrun.
+        int64_t anchorTime = getTimeInNanoseconds();
+        uint64_t anchorCycles = 0;
 
         while (! shouldThreadExit())
         {
             if (delay > 0)
+            {
                 carla_sleep(static_cast<uint>(delay));
+                anchorTime = getTimeInNanoseconds();
+                anchorCycles = 0;
+            }
+
+            const int64_t startTime = getTimeInNanoseconds();
+
+            {
+                const PendingRtEventsRunner prt(this, bufferSize, true);
 
-            oldTime = getTimeInMicroseconds();
+                carla_zeroFloats(audioOuts[0], bufferSize);
+                carla_zeroFloats(audioOuts[1], bufferSize);
 
-            const PendingRtEventsRunner prt(this, bufferSize, true);
+                if (prt.canProcess())
+                {
+                    carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
 
-            carla_zeroFloats(audioOuts[0], bufferSize);
-            carla_zeroFloats(audioOuts[1], bufferSize);
-            carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
+                    pData->graph.process(pData, audioIns, audioOuts, bufferSize);
+                }
+            }
 
-            pData->graph.process(pData, audioIns, audioOuts, bufferSize);
+            const int64_t endTime = getTimeInNanoseconds();
+            const int64_t deadline = anchorTime + static_cast<int64_t>(static_cast<double>(++anchorCycles) * cycleTime + 0.5);
 
-            newTime = getTimeInMicroseconds();
-            CARLA_SAFE_ASSERT_CONTINUE(newTime >= oldTime);
+            ++fCycles;
 
-            const int64_t remainingTime = cycleTime - (newTime - oldTime);
+            if (endTime - startTime > fWorstCycleTime)
+                fWorstCycleTime = endTime - startTime;
 
-            if (remainingTime <= 0)
+            if (endTime > deadline)
             {
+                const int64_t lateness = endTime - deadline;
+
                 ++pData->xruns;
-                carla_stdout("XRUN! remaining time: " P_INT64 ", old: " P_INT64 ", new: " P_INT64 ")",
-                             remainingTime, oldTime, newTime);
-            }
-            else if (remainingTime >= 1000)
-            {
-                CARLA_SAFE_ASSERT_CONTINUE(remainingTime < 1000000); // 1 sec
-                carla_msleep(static_cast<uint>(remainingTime / 1000));
+                ++fDeadlineMisses;
+
+                if (lateness > fWorstLateness)
+                    fWorstLateness = lateness;
+
+                carla_stdout("XRUN! cycle " P_UINT64 " missed its deadline by " P_INT64 "us",
+                             fCycles, lateness / 1000);
+
+                anchorTime = endTime;
+                anchorCycles = 0;
+                continue;
             }
+
+            sleepUntil(deadline);
         }
 
         std::free(audioIns[0]);
@@ -283,7 +357,10 @@ protected:
         std::free(audioOuts[0]);
         std::free(audioOuts[1]);
 
-        carla_stdout("CarlaEngineDummy audio thread finished with %u Xruns", pData->xruns);
+        carla_stdout("CarlaEngineDummy audio thread finished after " P_UINT64 " cycles with " P_UINT64 " deadline misses, "
+                     "worst lateness " P_INT64 "us, worst cycle time " P_INT64 "us (%.1f%% of cycle)",
+                     fCycles, fDeadlineMisses, fWorstLateness / 1000, fWorstCycleTime / 1000,
+                     static_cast<double>(fWorstCycleTime) / cycleTime * 100.0);
     }
 
     // -------------------------------------------------------------------
@@ -291,6 +368,12 @@ protected:
 private:
     bool fRunning;
 
+    // deadline accounting, only touched by the audio thread
+    uint64_t fCycles;
+    uint64_t fDeadlineMisses;
+    int64_t fWorstLateness;
+    int64_t fWorstCycleTime;
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineDummy)
 };
 
@@ -16,14 +16,21 @@
  */
 
 #include "CarlaEngineGraph.hpp"
+#include "CarlaEngineClient.hpp"
 #include "CarlaEngineInternal.hpp"
 #include "CarlaPlugin.hpp"
 
 #include "CarlaMathUtils.hpp"
 #include "CarlaScopeUtils.hpp"
+#include "CarlaSemUtils.hpp"
+#include "CarlaThread.hpp"
 
 #include "CarlaMIDI.h"
 
+#ifndef CARLA_OS_WIN
+# include <unistd.h>
+#endif
+
 using water::jmax;
 using water::jmin;
 using water::AudioProcessor;
@@ -828,6 +835,432 @@ void RackGraph::Buffers::setBufferSize(const uint32_t bufferSize, const bool cre
     }
 }
 
+// -----------------------------------------------------------------------
+// RackGraph offline pipeline
+//
+// Each enabled plugin becomes a stage, and all stages run at the same time on their own block:
+// while stage N processes block X, stage N+1 processes block X-1 (the output of stage N from the previous cycle).
+// This allows even a serial chain of plugins to use all CPU cores while rendering offline,
+// at the cost of (stages-1) blocks of latency.
+// The time info of each block travels with it, so plugins see the transport of the block they are processing.
+// Plugins that share processing state with others (see CarlaPlugin::isProcessStateShared) keep the serial path.
+
+static uint getNumberOfCPUs() noexcept
+{
+#ifdef CARLA_OS_WIN
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+    return std::max(1U, static_cast<uint>(sysInfo.dwNumberOfProcessors));
+#else
+    const long numCPUs = sysconf(_SC_NPROCESSORS_ONLN);
+    return numCPUs > 0 ? static_cast<uint>(numCPUs) : 1U;
+#endif
+}
+
+struct RackGraph::OfflinePipeline {
+    struct Stage {
+        uint pluginIndex;
+        const CarlaPlugin* pluginPtr; // only for comparison, never dereferenced
+        bool passthroughEvents;
+        float* audioIn[2];
+        float* audioOut[2];
+        float* unusedBuf;
+        EngineEvent* eventsIn;
+        EngineEvent* eventsOut;
+        EngineTimeInfo* timeInfo;
+    };
+
+    class Worker : public CarlaThread
+    {
+    public:
+        Worker(OfflinePipeline* const pipeline) noexcept
+            : CarlaThread("RackGraphOfflineWorker"),
+              kPipeline(pipeline),
+              fStartSem()
+        {
+            carla_sem_create2(fStartSem, false);
+        }
+
+        ~Worker() noexcept override
+        {
+            stop();
+            carla_sem_destroy2(fStartSem);
+        }
+
+        void start() noexcept
+        {
+            startThread();
+        }
+
+        void stop() noexcept
+        {
+            signalThreadShouldExit();
+            carla_sem_post(fStartSem);
+            stopThread(5000);
+        }
+
+        void trigger() noexcept
+        {
+            carla_sem_post(fStartSem);
+        }
+
+    protected:
+        void run() override
+        {
+            for (; ! shouldThreadExit();)
+            {
+                if (! carla_sem_timedwait(fStartSem, 100))
+                    continue;
+                if (shouldThreadExit())
+                    break;
+
+                kPipeline->processStages();
+                carla_sem_post(kPipeline->fDoneSem);
+            }
+        }
+
+    private:
+        OfflinePipeline* const kPipeline;
+        carla_sem_t fStartSem;
+
+        CARLA_DECLARE_NON_COPYABLE(Worker)
+    };
+
+    OfflinePipeline(RackGraph* const rack, const uint32_t bufferSize) noexcept
+        : kRack(rack),
+          fBufferSize(bufferSize),
+          fStages(nullptr),
+          fNumStages(0),
+          fAllocatedStages(0),
+          fNextStage(0),
+          fStageMutex(),
+          fData(nullptr),
+          fFrames(0),
+          fWorkers(nullptr),
+          fNumWorkers(0),
+          fDoneSem()
+    {
+        carla_sem_create2(fDoneSem, false);
+
+        // the calling thread processes stages too
+        const uint numWorkers = getNumberOfCPUs() - 1;
+
+        if (numWorkers == 0)
+            return;
+
+        try {
+            fWorkers = new Worker*[numWorkers];
+        } CARLA_SAFE_EXCEPTION_RETURN("OfflinePipeline workers",);
+
+        for (; fNumWorkers < numWorkers; ++fNumWorkers)
+        {
+            fWorkers[fNumWorkers] = new Worker(this);
+            fWorkers[fNumWorkers]->start();
+        }
+
+        carla_stdout("RackGraph offline pipeline started with %u worker threads", fNumWorkers);
+    }
+
+    ~OfflinePipeline() noexcept
+    {
+        for (uint i=0; i < fNumWorkers; ++i)
+            delete fWorkers[i];
+
+        delete[] fWorkers;
+        fWorkers = nullptr;
+        fNumWorkers = 0;
+
+        freeStages();
+        carla_sem_destroy2(fDoneSem);
+    }
+
+    void setBufferSize(const uint32_t bufferSize) noexcept
+    {
+        freeStages();
+        fBufferSize = bufferSize;
+    }
+
+    uint32_t getLatency() const noexcept
+    {
+        return fNumStages > 1 ? (fNumStages - 1) * fBufferSize : 0;
+    }
+
+    // collect enabled plugins as stages, restarting the pipeline if they changed
+    bool prepare(CarlaEngine::ProtectedData* const data, const uint32_t frames) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(frames <= fBufferSize, false);
+
+#ifndef CARLA_ENGINE_THREAD_TIME_INFO_AVAILABLE
+        // stages cannot be given the time info of their own block
+        return false;
+#endif
+
+        uint numStages = 0;
+
+        for (uint i=0; i < data->curPluginCount; ++i)
+        {
+            const CarlaPluginPtr plugin = data->plugins[i].plugin;
+
+            if (plugin.get() == nullptr || ! plugin->isEnabled())
+                continue;
+
+            // plugins sharing state with others cannot run concurrently, use the serial path
+            if (plugin->isProcessStateShared())
+            {
+                fNumStages = 0;
+                return false;
+            }
+
+            ++numStages;
+        }
+
+        // nothing to gain
+        if (numStages < 2)
+        {
+            fNumStages = 0;
+            return false;
+        }
+
+        bool changed = numStages != fNumStages;
+
+        if (numStages > fAllocatedStages && ! allocateStages(numStages))
+        {
+            fNumStages = 0;
+            return false;
+        }
+
+        for (uint i=0, j=0; i < data->curPluginCount; ++i)
+        {
+            const CarlaPluginPtr plugin = data->plugins[i].plugin;
+
+            if (plugin.get() == nullptr || ! plugin->isEnabled())
+                continue;
+
+            Stage& stage(fStages[j++]);
+
+            if (stage.pluginPtr != plugin.get())
+                changed = true;
+
+            stage.pluginIndex = i;
+            stage.pluginPtr   = plugin.get();
+        }
+
+        if (changed)
+        {
+            carla_stdout("RackGraph offline pipeline now has %u stages, restarting", numStages);
+
+            for (uint i=0; i < numStages; ++i)
+                clearStage(fStages[i]);
+
+            fNumStages = numStages;
+        }
+
+        return true;
+    }
+
+    void process(CarlaEngine::ProtectedData* const data,
+                 const float* const inBufReal[2], float* const outBufReal[2], const uint32_t frames) noexcept
+    {
+        // the first stage takes the new block
+        carla_copyFloats(fStages[0].audioIn[0], inBufReal[0], frames);
+        carla_copyFloats(fStages[0].audioIn[1], inBufReal[1], frames);
+        carla_copyStructs(fStages[0].eventsIn, data->events.in, kMaxEngineEventInternalCount);
+        *fStages[0].timeInfo = data->timeInfo;
+
+        {
+            const CarlaMutexLocker cml(fStageMutex);
+            fData = data;
+            fFrames = frames;
+            fNextStage = 0;
+        }
+
+        for (uint i=0; i < fNumWorkers; ++i)
+            fWorkers[i]->trigger();
+
+        processStages();
+
+        for (uint i=0; i < fNumWorkers;)
+        {
+            if (carla_sem_timedwait(fDoneSem, 1000))
+                ++i;
+        }
+
+        // the last stage gives the final output
+        const Stage& last(fStages[fNumStages-1]);
+
+        carla_copyFloats(outBufReal[0], last.audioOut[0], frames);
+        carla_copyFloats(outBufReal[1], last.audioOut[1], frames);
+
+        // like the serial path, only the last plugin's own events reach the output
+        if (last.passthroughEvents)
+            carla_zeroStructs(data->events.out, kMaxEngineEventInternalCount);
+        else
+            carla_copyStructs(data->events.out, last.eventsOut, kMaxEngineEventInternalCount);
+
+        // move each stage output into the next stage input, ready for the next cycle
+        for (uint i=fNumStages-1; i > 0; --i)
+        {
+            Stage& stage(fStages[i]);
+            Stage& prev(fStages[i-1]);
+
+            std::swap(stage.audioIn[0], prev.audioOut[0]);
+            std::swap(stage.audioIn[1], prev.audioOut[1]);
+            std::swap(stage.timeInfo, prev.timeInfo);
+
+            if (prev.passthroughEvents)
+                std::swap(stage.eventsIn, prev.eventsIn);
+            else
+                std::swap(stage.eventsIn, prev.eventsOut);
+        }
+    }
+
+    // called from the engine thread and all workers, until there are no more stages left
+    void processStages() noexcept
+    {
+        for (;;)
+        {
+            uint index;
+
+            {
+                const CarlaMutexLocker cml(fStageMutex);
+
+                if (fNextStage >= fNumStages)
+                    return;
+
+                index = fNextStage++;
+            }
+
+            try {
+                processStage(fStages[index]);
+            } CARLA_SAFE_EXCEPTION("OfflinePipeline::processStage");
+        }
+    }
+
+private:
+    RackGraph* const kRack;
+    uint32_t fBufferSize;
+
+    Stage* fStages;
+    uint fNumStages;
+    uint fAllocatedStages;
+    uint fNextStage;
+    CarlaMutex fStageMutex;
+
+    // current cycle
+    CarlaEngine::ProtectedData* fData;
+    uint32_t fFrames;
+
+    Worker** fWorkers;
+    uint fNumWorkers;
+    carla_sem_t fDoneSem;
+
+    void processStage(Stage& stage)
+    {
+        carla_zeroFloats(stage.audioOut[0], fFrames);
+        carla_zeroFloats(stage.audioOut[1], fFrames);
+        carla_zeroStructs(stage.eventsOut, kMaxEngineEventInternalCount);
+
+        const CarlaPluginPtr plugin = fData->plugins[stage.pluginIndex].plugin;
+
+        // plugin went away or got disabled since the pipeline was prepared, let the data through
+        if (plugin.get() != stage.pluginPtr || ! plugin->isEnabled() || ! plugin->tryLock(true))
+        {
+            carla_copyFloats(stage.audioOut[0], stage.audioIn[0], fFrames);
+            carla_copyFloats(stage.audioOut[1], stage.audioIn[1], fFrames);
+            stage.passthroughEvents = true;
+            return;
+        }
+
+        EnginePluginData& pluginData(fData->plugins[stage.pluginIndex]);
+
+        // each stage runs one cycle behind the previous one
+        pluginData.stemDelay = static_cast<uint32_t>(&stage - fStages) * fBufferSize;
+
+        const ScopedThreadTimeInfo stti(*stage.timeInfo);
+
+        kRack->processPlugin(plugin, pluginData,
+                             stage.audioIn, stage.audioOut, stage.unusedBuf, fFrames,
+                             stage.eventsIn, stage.eventsOut);
+
+        // if plugin has no midi out, pass along its input events
+        stage.passthroughEvents = plugin->getMidiOutCount() == 0 && stage.eventsIn[0].type != kEngineEventTypeNull;
+    }
+
+    bool allocateStages(const uint numStages) noexcept
+    {
+        freeStages();
+
+        try {
+            fStages = new Stage[numStages];
+        } CARLA_SAFE_EXCEPTION_RETURN("OfflinePipeline stages", false);
+
+        carla_zeroStructs(fStages, numStages);
+        fAllocatedStages = numStages;
+
+        try {
+            for (uint i=0; i < numStages; ++i)
+            {
+                Stage& stage(fStages[i]);
+
+                stage.audioIn[0]  = new float[fBufferSize];
+                stage.audioIn[1]  = new float[fBufferSize];
+                stage.audioOut[0] = new float[fBufferSize];
+                stage.audioOut[1] = new float[fBufferSize];
+                stage.unusedBuf   = new float[fBufferSize];
+                stage.eventsIn    = new EngineEvent[kMaxEngineEventInternalCount];
+                stage.eventsOut   = new EngineEvent[kMaxEngineEventInternalCount];
+                stage.timeInfo    = new EngineTimeInfo();
+            }
+        }
+        catch(...) {
+            carla_safe_exception("OfflinePipeline stage buffers", __FILE__, __LINE__);
+            freeStages();
+            return false;
+        }
+
+        return true;
+    }
+
+    void freeStages() noexcept
+    {
+        if (fStages == nullptr)
+            return;
+
+        for (uint i=0; i < fAllocatedStages; ++i)
+        {
+            Stage& stage(fStages[i]);
+
+            delete[] stage.audioIn[0];
+            delete[] stage.audioIn[1];
+            delete[] stage.audioOut[0];
+            delete[] stage.audioOut[1];
+            delete[] stage.unusedBuf;
+            delete[] stage.eventsIn;
+            delete[] stage.eventsOut;
+            delete stage.timeInfo;
+        }
+
+        delete[] fStages;
+        fStages = nullptr;
+        fNumStages = fAllocatedStages = 0;
+    }
+
+    void clearStage(Stage& stage) noexcept
+    {
+        stage.passthroughEvents = false;
+
+        carla_zeroFloats(stage.audioIn[0], fBufferSize);
+        carla_zeroFloats(stage.audioIn[1], fBufferSize);
+        carla_zeroFloats(stage.audioOut[0], fBufferSize);
+        carla_zeroFloats(stage.audioOut[1], fBufferSize);
+        carla_zeroStructs(stage.eventsIn, kMaxEngineEventInternalCount);
+        carla_zeroStructs(stage.eventsOut, kMaxEngineEventInternalCount);
+        stage.timeInfo->clear();
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(OfflinePipeline)
+};
+
 // -----------------------------------------------------------------------
 // RackGraph
 
@@ -837,6 +1270,7 @@ RackGraph::RackGraph(CarlaEngine* const engine, const uint32_t ins, const uint32
       outputs(outs),
       isOffline(false),
       audioBuffers(),
+      offlinePipeline(nullptr),
       kEngine(engine)
 {
     setBufferSize(engine->getBufferSize());
@@ -844,17 +1278,38 @@ RackGraph::RackGraph(CarlaEngine* const engine, const uint32_t ins, const uint32
 
 RackGraph::~RackGraph() noexcept
 {
+    delete offlinePipeline;
+    offlinePipeline = nullptr;
+
     extGraph.clear();
 }
 
 void RackGraph::setBufferSize(const uint32_t bufferSize) noexcept
 {
     audioBuffers.setBufferSize(bufferSize, (inputs > 0 || outputs > 0));
+
+    if (offlinePipeline != nullptr)
+        offlinePipeline->setBufferSize(bufferSize);
 }
 
 void RackGraph::setOffline(const bool offline) noexcept
 {
     isOffline = offline;
+
+    if (offline && kEngine->getOptions().offlinePipeline)
+    {
+        if (offlinePipeline == nullptr)
+        {
+            try {
+                offlinePipeline = new OfflinePipeline(this, kEngine->getBufferSize());
+            } CARLA_SAFE_EXCEPTION("RackGraph offline pipeline");
+        }
+    }
+    else if (offlinePipeline != nullptr)
+    {
+        delete offlinePipeline;
+        offlinePipeline = nullptr;
+    }
 }
 
 bool RackGraph::connect(const uint groupA, const uint portA, const uint groupB, const uint portB) noexcept
@@ -974,10 +1429,14 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
     CARLA_SAFE_ASSERT_RETURN(data->events.in != nullptr,);
     CARLA_SAFE_ASSERT_RETURN(data->events.out != nullptr,);
 
+    if (isOffline && offlinePipeline != nullptr && offlinePipeline->prepare(data, frames))
+        return offlinePipeline->process(data, inBufReal, outBufReal, frames);
+
     // safe copy
     float* const dummyBuf = audioBuffers.unusedBuf;
     float* const inBuf0   = audioBuffers.inBufTmp[0];
     float* const inBuf1   = audioBuffers.inBufTmp[1];
+    float* const inBuf[2] = { inBuf0, inBuf1 };
 
     // initialize audio inputs
     carla_copyFloats(inBuf0, inBufReal[0], frames);
@@ -990,9 +1449,7 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
     // initialize event outputs (zero)
     carla_zeroStructs(data->events.out, kMaxEngineEventInternalCount);
 
-    uint32_t oldAudioInCount  = 0;
-    uint32_t oldAudioOutCount = 0;
-    uint32_t oldMidiOutCount  = 0;
+    uint32_t oldMidiOutCount = 0;
     bool processed = false;
 
     // process plugins
@@ -1033,84 +1490,107 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
             }
         }
 
-        oldAudioInCount  = plugin->getAudioInCount();
-        oldAudioOutCount = plugin->getAudioOutCount();
-        oldMidiOutCount  = plugin->getMidiOutCount();
+        oldMidiOutCount = plugin->getMidiOutCount();
 
-        const uint32_t numInBufs  = std::max(oldAudioInCount,  2U);
-        const uint32_t numOutBufs = std::max(oldAudioOutCount, 2U);
-        const uint32_t numCvBufs  = std::max(plugin->getCVInCount(), plugin->getCVOutCount());
+        data->plugins[i].stemDelay = 0;
+        processPlugin(plugin, data->plugins[i], inBuf, outBufReal, dummyBuf, frames);
 
-        const float* inBuf[numInBufs];
-        inBuf[0] = inBuf0;
-        inBuf[1] = inBuf1;
+        processed = true;
+    }
+}
 
-        float* outBuf[numOutBufs];
-        outBuf[0] = outBufReal[0];
-        outBuf[1] = outBufReal[1];
+void RackGraph::processPlugin(const CarlaPluginPtr& plugin, EnginePluginData& pluginData,
+                              float* const inBufStereo[2], float* const outBufStereo[2], float* const dummyBuf,
+                              const uint32_t frames, EngineEvent* const eventsIn, EngineEvent* const eventsOut)
+{
+    const uint32_t audioInCount  = plugin->getAudioInCount();
+    const uint32_t audioOutCount = plugin->getAudioOutCount();
 
-        float* cvBuf[numCvBufs];
-        for (uint32_t j=0; j<numCvBufs; ++j)
-            cvBuf[j] = dummyBuf;
+    const uint32_t numInBufs  = std::max(audioInCount,  2U);
+    const uint32_t numOutBufs = std::max(audioOutCount, 2U);
+    const uint32_t numCvBufs  = std::max(plugin->getCVInCount(), plugin->getCVOutCount());
 
-        if (numInBufs > 2 || numOutBufs > 2 || numCvBufs != 0)
-        {
-            carla_zeroFloats(dummyBuf, frames);
+    const float* inBuf[numInBufs];
+    inBuf[0] = inBufStereo[0];
+    inBuf[1] = inBufStereo[1];
 
-            for (uint32_t j=2; j<numInBufs; ++j)
-                inBuf[j] = dummyBuf;
+    float* outBuf[numOutBufs];
+    outBuf[0] = outBufStereo[0];
+    outBuf[1] = outBufStereo[1];
 
-            for (uint32_t j=2; j<numOutBufs; ++j)
-                outBuf[j] = dummyBuf;
-        }
+    float* cvBuf[numCvBufs];
+    for (uint32_t j=0; j<numCvBufs; ++j)
+        cvBuf[j] = dummyBuf;
 
-        // process
-        plugin->initBuffers();
-        plugin->process(inBuf, outBuf, cvBuf, cvBuf, frames);
-        plugin->unlock();
+    if (numInBufs > 2 || numOutBufs > 2 || numCvBufs != 0)
+    {
+        carla_zeroFloats(dummyBuf, frames);
 
-        // if plugin has no audio inputs, add input buffer
-        if (oldAudioInCount == 0)
-        {
-            carla_addFloats(outBufReal[0], inBuf0, frames);
-            carla_addFloats(outBufReal[1], inBuf1, frames);
-        }
+        for (uint32_t j=2; j<numInBufs; ++j)
+            inBuf[j] = dummyBuf;
 
-        // if plugin only has 1 output, copy it to the 2nd
-        if (oldAudioOutCount == 1)
-        {
-            carla_copyFloats(outBufReal[1], outBufReal[0], frames);
-        }
+        for (uint32_t j=2; j<numOutBufs; ++j)
+            outBuf[j] = dummyBuf;
+    }
 
-        // set peaks
-        {
-            EnginePluginData& pluginData(data->plugins[i]);
+    // custom event buffers, used instead of the engine ones
+    CarlaEngineClient* const client = plugin->getEngineClient();
+    client->pData->rackEventsIn  = eventsIn;
+    client->pData->rackEventsOut = eventsOut;
 
-            if (oldAudioInCount > 0)
-            {
-                pluginData.peaks[0] = carla_findMaxNormalizedFloat(inBuf0, frames);
-                pluginData.peaks[1] = carla_findMaxNormalizedFloat(inBuf1, frames);
-            }
-            else
-            {
-                pluginData.peaks[0] = 0.0f;
-                pluginData.peaks[1] = 0.0f;
-            }
+    // process
+    plugin->initBuffers();
+    plugin->process(inBuf, outBuf, cvBuf, cvBuf, frames);
+    plugin->unlock();
 
-            if (oldAudioOutCount > 0)
-            {
-                pluginData.peaks[2] = carla_findMaxNormalizedFloat(outBufReal[0], frames);
-                pluginData.peaks[3] = carla_findMaxNormalizedFloat(outBufReal[1], frames);
-            }
-            else
-            {
-                pluginData.peaks[2] = 0.0f;
-                pluginData.peaks[3] = 0.0f;
-            }
-        }
+    client->pData->rackEventsIn  = nullptr;
+    client->pData->rackEventsOut = nullptr;
 
-        processed = true;
+    // if plugin has no audio inputs, add input buffer
+    if (audioInCount == 0)
+    {
+        carla_addFloats(outBufStereo[0], inBufStereo[0], frames);
+        carla_addFloats(outBufStereo[1], inBufStereo[1], frames);
+    }
+
+    // if plugin only has 1 output, copy it to the 2nd
+    if (audioOutCount == 1)
+    {
+        carla_copyFloats(outBufStereo[1], outBufStereo[0], frames);
+    }
+
+    // set peaks
+    if (audioInCount > 0)
+    {
+        pluginData.peaks[0] = carla_findMaxNormalizedFloat(inBufStereo[0], frames);
+        pluginData.peaks[1] = carla_findMaxNormalizedFloat(inBufStereo[1], frames);
+    }
+    else
+    {
+        pluginData.peaks[0] = 0.0f;
+        pluginData.peaks[1] = 0.0f;
+    }
+
+    if (audioOutCount > 0)
+    {
+        pluginData.peaks[2] = carla_findMaxNormalizedFloat(outBufStereo[0], frames);
+        pluginData.peaks[3] = carla_findMaxNormalizedFloat(outBufStereo[1], frames);
+    }
+    else
+    {
+        pluginData.peaks[2] = 0.0f;
+        pluginData.peaks[3] = 0.0f;
     }
+
+    pluginData.writeStemRT(outBufStereo, 2, frames);
+}
+
+uint32_t RackGraph::getOfflinePipelineLatency() const noexcept
+{
+    if (! isOffline || offlinePipeline == nullptr)
+        return 0;
+
+    return offlinePipeline->getLatency();
 }
 
 void RackGraph::processHelper(CarlaEngine::ProtectedData* const data, const float* const* const inBuf, float* const* const outBuf, const uint32_t frames)
@@ -1546,7 +2026,7 @@ public:
     {
         const CarlaPluginPtr plugin = fPlugin;
 
-        if (plugin.get() == nullptr || !plugin->isEnabled() || !plugin->tryLock(kEngine->isOffline()))
+        if (plugin.get() == nullptr || !plugin->isEnabled() || !plugin->tryLock(kEngine->isOffline() || isNonRealtime()))
         {
             audio.clear();
             cvOut.clear();
@@ -1610,6 +2090,10 @@ public:
                 outPeaks[i] = carla_findMaxNormalizedFloat(audioBuffers[i], numSamples);
 
             kEngine->setPluginPeaksRT(plugin->getId(), inPeaks, outPeaks);
+
+            kEngine->pData->plugins[plugin->getId()].writeStemRT(audioBuffers,
+                                                                  jmin(plugin->getAudioOutCount(), numChan2),
+                                                                  numSamples);
         }
         else
         {
@@ -2754,6 +3238,14 @@ void EngineInternalGraph::setOffline(const bool offline)
     }
 }
 
+uint32_t EngineInternalGraph::getOfflinePipelineLatency() const noexcept
+{
+    if (! fIsRack || fRack == nullptr)
+        return 0;
+
+    return fRack->getOfflinePipelineLatency();
+}
+
 RackGraph* EngineInternalGraph::getRackGraph() const noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(fIsRack, nullptr);
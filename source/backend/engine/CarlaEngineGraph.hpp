@@ -33,6 +33,8 @@ using water::MidiBuffer;
 
 CARLA_BACKEND_START_NAMESPACE
 
+struct EnginePluginData;
+
 // -----------------------------------------------------------------------
 
 struct PatchbayPosition {
@@ -138,6 +140,10 @@ struct RackGraph {
         CARLA_DECLARE_NON_COPYABLE(Buffers)
     } audioBuffers;
 
+    // offline only, processes plugins as a pipeline over several threads
+    struct OfflinePipeline;
+    OfflinePipeline* offlinePipeline;
+
     RackGraph(CarlaEngine* engine, uint32_t inputs, uint32_t outputs) noexcept;
     ~RackGraph() noexcept;
 
@@ -157,6 +163,14 @@ struct RackGraph {
     // extended, will call process() in the middle
     void processHelper(CarlaEngine::ProtectedData* data, const float* const* inBuf, float* const* outBuf, uint32_t frames);
 
+    // a single plugin, from stereo buffers
+    void processPlugin(const CarlaPluginPtr& plugin, EnginePluginData& pluginData,
+                       float* const inBuf[2], float* const outBuf[2], float* dummyBuf, uint32_t frames,
+                       EngineEvent* eventsIn = nullptr, EngineEvent* eventsOut = nullptr);
+
+    // latency introduced by the offline pipeline, in frames
+    uint32_t getOfflinePipelineLatency() const noexcept;
+
     CarlaEngine* const kEngine;
     CARLA_DECLARE_NON_COPYABLE(RackGraph)
 };
@@ -18,12 +18,20 @@
 #include "CarlaEngineInternal.hpp"
 #include "CarlaPlugin.hpp"
 #include "CarlaSemUtils.hpp"
+#include "CarlaTimeUtils.hpp"
 
 #include "jackbridge/JackBridge.hpp"
 
+#include <cerrno>
+#include <cstdio>
 #include <ctime>
 #include <sys/time.h>
 
+#ifdef CARLA_OS_LINUX
+# include <sys/mman.h>
+# include <sys/resource.h>
+#endif
+
 CARLA_BACKEND_START_NAMESPACE
 
 // -----------------------------------------------------------------------
@@ -373,6 +381,64 @@ EngineEvent* CarlaEngine::getInternalEventBuffer(const bool isInput) const noexc
     return isInput ? pData->events.in : pData->events.out;
 }
 
+#ifdef CARLA_OS_LINUX
+// -----------------------------------------------------------------------
+// Memory locking
+//
+// mlockall() applies to the whole process, so it is shared by all engines in it.
+// The last engine to close unlocks it, unless it was already locked by the host before any engine started.
+
+static CarlaMutex gMemoryLockMutex;
+static uint gMemoryLockCount = 0;
+static bool gMemoryLockedByHost = false;
+
+static bool isProcessMemoryLocked() noexcept
+{
+    FILE* const file = std::fopen("/proc/self/status", "r");
+    CARLA_SAFE_ASSERT_RETURN(file != nullptr, false);
+
+    char line[128];
+    unsigned long lockedKb = 0;
+
+    while (std::fgets(line, sizeof(line), file) != nullptr)
+    {
+        if (std::sscanf(line, "VmLck: %lu kB", &lockedKb) == 1)
+            break;
+    }
+
+    std::fclose(file);
+    return lockedKb != 0;
+}
+
+static bool lockProcessMemory() noexcept
+{
+    const CarlaMutexLocker cml(gMemoryLockMutex);
+
+    if (gMemoryLockCount == 0)
+    {
+        gMemoryLockedByHost = isProcessMemoryLocked();
+
+        if (! gMemoryLockedByHost && mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        {
+            carla_stderr2("Failed to lock memory, realtime buffers may page fault: %s", std::strerror(errno));
+            return false;
+        }
+    }
+
+    ++gMemoryLockCount;
+    return true;
+}
+
+static void unlockProcessMemory() noexcept
+{
+    const CarlaMutexLocker cml(gMemoryLockMutex);
+    CARLA_SAFE_ASSERT_RETURN(gMemoryLockCount != 0,);
+
+    if (--gMemoryLockCount == 0 && ! gMemoryLockedByHost)
+        munlockall();
+}
+#endif
+
 // -----------------------------------------------------------------------
 // CarlaEngine::ProtectedData
 
@@ -408,7 +474,10 @@ CarlaEngine::ProtectedData::ProtectedData(CarlaEngine* const engine)
       plugins(nullptr),
       xruns(0),
       dspLoad(0.0f),
+      minorPageFaults(0),
+      majorPageFaults(0),
 #endif
+      memoryLocked(false),
       pluginsToDeleteMutex(),
       pluginsToDelete(),
       events(),
@@ -416,7 +485,12 @@ CarlaEngine::ProtectedData::ProtectedData(CarlaEngine* const engine)
       graph(engine),
 #endif
       time(timeInfo, options.transportMode),
-      nextAction()
+      nextAction(),
+      rtLogger()
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    , renderMutex(),
+      rendering(false)
+#endif
 {
 #ifdef BUILD_BRIDGE_ALTERNATIVE_ARCH
     plugins[0].plugin = nullptr;
@@ -511,10 +585,19 @@ bool CarlaEngine::ProtectedData::init(const char* const clientName)
     plugins = new EnginePluginData[maxPluginNumber];
     xruns = 0;
     dspLoad = 0.0f;
+    minorPageFaults = 0;
+    majorPageFaults = 0;
+#endif
+
+#ifdef CARLA_OS_LINUX
+    // everything mapped from now on, including plugin and engine buffers, gets locked and prefaulted
+    if (options.lockMemory && ! memoryLocked)
+        memoryLocked = lockProcessMemory();
 #endif
 
     nextAction.clearAndReset();
     runner.start();
+    rtLogger.start();
 
     return true;
 }
@@ -530,6 +613,7 @@ void CarlaEngine::ProtectedData::close()
     aboutToClose = true;
 
     runner.stop();
+    rtLogger.stop();
     nextAction.clearAndReset();
 
 #if defined(HAVE_LIBLO) && !defined(BUILD_BRIDGE)
@@ -553,6 +637,14 @@ void CarlaEngine::ProtectedData::close()
 
     events.clear();
     name.clear();
+
+#ifdef CARLA_OS_LINUX
+    if (memoryLocked)
+    {
+        unlockProcessMemory();
+        memoryLocked = false;
+    }
+#endif
 }
 
 void CarlaEngine::ProtectedData::initTime(const char* const features)
@@ -694,55 +786,129 @@ void CarlaEngine::ProtectedData::doNextPluginAction() noexcept
 // -----------------------------------------------------------------------
 // PendingRtEventsRunner
 
-static int64_t getTimeInMicroseconds() noexcept
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+static void getThreadPageFaults(long& minor, long& major) noexcept
 {
-#if defined(CARLA_OS_MAC) || defined(CARLA_OS_WIN)
-    struct timeval tv;
-    gettimeofday(&tv, nullptr);
+#if defined(CARLA_OS_LINUX) && defined(RUSAGE_THREAD)
+    struct rusage usage;
 
-    return (tv.tv_sec * 1000000) + tv.tv_usec;
-#else
-    struct timespec ts;
-# ifdef CLOCK_MONOTONIC_RAW
-    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
-# else
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-# endif
+    if (getrusage(RUSAGE_THREAD, &usage) == 0)
+    {
+        minor = usage.ru_minflt;
+        major = usage.ru_majflt;
+        return;
+    }
+#endif
 
-    return (ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+    minor = major = 0;
+}
 #endif
+
+#ifdef CARLA_OS_LINUX
+// touch the stack that processing might use, so it does not fault later.
+// this is the only warm-up done, heap memory is prefaulted by mlockall itself.
+static __attribute__((noinline)) void prefaultStack() noexcept
+{
+    uint8_t stack[128 * 1024];
+    std::memset(stack, 0, sizeof(stack));
+
+    // keep the compiler from optimizing the write away
+    __asm__ __volatile__("" : : "r"(stack) : "memory");
 }
 
+static __thread bool sStackPrefaulted = false;
+#endif
+
 PendingRtEventsRunner::PendingRtEventsRunner(CarlaEngine* const engine,
                                              const uint32_t frames,
-                                             const bool calcDSPLoad) noexcept
+                                             const bool calcDSPLoad,
+                                             const bool isOfflineRender) noexcept
     : pData(engine->pData),
-      prevTime(calcDSPLoad ? getTimeInMicroseconds() : 0)
+      rtLogRedirect(pData->rtLogger),
+      prevTime(calcDSPLoad ? carla_gettime_us() : 0)
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+      // only touch the lock when needed, the renderer already holds it
+    , renderLocked((isOfflineRender || ! pData->rendering) && pData->renderMutex.tryLock()),
+      // getrusage is a syscall, skip it unless asked for
+      countPageFaults(pData->options.lockMemory),
+      prevMinorFaults(0),
+      prevMajorFaults(0)
+#endif
 {
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // the offline renderer owns time and events for now
+    if (! renderLocked)
+        return;
+#else
+    // unused
+    (void)isOfflineRender;
+#endif
+
+#ifdef CARLA_OS_LINUX
+    // warm-up on the first cycle of each audio thread
+    if (pData->memoryLocked && ! sStackPrefaulted)
+    {
+        prefaultStack();
+        sStackPrefaulted = true;
+    }
+#endif
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    if (countPageFaults)
+        getThreadPageFaults(prevMinorFaults, prevMajorFaults);
+#endif
+
     pData->time.preProcess(frames);
 }
 
 PendingRtEventsRunner::~PendingRtEventsRunner() noexcept
 {
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    if (! renderLocked)
+        return;
+#endif
+
     pData->doNextPluginAction();
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-    if (prevTime > 0)
+    if (countPageFaults)
     {
-        const int64_t newTime = getTimeInMicroseconds();
+        long minorFaults, majorFaults;
+        getThreadPageFaults(minorFaults, majorFaults);
 
-        if (newTime < prevTime)
-            return;
+        if (minorFaults > prevMinorFaults)
+            __sync_add_and_fetch(&pData->minorPageFaults, static_cast<uint32_t>(minorFaults - prevMinorFaults));
+        if (majorFaults > prevMajorFaults)
+            __sync_add_and_fetch(&pData->majorPageFaults, static_cast<uint32_t>(majorFaults - prevMajorFaults));
+    }
 
-        const double timeDiff = static_cast<double>(newTime - prevTime) / 1000000.0;
-        const double maxTime = pData->bufferSize / pData->sampleRate;
-        const float dspLoad = static_cast<float>(timeDiff / maxTime) * 100.0f;
+    if (prevTime > 0)
+    {
+        const int64_t newTime = carla_gettime_us();
 
-        if (dspLoad > pData->dspLoad)
-            pData->dspLoad = std::min(100.0f, dspLoad);
-        else
-            pData->dspLoad *= static_cast<float>(1.0 - maxTime) + 1e-12f;
+        if (newTime >= prevTime)
+        {
+            const double timeDiff = static_cast<double>(newTime - prevTime) / 1000000.0;
+            const double maxTime = pData->bufferSize / pData->sampleRate;
+            const float dspLoad = static_cast<float>(timeDiff / maxTime) * 100.0f;
+
+            if (dspLoad > pData->dspLoad)
+                pData->dspLoad = std::min(100.0f, dspLoad);
+            else
+                pData->dspLoad *= static_cast<float>(1.0 - maxTime) + 1e-12f;
+        }
     }
+
+    pData->renderMutex.unlock();
+#endif
+}
+
+bool PendingRtEventsRunner::canProcess() const noexcept
+{
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    return renderLocked;
+#else
+    return true;
 #endif
 }
 
@@ -863,6 +1029,43 @@ ScopedRunnerStopper::~ScopedRunnerStopper() noexcept
         pData->runner.start();
 }
 
+// -----------------------------------------------------------------------
+// ScopedThreadTimeInfo
+
+#ifdef CARLA_ENGINE_THREAD_TIME_INFO_AVAILABLE
+static __thread const EngineTimeInfo* sThreadTimeInfo = nullptr;
+#endif
+
+ScopedThreadTimeInfo::ScopedThreadTimeInfo(const EngineTimeInfo& timeInfo) noexcept
+#ifdef CARLA_ENGINE_THREAD_TIME_INFO_AVAILABLE
+    : prevTimeInfo(sThreadTimeInfo)
+{
+    sThreadTimeInfo = &timeInfo;
+}
+#else
+    : prevTimeInfo(nullptr)
+{
+    // unused
+    (void)timeInfo;
+}
+#endif
+
+ScopedThreadTimeInfo::~ScopedThreadTimeInfo() noexcept
+{
+#ifdef CARLA_ENGINE_THREAD_TIME_INFO_AVAILABLE
+    sThreadTimeInfo = prevTimeInfo;
+#endif
+}
+
+const EngineTimeInfo* ScopedThreadTimeInfo::get() noexcept
+{
+#ifdef CARLA_ENGINE_THREAD_TIME_INFO_AVAILABLE
+    return sThreadTimeInfo;
+#else
+    return nullptr;
+#endif
+}
+
 // -----------------------------------------------------------------------
 // ScopedEngineEnvironmentLocker
 
@@ -880,3 +1083,9 @@ ScopedEngineEnvironmentLocker::~ScopedEngineEnvironmentLocker() noexcept
 // -----------------------------------------------------------------------
 
 CARLA_BACKEND_END_NAMESPACE
+
+// -----------------------------------------------------------------------
+
+#include "CarlaRtLogUtils.cpp"
+
+// -----------------------------------------------------------------------
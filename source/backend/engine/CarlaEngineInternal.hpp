@@ -21,6 +21,7 @@
 #include "CarlaEngineRunner.hpp"
 #include "CarlaEngineUtils.hpp"
 #include "CarlaPlugin.hpp"
+#include "CarlaRtLogUtils.hpp"
 #include "LinkedList.hpp"
 
 #ifndef BUILD_BRIDGE
@@ -111,6 +112,9 @@ public:
     // special direct process with connections already handled, used in JACK and Plugin
     void processRack(CarlaEngine::ProtectedData* data, const float* inBuf[2], float* outBuf[2], uint32_t frames);
 
+    // latency of the offline pipeline, if in use
+    uint32_t getOfflinePipelineLatency() const noexcept;
+
     // used for internal patchbay mode
     void addPlugin(CarlaPluginPtr plugin);
     void replacePlugin(CarlaPluginPtr oldPlugin, CarlaPluginPtr newPlugin);
@@ -227,15 +231,57 @@ struct EngineNextAction {
 struct EnginePluginData {
     CarlaPluginPtr plugin;
     float peaks[4];
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // stereo output copy while rendering to file, null otherwise
+    float* stem[2];
+    // how late the output is compared to the engine one, when the offline pipeline is active
+    uint32_t stemDelay;
+#endif
 
     EnginePluginData()
         : plugin(nullptr),
 #ifdef CARLA_PROPER_CPP11_SUPPORT
-          peaks{0.0f, 0.0f, 0.0f, 0.0f} {}
+          peaks{0.0f, 0.0f, 0.0f, 0.0f}
+# ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        , stem{nullptr, nullptr},
+          stemDelay(0)
+# endif
+          {}
 #else
           peaks()
+# ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        , stem(),
+          stemDelay(0)
+# endif
     {
         carla_zeroStruct(peaks);
+# ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        stem[0] = stem[1] = nullptr;
+# endif
+    }
+#endif
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    void writeStemRT(const float* const* buffers, uint32_t numBuffers, uint32_t frames) noexcept
+    {
+        if (stem[0] == nullptr)
+            return;
+
+        switch (numBuffers)
+        {
+        case 0:
+            carla_zeroFloats(stem[0], frames);
+            carla_zeroFloats(stem[1], frames);
+            break;
+        case 1:
+            carla_copyFloats(stem[0], buffers[0], frames);
+            carla_copyFloats(stem[1], buffers[0], frames);
+            break;
+        default:
+            carla_copyFloats(stem[0], buffers[0], frames);
+            carla_copyFloats(stem[1], buffers[1], frames);
+            break;
+        }
     }
 #endif
 };
@@ -286,7 +332,11 @@ struct CarlaEngine::ProtectedData {
     EnginePluginData* plugins;
     uint32_t xruns;
     float dspLoad;
+    // updated atomically, several process threads may add to them
+    volatile uint32_t minorPageFaults;
+    volatile uint32_t majorPageFaults;
 #endif
+    bool memoryLocked;
     float peaks[4];
 
     CarlaMutex pluginsToDeleteMutex;
@@ -299,6 +349,17 @@ struct CarlaEngine::ProtectedData {
     EngineInternalTime   time;
     EngineNextAction     nextAction;
 
+    // receives log messages and assertions from the audio threads while processing
+    CarlaRtLogger rtLogger;
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // held by the offline renderer, the audio driver must not process while locked elsewhere
+    CarlaRecursiveMutex renderMutex;
+
+    // set by the offline renderer before taking renderMutex, so audio threads skip it without locking
+    volatile bool rendering;
+#endif
+
     // -------------------------------------------------------------------
 
     ProtectedData(CarlaEngine* engine);
@@ -336,12 +397,22 @@ class PendingRtEventsRunner
 public:
     PendingRtEventsRunner(CarlaEngine* engine,
                           uint32_t numFrames,
-                          bool calcDSPLoad = false) noexcept;
+                          bool calcDSPLoad = false,
+                          bool isOfflineRender = false) noexcept;
     ~PendingRtEventsRunner() noexcept;
 
+    // false while an offline render is running on another thread
+    bool canProcess() const noexcept;
+
 private:
     CarlaEngine::ProtectedData* const pData;
+    const CarlaRtLogger::ScopedRedirect rtLogRedirect;
     int64_t prevTime;
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    const bool renderLocked;
+    const bool countPageFaults;
+    long prevMinorFaults, prevMajorFaults;
+#endif
 
     CARLA_PREVENT_HEAP_ALLOCATION
     CARLA_DECLARE_NON_COPYABLE(PendingRtEventsRunner)
@@ -380,6 +451,32 @@ private:
 
 // -----------------------------------------------------------------------
 
+#if ! (defined(CARLA_OS_MAC) && ! defined(__clang__))
+# define CARLA_ENGINE_THREAD_TIME_INFO_AVAILABLE
+#endif
+
+/*
+ * Make CarlaEngine::getTimeInfo() return another time info on the current thread, for the lifetime of a scope.
+ * Used by the offline pipeline, where each plugin processes an older block than the engine.
+ */
+class ScopedThreadTimeInfo
+{
+public:
+    ScopedThreadTimeInfo(const EngineTimeInfo& timeInfo) noexcept;
+    ~ScopedThreadTimeInfo() noexcept;
+
+    // time info set for the current thread, null if none
+    static const EngineTimeInfo* get() noexcept;
+
+private:
+    const EngineTimeInfo* const prevTimeInfo;
+
+    CARLA_PREVENT_HEAP_ALLOCATION
+    CARLA_DECLARE_NON_COPYABLE(ScopedThreadTimeInfo)
+};
+
+// -----------------------------------------------------------------------
+
 CARLA_BACKEND_END_NAMESPACE
 
 #endif // CARLA_ENGINE_INTERNAL_HPP_INCLUDED
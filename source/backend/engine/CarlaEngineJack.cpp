@@ -25,10 +25,13 @@
 #include "CarlaMathUtils.hpp"
 #include "CarlaMIDI.h"
 #include "CarlaPatchbayUtils.hpp"
+#include "CarlaSemUtils.hpp"
 #include "CarlaStringList.hpp"
 
 #include "jackey.h"
 
+#include "water/containers/HashMap.h"
+
 #ifdef USING_JUCE
 # include "carla_juce/carla_juce.h"
 #endif
@@ -1369,6 +1372,8 @@ public:
           fLastPatchbaySetGroupPos(),
           fPostPonedEvents(),
           fPostPonedEventsMutex(),
+          fPostPonedEventsSem(),
+          fPostPonedEventsPending(false),
           fPostPonedUUIDs(),
           fPostPonedUUIDsMutex(),
           fIsInternalClient(false)
@@ -1380,6 +1385,7 @@ public:
         pData->options.processMode = ENGINE_PROCESS_MODE_MULTIPLE_CLIENTS;
 #else
         carla_zeroPointers(fRackPorts, kRackPortCount);
+        carla_sem_create2(fPostPonedEventsSem, false);
 #endif
     }
 
@@ -1393,6 +1399,7 @@ public:
         fUsedPorts.clear();
         fUsedConnections.clear();
         CARLA_SAFE_ASSERT(fPostPonedEvents.count() == 0);
+        carla_sem_destroy2(fPostPonedEventsSem);
 #endif
     }
 
@@ -1694,7 +1701,7 @@ public:
         CarlaEngine::close();
         return true;
 #else
-        stopThread(-1);
+        stopJackEventsThread();
 
         // deactivate client ASAP
         if (fClient != nullptr)
@@ -2235,7 +2242,7 @@ public:
                    Anyway, this means we have to remove all our port-related data before the new client ports are created.
                    (we also stop the separate jack-events thread to avoid any race conditions while modying our port data) */
 
-                stopThread(-1);
+                stopJackEventsThread();
 
                 LinkedList<PortNameToId> ports;
                 LinkedList<ConnectionToId> conns;
@@ -3014,6 +3021,18 @@ protected:
             CARLA_SAFE_ASSERT_RETURN(audioOut1 != nullptr,);
             CARLA_SAFE_ASSERT_RETURN(audioOut2 != nullptr,);
 
+            // rendering to file, stay silent
+            if (! prt.canProcess())
+            {
+                carla_zeroFloats(audioOut1, nframes);
+                carla_zeroFloats(audioOut2, nframes);
+
+                if (eventOut != nullptr)
+                    jackbridge_midi_clear_buffer(eventOut);
+
+                return;
+            }
+
             // create audio buffers
             const float* inBuf[2]  = { audioIn1, audioIn2 };
             /**/  float* outBuf[2] = { audioOut1, audioOut2 };
@@ -3492,7 +3511,7 @@ protected:
     void handleJackShutdownCallback()
     {
 #ifndef BUILD_BRIDGE
-        stopThread(-1);
+        stopJackEventsThread();
 #endif
 
         {
@@ -4176,15 +4195,75 @@ private:
     LinkedList<PostPonedJackEvent> fPostPonedEvents;
     CarlaMutex fPostPonedEventsMutex;
 
+    // wakes up the jack-events thread, posted once per batch (fPostPonedEventsPending set while the post is unconsumed)
+    carla_sem_t fPostPonedEventsSem;
+    bool fPostPonedEventsPending;
+
     water::Array<jack_uuid_t> fPostPonedUUIDs;
     CarlaMutex fPostPonedUUIDsMutex;
 
     bool fIsInternalClient;
 
+    // time to wait for a burst of jack events to settle before handling them, and the maximum delay for a batch
+    static const uint kPostPonedEventsSettleTime = 10;
+    static const uint kPostPonedEventsMaxDelay = 100;
+
+    // pending names in a batch, counted the same way as the old string-list based version
+    typedef water::HashMap<water::String, int> NameCountMap;
+    typedef water::HashMap<water::String, PostPonedJackEvent*> NameEventMap;
+
     void postPoneJackCallback(PostPonedJackEvent& ev)
     {
         const CarlaMutexLocker cml(fPostPonedEventsMutex);
         fPostPonedEvents.append(ev);
+
+        if (! fPostPonedEventsPending)
+        {
+            fPostPonedEventsPending = true;
+            carla_sem_post(fPostPonedEventsSem);
+        }
+    }
+
+    void stopJackEventsThread()
+    {
+        signalThreadShouldExit();
+
+        {
+            const CarlaMutexLocker cml(fPostPonedEventsMutex);
+
+            if (! fPostPonedEventsPending)
+            {
+                fPostPonedEventsPending = true;
+                carla_sem_post(fPostPonedEventsSem);
+            }
+        }
+
+        stopThread(-1);
+    }
+
+    static void increaseNameCount(NameCountMap& map, const char* const name)
+    {
+        const water::String key(name);
+        map.set(key, map[key] + 1);
+    }
+
+    static void decreaseNameCount(NameCountMap& map, const char* const name)
+    {
+        if (map.size() == 0)
+            return;
+
+        const water::String key(name);
+        const int count = map[key];
+
+        if (count > 1)
+            map.set(key, count - 1);
+        else if (count == 1)
+            map.remove(key);
+    }
+
+    static bool containsName(const NameCountMap& map, const char* const name)
+    {
+        return map.size() != 0 && map.contains(water::String(name));
     }
 
     void run() override
@@ -4194,54 +4273,95 @@ private:
         PostPonedJackEvent nullEvent;
         carla_zeroStruct(nullEvent);
 
-        CarlaStringList clientsToIgnore, portsToIgnore;
+        NameCountMap clientsToIgnore, portsToIgnore;
+        NameEventMap pendingPortRegistrations;
 
         for (; ! shouldThreadExit();)
         {
             if (fIsInternalClient)
                 idle();
 
+            // jack callbacks wake us up, internal clients still need regular idle calls
+            if (! carla_sem_timedwait(fPostPonedEventsSem, fIsInternalClient ? 50 : 1000))
+                continue;
+
+            if (fClient == nullptr)
             {
                 const CarlaMutexLocker cml(fPostPonedEventsMutex);
+                fPostPonedEventsPending = false;
+                break;
+            }
+
+            // let bursts of events (like a client coming up with many ports) settle into a single batch
+            for (std::size_t i = 0, count = 0; i < kPostPonedEventsMaxDelay / kPostPonedEventsSettleTime; ++i)
+            {
+                {
+                    const CarlaMutexLocker cml(fPostPonedEventsMutex);
+
+                    if (i != 0 && fPostPonedEvents.count() == count)
+                        break;
+
+                    count = fPostPonedEvents.count();
+                }
+
+                if (shouldThreadExit())
+                    break;
+
+                carla_msleep(kPostPonedEventsSettleTime);
+            }
+
+            {
+                const CarlaMutexLocker cml(fPostPonedEventsMutex);
+
+                fPostPonedEventsPending = false;
 
                 if (fPostPonedEvents.count() > 0)
                     fPostPonedEvents.moveTo(events);
             }
 
-            if (fClient == nullptr)
-                break;
-
             if (events.count() == 0)
-            {
-                carla_msleep(fIsInternalClient ? 50 : 200);
                 continue;
-            }
 
             // 1st iteration, fill in what things we ought to ignore and do unregistration
             clientsToIgnore.clear();
             portsToIgnore.clear();
+            pendingPortRegistrations.clear();
 
             for (LinkedList<PostPonedJackEvent>::Itenerator it = events.begin2(); it.valid(); it.next())
             {
-                const PostPonedJackEvent& ev(it.getValue(nullEvent));
+                PostPonedJackEvent& ev(it.getValue(nullEvent));
                 CARLA_SAFE_ASSERT_CONTINUE(ev.type != PostPonedJackEvent::kTypeNull);
 
                 switch (ev.type)
                 {
                 case PostPonedJackEvent::kTypeClientRegister:
-                    clientsToIgnore.removeOne(ev.clientRegister.name);
+                    decreaseNameCount(clientsToIgnore, ev.clientRegister.name);
                     break;
                 case PostPonedJackEvent::kTypeClientUnregister:
-                    clientsToIgnore.append(ev.clientUnregister.name);
+                    increaseNameCount(clientsToIgnore, ev.clientUnregister.name);
                     handleJackClientUnregistrationCallback(ev.clientUnregister.name);
                     break;
                 case PostPonedJackEvent::kTypePortRegister:
-                    portsToIgnore.removeOne(ev.portRegister.fullName);
+                    decreaseNameCount(portsToIgnore, ev.portRegister.fullName);
+                    pendingPortRegistrations.set(water::String(ev.portRegister.fullName), &ev);
                     break;
                 case PostPonedJackEvent::kTypePortUnregister:
-                    portsToIgnore.append(ev.portUnregister.fullName);
+                {
+                    increaseNameCount(portsToIgnore, ev.portUnregister.fullName);
+
+                    // a port registered and unregistered within the same batch is never reported
+                    const water::String key(ev.portUnregister.fullName);
+
+                    if (PostPonedJackEvent* const regEvent = pendingPortRegistrations[key])
+                    {
+                        regEvent->type = PostPonedJackEvent::kTypeNull;
+                        pendingPortRegistrations.remove(key);
+                        break;
+                    }
+
                     handleJackPortUnregistrationCallback(ev.portUnregister.fullName);
                     break;
+                }
                 case PostPonedJackEvent::kTypePortDisconnect:
                     handleJackPortDisconnectCallback(ev.portDisconnect.portNameA,
                                                      ev.portDisconnect.portNameB);
@@ -4255,7 +4375,6 @@ private:
             for (LinkedList<PostPonedJackEvent>::Itenerator it = events.begin2(); it.valid(); it.next())
             {
                 const PostPonedJackEvent& ev(it.getValue(nullEvent));
-                CARLA_SAFE_ASSERT_CONTINUE(ev.type != PostPonedJackEvent::kTypeNull);
 
                 switch (ev.type)
                 {
@@ -4272,14 +4391,14 @@ private:
                     carla_zeroStruct(uuidstr);
                     jackbridge_uuid_unparse(ev.clientPositionChange.uuid, uuidstr);
 
-                    if (clientsToIgnore.count() != 0)
+                    if (clientsToIgnore.size() != 0)
                     {
                         const CarlaRecursiveMutexLocker crml(fThreadSafeMetadataMutex);
 
                         const char* const clientname = jackbridge_get_client_name_by_uuid(fClient, uuidstr);
                         CARLA_SAFE_ASSERT_CONTINUE(clientname != nullptr && clientname[0] != '\0');
 
-                        if (clientsToIgnore.contains(clientname))
+                        if (containsName(clientsToIgnore, clientname))
                             continue;
                     }
 
@@ -4288,7 +4407,7 @@ private:
                 }
 
                 case PostPonedJackEvent::kTypePortRegister:
-                    if (portsToIgnore.contains(ev.portRegister.fullName))
+                    if (containsName(portsToIgnore, ev.portRegister.fullName))
                         continue;
                     handleJackPortRegistrationCallback(ev.portRegister.fullName,
                                                        ev.portRegister.shortName,
@@ -4296,9 +4415,9 @@ private:
                     break;
 
                 case PostPonedJackEvent::kTypePortConnect:
-                    if (portsToIgnore.contains(ev.portConnect.portNameA))
+                    if (containsName(portsToIgnore, ev.portConnect.portNameA))
                         continue;
-                    if (portsToIgnore.contains(ev.portConnect.portNameB))
+                    if (containsName(portsToIgnore, ev.portConnect.portNameB))
                         continue;
                     handleJackPortConnectCallback(ev.portConnect.portNameA,
                                                   ev.portConnect.portNameB);
@@ -4318,6 +4437,7 @@ private:
         events.clear();
         clientsToIgnore.clear();
         portsToIgnore.clear();
+        pendingPortRegistrations.clear();
     }
 #endif //  BUILD_BRIDGE
 
@@ -4519,6 +4639,8 @@ private:
         CarlaEngineJack* const engine((CarlaEngineJack*)plugin->getEngine());
         CARLA_SAFE_ASSERT_RETURN(engine != nullptr, 0);
 
+        const CarlaRtLogger::ScopedRedirect rtLogRedirect(engine->pData->rtLogger);
+
         if (plugin->tryLock(engine->fFreewheel))
         {
             plugin->initBuffers();
@@ -618,6 +618,10 @@ protected:
         for (int i=0; i < numOutputChannels; ++i)
             carla_zeroFloats(outputChannelData[i], nframes);
 
+        // rendering to file, stay silent
+        if (! prt.canProcess())
+            return;
+
         // initialize events
         carla_zeroStructs(pData->events.in,  kMaxEngineEventInternalCount);
         carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
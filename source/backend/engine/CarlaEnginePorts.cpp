@@ -16,6 +16,7 @@
  */
 
 #include "CarlaEnginePorts.hpp"
+#include "CarlaEngineClient.hpp"
 #include "CarlaEngineUtils.hpp"
 #include "CarlaMathUtils.hpp"
 #include "CarlaMIDI.h"
@@ -148,7 +149,12 @@ CarlaEngineEventPort::~CarlaEngineEventPort() noexcept
 void CarlaEngineEventPort::initBuffer() noexcept
 {
     if (kProcessMode == ENGINE_PROCESS_MODE_CONTINUOUS_RACK || kProcessMode == ENGINE_PROCESS_MODE_BRIDGE)
-        fBuffer = kClient.getEngine().getInternalEventBuffer(kIsInput);
+    {
+        if (EngineEvent* const rackBuffer = kIsInput ? kClient.pData->rackEventsIn : kClient.pData->rackEventsOut)
+            fBuffer = rackBuffer;
+        else
+            fBuffer = kClient.getEngine().getInternalEventBuffer(kIsInput);
+    }
     else if (kProcessMode == ENGINE_PROCESS_MODE_PATCHBAY && ! kIsInput)
         carla_zeroStructs(fBuffer, kMaxEngineEventInternalCount);
 }
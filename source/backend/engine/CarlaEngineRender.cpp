@@ -0,0 +1,648 @@
+/*
+ * Carla Plugin Host
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the GPL.txt file
+ */
+
+#include "CarlaEngineGraph.hpp"
+#include "CarlaEngineInternal.hpp"
+#include "CarlaSemUtils.hpp"
+#include "CarlaThread.hpp"
+
+#include "water/files/File.h"
+#include "water/files/FileOutputStream.h"
+#include "water/memory/ByteOrder.h"
+
+using water::ByteOrder;
+using water::File;
+using water::FileOutputStream;
+using water::String;
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// Stereo 32-bit float WAV file, sizes are written on close
+
+class RenderFileWriter
+{
+public:
+    RenderFileWriter(const File& file, const uint32_t sampleRate, const uint64_t numFrames, const uint32_t bufferSize)
+        : fFile(file),
+          fStream(nullptr),
+          fSampleRate(sampleRate),
+          fFramesToSkip(0),
+          fFramesLeft(numFrames),
+          fFramesWritten(0),
+          fInterleaved(new float[bufferSize * 2]),
+          fFailed(false) {}
+
+    ~RenderFileWriter()
+    {
+        close();
+        delete[] fInterleaved;
+    }
+
+    const File& getFile() const noexcept
+    {
+        return fFile;
+    }
+
+    bool open()
+    {
+        CARLA_SAFE_ASSERT_RETURN(fStream == nullptr, false);
+
+        if (fFile.existsAsFile() && ! fFile.deleteFile())
+            return false;
+
+        fStream = new FileOutputStream(fFile);
+
+        if (fStream->failedToOpen())
+        {
+            delete fStream;
+            fStream = nullptr;
+            return false;
+        }
+
+        writeHeader();
+        return ! fFailed;
+    }
+
+    void close()
+    {
+        if (fStream == nullptr)
+            return;
+
+        // go back and fill in the sizes now that we know them
+        const uint32_t dataSize = getDataSize();
+
+        fFailed |= ! fStream->setPosition(4);
+        fFailed |= ! fStream->writeInt(static_cast<int>(dataSize + kHeaderSize - 8));
+        fFailed |= ! fStream->setPosition(46);
+        fFailed |= ! fStream->writeInt(static_cast<int>(dataSize / kFrameSize));
+        fFailed |= ! fStream->setPosition(54);
+        fFailed |= ! fStream->writeInt(static_cast<int>(dataSize));
+        fStream->flush();
+
+        delete fStream;
+        fStream = nullptr;
+    }
+
+    bool hasFailed() const noexcept
+    {
+        return fFailed;
+    }
+
+    void setFramesToSkip(const uint32_t frames) noexcept
+    {
+        fFramesToSkip = frames;
+    }
+
+    void write(const float* bufL, const float* bufR, uint32_t frames)
+    {
+        if (fStream == nullptr || fFramesLeft == 0)
+            return;
+
+        if (fFramesToSkip >= frames)
+        {
+            fFramesToSkip -= frames;
+            return;
+        }
+
+        bufL   += fFramesToSkip;
+        bufR   += fFramesToSkip;
+        frames -= fFramesToSkip;
+        fFramesToSkip = 0;
+
+        if (frames > fFramesLeft)
+            frames = static_cast<uint32_t>(fFramesLeft);
+
+        if (frames == 0)
+            return;
+
+        const float* const bufs[2] = { bufL, bufR };
+        carla_interleaveFloats(fInterleaved, bufs, 2, frames);
+
+        if (ByteOrder::isBigEndian())
+        {
+            for (uint32_t i=0; i < frames*2; ++i)
+                fInterleaved[i] = ByteOrder::swapIfBigEndian(fInterleaved[i]);
+        }
+
+        fFailed |= ! fStream->write(fInterleaved, frames * kFrameSize);
+
+        fFramesLeft    -= frames;
+        fFramesWritten += frames;
+    }
+
+private:
+    static const uint32_t kFrameSize  = sizeof(float) * 2;
+    static const uint32_t kHeaderSize = 58;
+
+    const File fFile;
+    FileOutputStream* fStream;
+
+    const uint32_t fSampleRate;
+    uint32_t fFramesToSkip;
+    uint64_t fFramesLeft;
+    uint64_t fFramesWritten;
+
+    float* const fInterleaved;
+    bool fFailed;
+
+    // RIFF sizes are 32-bit, anything past that is written but not accounted for
+    uint32_t getDataSize() const noexcept
+    {
+        const uint64_t maxFrames = (UINT32_MAX - kHeaderSize) / kFrameSize;
+
+        return static_cast<uint32_t>(std::min(fFramesWritten, maxFrames) * kFrameSize);
+    }
+
+    void writeHeader()
+    {
+        fFailed |= ! fStream->write("RIFF", 4);
+        fFailed |= ! fStream->writeInt(0);
+        fFailed |= ! fStream->write("WAVE", 4);
+
+        fFailed |= ! fStream->write("fmt ", 4);
+        fFailed |= ! fStream->writeInt(18);
+        fFailed |= ! fStream->writeShort(3); // WAVE_FORMAT_IEEE_FLOAT
+        fFailed |= ! fStream->writeShort(2);
+        fFailed |= ! fStream->writeInt(static_cast<int>(fSampleRate));
+        fFailed |= ! fStream->writeInt(static_cast<int>(fSampleRate * kFrameSize));
+        fFailed |= ! fStream->writeShort(static_cast<short>(kFrameSize));
+        fFailed |= ! fStream->writeShort(32);
+        fFailed |= ! fStream->writeShort(0);
+
+        fFailed |= ! fStream->write("fact", 4);
+        fFailed |= ! fStream->writeInt(4);
+        fFailed |= ! fStream->writeInt(0);
+
+        fFailed |= ! fStream->write("data", 4);
+        fFailed |= ! fStream->writeInt(0);
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(RenderFileWriter)
+};
+
+// -----------------------------------------------------------------------
+// Writes rendered blocks to disk on its own thread, so file I/O never stalls the render
+
+class RenderEncoder : private CarlaThread
+{
+public:
+    RenderEncoder(const uint numWriters, const uint32_t bufferSize)
+        : CarlaThread("RenderEncoder"),
+          kNumWriters(numWriters),
+          kBufferSize(bufferSize),
+          kBlockSize(numWriters * bufferSize * 2),
+          fWriters(new RenderFileWriter*[numWriters]),
+          fBlocks(new float[kNumBlocks * kBlockSize]),
+          fReadIndex(0),
+          fWriteIndex(0),
+          fUsedBlocks(0),
+          fFinishing(false),
+          fWaitingForData(false),
+          fWaitingForSpace(false)
+    {
+        carla_zeroPointers(fWriters, numWriters);
+        carla_sem_create2(fDataSem, false);
+        carla_sem_create2(fSpaceSem, false);
+    }
+
+    ~RenderEncoder() override
+    {
+        stopThread(-1);
+
+        for (uint i=0; i < kNumWriters; ++i)
+            delete fWriters[i];
+
+        carla_sem_destroy2(fDataSem);
+        carla_sem_destroy2(fSpaceSem);
+
+        delete[] fWriters;
+        delete[] fBlocks;
+    }
+
+    bool addWriter(const uint index, RenderFileWriter* const writer)
+    {
+        CARLA_SAFE_ASSERT_RETURN(index < kNumWriters, false);
+        CARLA_SAFE_ASSERT_RETURN(fWriters[index] == nullptr, false);
+
+        fWriters[index] = writer;
+        return writer->open();
+    }
+
+    const File& getWriterFile(const uint index) const noexcept
+    {
+        return fWriters[index]->getFile();
+    }
+
+    void setFramesToSkip(const uint index, const uint32_t frames) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(index < kNumWriters,);
+        fWriters[index]->setFramesToSkip(frames);
+    }
+
+    void start()
+    {
+        startThread();
+    }
+
+    // next free block, laid out as left and right channels for each writer
+    float* getFreeBlock()
+    {
+        for (;;)
+        {
+            {
+                const CarlaMutexLocker cml(fMutex);
+
+                if (fUsedBlocks < kNumBlocks)
+                    return fBlocks + fWriteIndex * kBlockSize;
+
+                fWaitingForSpace = true;
+            }
+
+            carla_sem_timedwait(fSpaceSem, 100);
+        }
+    }
+
+    void commitBlock()
+    {
+        const CarlaMutexLocker cml(fMutex);
+
+        fWriteIndex = (fWriteIndex + 1) % kNumBlocks;
+        ++fUsedBlocks;
+
+        wakeUp(fDataSem, fWaitingForData);
+    }
+
+    // write all pending blocks and close the files, returns false on I/O errors
+    bool finish()
+    {
+        {
+            const CarlaMutexLocker cml(fMutex);
+
+            fFinishing = true;
+            wakeUp(fDataSem, fWaitingForData);
+        }
+
+        while (isThreadRunning())
+            carla_msleep(5);
+
+        bool ok = true;
+
+        for (uint i=0; i < kNumWriters; ++i)
+        {
+            fWriters[i]->close();
+            ok &= ! fWriters[i]->hasFailed();
+        }
+
+        return ok;
+    }
+
+    void deleteFiles()
+    {
+        for (uint i=0; i < kNumWriters; ++i)
+        {
+            if (fWriters[i] == nullptr)
+                continue;
+
+            fWriters[i]->close();
+            fWriters[i]->getFile().deleteFile();
+        }
+    }
+
+protected:
+    void run() override
+    {
+        for (;;)
+        {
+            const float* block = nullptr;
+
+            {
+                const CarlaMutexLocker cml(fMutex);
+
+                if (fUsedBlocks != 0)
+                    block = fBlocks + fReadIndex * kBlockSize;
+                else if (fFinishing)
+                    break;
+                else
+                    fWaitingForData = true;
+            }
+
+            if (block == nullptr)
+            {
+                carla_sem_timedwait(fDataSem, 100);
+                continue;
+            }
+
+            for (uint i=0; i < kNumWriters; ++i)
+            {
+                const float* const bufL = block + i * kBufferSize * 2;
+                fWriters[i]->write(bufL, bufL + kBufferSize, kBufferSize);
+            }
+
+            const CarlaMutexLocker cml(fMutex);
+
+            fReadIndex = (fReadIndex + 1) % kNumBlocks;
+            --fUsedBlocks;
+
+            wakeUp(fSpaceSem, fWaitingForSpace);
+        }
+    }
+
+private:
+    static const uint kNumBlocks = 32;
+
+    const uint kNumWriters;
+    const uint32_t kBufferSize;
+    const uint32_t kBlockSize;
+
+    RenderFileWriter** const fWriters;
+    float* const fBlocks;
+
+    CarlaMutex fMutex;
+    uint fReadIndex;
+    uint fWriteIndex;
+    uint fUsedBlocks;
+    bool fFinishing;
+    bool fWaitingForData;
+    bool fWaitingForSpace;
+
+    carla_sem_t fDataSem;
+    carla_sem_t fSpaceSem;
+
+    // semaphores are binary, only post when the other side is actually waiting
+    static void wakeUp(carla_sem_t& sem, bool& waiting) noexcept
+    {
+        if (! waiting)
+            return;
+
+        waiting = false;
+        carla_sem_post(sem);
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(RenderEncoder)
+};
+
+// -----------------------------------------------------------------------
+
+static File getStemFile(const File& mainFile, const CarlaPluginPtr& plugin, const bool withId)
+{
+    const String baseName(mainFile.getFileNameWithoutExtension());
+    const String pluginName(File::createLegalFileName(plugin->getName()));
+
+    if (withId)
+        return mainFile.getSiblingFile(baseName + "-" + String(plugin->getId() + 1) + "-" + pluginName + ".wav");
+
+    return mainFile.getSiblingFile(baseName + "-" + pluginName + ".wav");
+}
+
+bool CarlaEngine::renderToFile(const char* const filename, const uint64_t startFrame, const uint64_t endFrame,
+                               const uint* const stemPluginIds, const uint stemCount)
+{
+    CARLA_SAFE_ASSERT_RETURN_ERR(filename != nullptr && filename[0] != '\0', "Invalid filename");
+    CARLA_SAFE_ASSERT_RETURN_ERR(stemPluginIds != nullptr || stemCount == 0, "Invalid stem list");
+    CARLA_SAFE_ASSERT_RETURN_ERR(endFrame > startFrame, "Invalid render range");
+    carla_debug("CarlaEngine::renderToFile(\"%s\", " P_UINT64 ", " P_UINT64 ", %p, %u)",
+                filename, startFrame, endFrame, stemPluginIds, stemCount);
+
+    if (! isRunning())
+    {
+        setLastError("Engine is not running");
+        return false;
+    }
+
+    if (getType() == kEngineTypePlugin)
+    {
+        setLastError("Rendering to file is not available in the plugin version");
+        return false;
+    }
+
+    if (pData->options.processMode != ENGINE_PROCESS_MODE_CONTINUOUS_RACK &&
+        pData->options.processMode != ENGINE_PROCESS_MODE_PATCHBAY)
+    {
+        setLastError("Rendering to file is only available in rack and patchbay modes");
+        return false;
+    }
+
+    if (pData->options.transportMode != ENGINE_TRANSPORT_MODE_INTERNAL)
+    {
+        setLastError("Rendering to file requires internal transport");
+        return false;
+    }
+
+    if (! File::isAbsolutePath(filename))
+    {
+        setLastError("Render filename must be an absolute path");
+        return false;
+    }
+
+    const uint32_t bufferSize = pData->bufferSize;
+    const uint64_t numFrames  = endFrame - startFrame;
+    const uint numWriters     = stemCount + 1;
+
+    // keep references to the plugins, so removals during the render are harmless
+    std::vector<CarlaPluginPtr> stemPlugins;
+
+    for (uint i=0; i < stemCount; ++i)
+    {
+        const CarlaPluginPtr plugin = getPlugin(stemPluginIds[i]);
+
+        if (plugin.get() == nullptr)
+        {
+            setLastError("Invalid plugin id in stem list");
+            return false;
+        }
+
+        stemPlugins.push_back(plugin);
+    }
+
+    RenderEncoder encoder(numWriters, bufferSize);
+
+    {
+        const File mainFile(filename);
+        const uint32_t sampleRate = static_cast<uint32_t>(pData->sampleRate + 0.5);
+
+        for (uint i=0; i < numWriters; ++i)
+        {
+            File file(i == 0 ? mainFile : getStemFile(mainFile, stemPlugins[i-1], false));
+
+            // plugins can share the same name, use the id to tell them apart
+            for (uint j=0; j < i; ++j)
+            {
+                if (encoder.getWriterFile(j) == file)
+                {
+                    file = getStemFile(mainFile, stemPlugins[i-1], true);
+                    break;
+                }
+            }
+
+            if (! encoder.addWriter(i, new RenderFileWriter(file, sampleRate, numFrames, bufferSize)))
+            {
+                encoder.deleteFiles();
+                setLastError("Failed to create render output file");
+                return false;
+            }
+        }
+    }
+
+    // silent input and scratch output for every engine port
+    uint32_t numIns = 2, numOuts = 2;
+
+    if (const PatchbayGraph* const patchbay = pData->graph.getPatchbayGraphOrNull())
+    {
+        numIns  = std::max(numIns,  patchbay->numAudioIns  + patchbay->numCVIns);
+        numOuts = std::max(numOuts, patchbay->numAudioOuts + patchbay->numCVOuts);
+    }
+
+    float* const silentBuf  = new float[bufferSize];
+    float* const unusedBuf  = new float[bufferSize];
+    carla_zeroFloats(silentBuf, bufferSize);
+
+    const float* inBuf[numIns];
+    float* outBuf[numOuts];
+
+    for (uint32_t i=0; i < numIns; ++i)
+        inBuf[i] = silentBuf;
+    for (uint32_t i=2; i < numOuts; ++i)
+        outBuf[i] = unusedBuf;
+
+    encoder.start();
+
+    int lastProgress = 0;
+
+    pData->actionCanceled = false;
+    callback(true, true, ENGINE_CALLBACK_CANCELABLE_ACTION, 0, 1, 0, 0, 0.0f, "Rendering to file");
+
+    // from now on the audio driver is silent, and we drive the graph ourselves
+    pData->rendering = true;
+
+    {
+        const CarlaRecursiveMutexLocker crml(pData->renderMutex);
+
+        const bool     wasPlaying = pData->timeInfo.playing;
+        const uint64_t oldFrame   = pData->timeInfo.frame;
+
+        offlineModeChanged(true);
+        transportRelocate(startFrame);
+        transportPlay();
+
+        // the offline pipeline delays the output, we know by how much after the first cycle
+        uint64_t framesToRender = numFrames;
+        lastProgress = -1;
+
+        for (uint64_t framesDone = 0; framesDone < framesToRender && ! pData->actionCanceled; framesDone += bufferSize)
+        {
+            float* const block = encoder.getFreeBlock();
+
+            outBuf[0] = block;
+            outBuf[1] = block + bufferSize;
+
+            for (uint i=0; i < stemCount; ++i)
+            {
+                const CarlaPluginPtr& plugin(stemPlugins[i]);
+                const uint id = plugin->getId();
+                float* const stemL = block + (i + 1) * bufferSize * 2;
+
+                carla_zeroFloats(stemL, bufferSize * 2);
+
+                if (id < pData->curPluginCount && pData->plugins[id].plugin == plugin)
+                {
+                    pData->plugins[id].stem[0] = stemL;
+                    pData->plugins[id].stem[1] = stemL + bufferSize;
+                }
+            }
+
+            {
+                const PendingRtEventsRunner prt(this, bufferSize, false, true);
+
+                carla_zeroFloats(outBuf[0], bufferSize);
+                carla_zeroFloats(outBuf[1], bufferSize);
+                carla_zeroStructs(pData->events.in,  kMaxEngineEventInternalCount);
+                carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
+
+                // the rack output is rendered as-is, the patchbay through its external ports
+                if (pData->options.processMode == ENGINE_PROCESS_MODE_CONTINUOUS_RACK)
+                    pData->graph.processRack(pData, inBuf, outBuf, bufferSize);
+                else
+                    pData->graph.process(pData, inBuf, outBuf, bufferSize);
+            }
+
+            for (uint i=0; i < stemCount; ++i)
+            {
+                const CarlaPluginPtr& plugin(stemPlugins[i]);
+                const uint id = plugin->getId();
+
+                if (id < pData->curPluginCount && pData->plugins[id].plugin == plugin)
+                {
+                    if (framesDone == 0)
+                        encoder.setFramesToSkip(i + 1, pData->plugins[id].stemDelay);
+
+                    pData->plugins[id].stem[0] = pData->plugins[id].stem[1] = nullptr;
+                }
+            }
+
+            if (framesDone == 0)
+            {
+                const uint32_t latency = pData->graph.getOfflinePipelineLatency();
+
+                encoder.setFramesToSkip(0, latency);
+                framesToRender += latency;
+            }
+
+            encoder.commitBlock();
+
+            const int progress = static_cast<int>(framesDone * 100 / framesToRender);
+
+            if (progress != lastProgress)
+            {
+                lastProgress = progress;
+                callback(true, true, ENGINE_CALLBACK_RENDER_PROGRESS, 0, progress, 0, 0, 0.0f, filename);
+                callback(true, false, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
+            }
+        }
+
+        if (! wasPlaying)
+            transportPause();
+
+        transportRelocate(oldFrame);
+        offlineModeChanged(isOffline());
+    }
+
+    pData->rendering = false;
+
+    delete[] silentBuf;
+    delete[] unusedBuf;
+
+    const bool canceled = pData->actionCanceled;
+    const bool written  = encoder.finish();
+
+    callback(true, true, ENGINE_CALLBACK_CANCELABLE_ACTION, 0, 0, 0, 0, 0.0f, "Rendering to file");
+
+    if (canceled || ! written)
+    {
+        encoder.deleteFiles();
+        callback(true, true, ENGINE_CALLBACK_RENDER_PROGRESS, 0, std::max(0, lastProgress), 1, 0, 0.0f, filename);
+        setLastError(canceled ? "Render canceled" : "Failed to write render output file");
+        return false;
+    }
+
+    callback(true, true, ENGINE_CALLBACK_RENDER_PROGRESS, 0, 100, 1, 0, 0.0f, filename);
+    return true;
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
@@ -640,13 +640,19 @@ protected:
         // assert rtaudio buffers
         CARLA_SAFE_ASSERT_RETURN(outputBuffer != nullptr,);
 
+        // rendering to file, stay silent
+        if (! prt.canProcess())
+        {
+            carla_zeroFloats(outsPtr, nframes*fAudioOutCount);
+            return;
+        }
+
         // set rtaudio buffers as non-interleaved
         const float* inBuf[fAudioInCount];
         /* */ float* outBuf[fAudioOutCount];
 
         if (fAudioInterleaved)
         {
-            // FIXME - this looks completely wrong!
             float* inBuf2[fAudioInCount];
 
             for (uint i=0, count=fAudioInCount; i<count; ++i)
@@ -658,9 +664,8 @@ protected:
                 outBuf[i] = fAudioIntBufOut + (nframes*i);
 
             // init input
-            for (uint i=0; i<nframes; ++i)
-                for (uint j=0; j<fAudioInCount; ++j)
-                    inBuf2[j][i] = insPtr[i*fAudioInCount+j];
+            if (fAudioInCount > 0)
+                carla_deinterleaveFloats(inBuf2, insPtr, fAudioInCount, nframes);
 
             // clear output
             carla_zeroFloats(fAudioIntBufOut, fAudioOutCount*nframes);
@@ -790,12 +795,8 @@ protected:
 
         fMidiOutMutex.unlock();
 
-        if (fAudioInterleaved)
-        {
-            for (uint i=0; i < nframes; ++i)
-                for (uint j=0; j<fAudioOutCount; ++j)
-                    outsPtr[i*fAudioOutCount+j] = outBuf[j][i];
-        }
+        if (fAudioInterleaved && fAudioOutCount > 0)
+            carla_interleaveFloats(outsPtr, outBuf, fAudioOutCount, nframes);
 
         return; // unused
         (void)streamTime;
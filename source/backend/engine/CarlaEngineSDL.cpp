@@ -20,6 +20,8 @@
 #include "CarlaEngineInternal.hpp"
 #include "CarlaStringList.hpp"
 #include "CarlaBackendUtils.hpp"
+#include "CarlaMathUtils.hpp"
+#include "CarlaRingBuffer.hpp"
 
 #include <SDL.h>
 
@@ -41,6 +43,7 @@ CARLA_BACKEND_START_NAMESPACE
 // Global static data
 
 static CarlaStringList gDeviceNames;
+static CarlaStringList gCaptureDeviceNames;
 
 // -------------------------------------------------------------------------------------------------------------------
 
@@ -60,6 +63,11 @@ static void initAudioDevicesIfNeeded()
 
     for (int i=0; i<numDevices; ++i)
         gDeviceNames.append(SDL_GetAudioDeviceName(i, 0));
+
+    const int numCaptureDevices = SDL_GetNumAudioDevices(1);
+
+    for (int i=0; i<numCaptureDevices; ++i)
+        gCaptureDeviceNames.append(SDL_GetAudioDeviceName(i, 1));
 #else
     SDL_Init(SDL_INIT_AUDIO);
 #endif
@@ -71,12 +79,21 @@ static void initAudioDevicesIfNeeded()
 class CarlaEngineSDL : public CarlaEngine
 {
 public:
+    // amount of captured audio buffered between the capture and playback devices, in buffer-size periods
+    static const uint kCaptureRingPeriods = 8;
+    static const uint kCaptureMaxLatencyPeriods = 3;
+
     CarlaEngineSDL()
         : CarlaEngine(),
           fDeviceId(0),
+          fCaptureDeviceId(0),
           fDeviceName(),
+          fAudioInCount(0),
           fAudioOutCount(0),
-          fAudioIntBufOut(nullptr)
+          fAudioIntBufIn(nullptr),
+          fAudioIntBufOut(nullptr),
+          fAudioInterleavedBuf(nullptr),
+          fCaptureRing()
     {
         carla_debug("CarlaEngineSDL::CarlaEngineSDL()");
 
@@ -86,6 +103,7 @@ public:
 
     ~CarlaEngineSDL() override
     {
+        CARLA_SAFE_ASSERT(fAudioInCount == 0);
         CARLA_SAFE_ASSERT(fAudioOutCount == 0);
         carla_debug("CarlaEngineSDL::~CarlaEngineSDL()");
     }
@@ -154,6 +172,41 @@ public:
             return false;
         }
 
+#ifdef HAVE_SDL2
+        // capture is optional, matching the output device by name when possible
+        SDL_AudioSpec captureRequested, captureReceived;
+        carla_zeroStruct(captureRequested);
+        captureRequested.format = AUDIO_F32SYS;
+        captureRequested.channels = 2;
+        captureRequested.freq = received.freq;
+        captureRequested.samples = received.samples;
+        captureRequested.callback = carla_sdl_capture_callback;
+        captureRequested.userdata = this;
+
+        const char* const captureDeviceName = deviceName != nullptr && gCaptureDeviceNames.contains(deviceName)
+                                            ? deviceName
+                                            : nullptr;
+
+        fCaptureDeviceId = SDL_OpenAudioDevice(captureDeviceName, 1, &captureRequested, &captureReceived,
+                                               pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY
+                                               ? SDL_AUDIO_ALLOW_CHANNELS_CHANGE : 0);
+
+        if (fCaptureDeviceId == 0)
+        {
+            carla_stderr("CarlaEngineSDL: failed to open capture device, continuing without audio inputs: %s",
+                         SDL_GetError());
+        }
+        else if (captureReceived.channels == 0)
+        {
+            SDL_CloseAudioDevice(fCaptureDeviceId);
+            fCaptureDeviceId = 0;
+        }
+        else
+        {
+            fAudioInCount = captureReceived.channels;
+        }
+#endif
+
         if (! pData->init(clientName))
         {
             close();
@@ -170,15 +223,29 @@ public:
         for (uint i=0; i<fAudioOutCount; ++i)
             fAudioIntBufOut[i] = new float[received.samples];
 
-        pData->graph.create(0, fAudioOutCount, 0, 0);
+        if (fAudioInCount > 0)
+        {
+            fAudioIntBufIn = new float*[fAudioInCount];
+            for (uint i=0; i<fAudioInCount; ++i)
+                fAudioIntBufIn[i] = new float[received.samples];
+
+            fCaptureRing.createBuffer(static_cast<uint32_t>(kCaptureRingPeriods * fAudioInCount * received.samples * sizeof(float)));
+        }
+
+        fAudioInterleavedBuf = new float[std::max(fAudioInCount, fAudioOutCount) * received.samples];
+
+        pData->graph.create(fAudioInCount, fAudioOutCount, 0, 0);
 
 #ifdef HAVE_SDL2
         SDL_PauseAudioDevice(fDeviceId, 0);
+
+        if (fCaptureDeviceId != 0)
+            SDL_PauseAudioDevice(fCaptureDeviceId, 0);
 #else
         SDL_PauseAudio(0);
 #endif
-        carla_stdout("open fAudioOutCount %d %d %d | %d vs %d",
-                     fAudioOutCount, received.samples, received.freq,
+        carla_stdout("open fAudioInCount %d fAudioOutCount %d %d %d | %d vs %d",
+                     fAudioInCount, fAudioOutCount, received.samples, received.freq,
                      received.format, requested.format);
 
         patchbayRefresh(true, false, false);
@@ -201,6 +268,15 @@ public:
     {
         carla_debug("CarlaEngineSDL::close()");
 
+#ifdef HAVE_SDL2
+        // close capture first, it feeds the playback device
+        if (fCaptureDeviceId != 0)
+        {
+            SDL_CloseAudioDevice(fCaptureDeviceId);
+            fCaptureDeviceId = 0;
+        }
+#endif
+
         // close device
         if (fDeviceId != 0)
         {
@@ -219,6 +295,16 @@ public:
         pData->graph.destroy();
 
         // cleanup
+        if (fAudioIntBufIn != nullptr)
+        {
+            for (uint i=0; i<fAudioInCount; ++i)
+                delete[] fAudioIntBufIn[i];
+            delete[] fAudioIntBufIn;
+            fAudioIntBufIn = nullptr;
+
+            fCaptureRing.deleteBuffer();
+        }
+
         if (fAudioIntBufOut != nullptr)
         {
             for (uint i=0; i<fAudioOutCount; ++i)
@@ -227,6 +313,13 @@ public:
             fAudioIntBufOut = nullptr;
         }
 
+        if (fAudioInterleavedBuf != nullptr)
+        {
+            delete[] fAudioInterleavedBuf;
+            fAudioInterleavedBuf = nullptr;
+        }
+
+        fAudioInCount = 0;
         fAudioOutCount = 0;
         fDeviceName.clear();
 
@@ -279,6 +372,17 @@ public:
         // ---------------------------------------------------------------
         // fill in new ones
 
+        // Audio In
+        for (uint i=0; i < fAudioInCount; ++i)
+        {
+            std::snprintf(strBuf, STR_MAX, "capture_%i", i+1);
+
+            PortNameToId portNameToId;
+            portNameToId.setData(kExternalGraphGroupAudioIn, i+1, strBuf, "");
+
+            extGraph.audioPorts.ins.append(portNameToId);
+        }
+
         // Audio Out
         for (uint i=0; i < fAudioOutCount; ++i)
         {
@@ -336,32 +440,75 @@ protected:
         const uint ulen = static_cast<uint>(static_cast<uint>(len) / sizeof(int16_t) / fAudioOutCount);
 #endif
 
+        // SDL plays whatever is left in the stream, make sure it is silence
+        if (ulen > pData->bufferSize)
+        {
+            carla_zeroBytes(stream, static_cast<std::size_t>(len));
+            carla_safe_assert_uint2("ulen <= pData->bufferSize", __FILE__, __LINE__, ulen, pData->bufferSize);
+            return;
+        }
+
         const PendingRtEventsRunner prt(this, ulen, true);
 
         // init our deinterleaved audio buffers
         for (uint i=0, count=fAudioOutCount; i<count; ++i)
             carla_zeroFloats(fAudioIntBufOut[i], ulen);
 
-        // initialize events
-        carla_zeroStructs(pData->events.in,  kMaxEngineEventInternalCount);
-        carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
+        if (fAudioInCount > 0)
+            readCapturedAudio(ulen);
 
-        pData->graph.process(pData, nullptr, fAudioIntBufOut, ulen);
+        if (prt.canProcess())
+        {
+            // initialize events
+            carla_zeroStructs(pData->events.in,  kMaxEngineEventInternalCount);
+            carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
+
+            pData->graph.process(pData, fAudioIntBufIn, fAudioIntBufOut, ulen);
+        }
 
         // interleave audio back
-        for (uint i=0; i < fAudioOutCount; ++i)
-        {
-            for (uint j=0; j < ulen; ++j)
-            {
 #ifdef HAVE_SDL2
-                // direct float type
-                fstream[j * fAudioOutCount + i] = fAudioIntBufOut[i][j];
+        // direct float type
+        carla_interleaveFloats(fstream, fAudioIntBufOut, fAudioOutCount, ulen);
 #else
-                // signed 16bit int
-                istream[j * fAudioOutCount + i] = lrintf(carla_fixedValue(-1.0f, 1.0f, fAudioIntBufOut[i][j]) * 32767.0f);
+        // signed 16bit int
+        carla_interleaveFloats(fAudioInterleavedBuf, fAudioIntBufOut, fAudioOutCount, ulen);
+        carla_convertFloatsToInt16(istream, fAudioInterleavedBuf, ulen * fAudioOutCount);
+#endif
+    }
+
+#ifdef HAVE_SDL2
+    void handleAudioCaptureCallback(uchar* const stream, const int len)
+    {
+        // safety checks
+        CARLA_SAFE_ASSERT_RETURN(stream != nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(len > 0,);
+
+        // if playback is not keeping up the write fails and the commit drops this block
+        fCaptureRing.writeCustomData(stream, static_cast<uint32_t>(len));
+        fCaptureRing.commitWrite();
+    }
 #endif
-            }
+
+    // fill input buffers from the capture ring, silence if the capture device has not delivered enough yet
+    void readCapturedAudio(const uint frames)
+    {
+        const uint32_t size = static_cast<uint32_t>(frames * fAudioInCount * sizeof(float));
+        uint32_t available = fCaptureRing.getReadableDataSize();
+
+        // capture running ahead of playback, drop old data to keep latency bounded
+        for (; available >= size * kCaptureMaxLatencyPeriods; available -= size)
+            fCaptureRing.readCustomData(fAudioInterleavedBuf, size);
+
+        if (available < size)
+        {
+            for (uint i=0; i<fAudioInCount; ++i)
+                carla_zeroFloats(fAudioIntBufIn[i], frames);
+            return;
         }
+
+        fCaptureRing.readCustomData(fAudioInterleavedBuf, size);
+        carla_deinterleaveFloats(fAudioIntBufIn, fAudioInterleavedBuf, fAudioInCount, frames);
     }
 
     // -------------------------------------------------------------------
@@ -412,14 +559,23 @@ protected:
 
 private:
     SDL_AudioDeviceID fDeviceId;
+    SDL_AudioDeviceID fCaptureDeviceId;
 
     // current device name
     CarlaString fDeviceName;
 
     // deinterleaved buffers
+    uint fAudioInCount;
     uint fAudioOutCount;
+    float** fAudioIntBufIn;
     float** fAudioIntBufOut;
 
+    // interleaved scratch buffer, for capture data and int16 output
+    float* fAudioInterleavedBuf;
+
+    // captured audio, written by the capture callback and read by the playback one
+    CarlaHeapRingBuffer fCaptureRing;
+
     #define handlePtr ((CarlaEngineSDL*)userData)
 
     static void carla_sdl_process_callback(void* userData, uchar* stream, int len)
@@ -427,6 +583,13 @@ private:
         handlePtr->handleAudioProcessCallback(stream, len);
     }
 
+#ifdef HAVE_SDL2
+    static void carla_sdl_capture_callback(void* userData, uchar* stream, int len)
+    {
+        handlePtr->handleAudioCaptureCallback(stream, len);
+    }
+#endif
+
     #undef handlePtr
 
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineSDL)
@@ -170,6 +170,11 @@ uint32_t CarlaPlugin::getLatencyInFrames() const noexcept
     return 0;
 }
 
+bool CarlaPlugin::isProcessStateShared() const noexcept
+{
+    return false;
+}
+
 // -------------------------------------------------------------------
 // Information (count)
 
@@ -1736,6 +1741,7 @@ void CarlaPlugin::setParameterMidiChannel(const uint32_t parameterId, const uint
         return;
 
     pData->param.data[parameterId].midiChannel = channel;
+    pData->param.invalidateMappedControls();
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     pData->engine->callback(sendCallback, sendOsc,
@@ -1829,6 +1835,7 @@ void CarlaPlugin::setParameterMappedControlIndex(const uint32_t parameterId, con
 #endif
 
     paramData.mappedControlIndex = index;
+    pData->param.invalidateMappedControls();
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     if (index == CONTROL_INDEX_MIDI_LEARN)
@@ -2609,6 +2616,7 @@ void CarlaPlugin::checkForMidiLearn(EngineEvent& event) noexcept
     event.ctrl.handled = true;
     paramData.mappedControlIndex = static_cast<int16_t>(event.ctrl.param);
     paramData.midiChannel = event.channel;
+    pData->param.invalidateMappedControls();
 
     pData->postponeMidiLearnRtEvent(true, parameterId, static_cast<uint8_t>(event.ctrl.param), event.channel);
     pData->midiLearnParameterIndex = -1;
@@ -26,6 +26,7 @@
 #include "CarlaScopeUtils.hpp"
 #include "CarlaShmUtils.hpp"
 #include "CarlaThread.hpp"
+#include "CarlaTimeUtils.hpp"
 
 #include "jackbridge/JackBridge.hpp"
 
@@ -33,15 +34,21 @@
 
 #include "water/files/File.h"
 #include "water/misc/Time.h"
+#include "water/streams/MemoryOutputStream.h"
 #include "water/threads/ChildProcess.h"
+#include "water/xml/XmlDocument.h"
+#include "water/xml/XmlElement.h"
 
 // ---------------------------------------------------------------------------------------------------------------------
 
 using water::ChildProcess;
 using water::File;
+using water::MemoryOutputStream;
 using water::String;
 using water::StringArray;
 using water::Time;
+using water::XmlDocument;
+using water::XmlElement;
 
 CARLA_BACKEND_START_NAMESPACE
 
@@ -50,6 +57,15 @@ CARLA_BACKEND_START_NAMESPACE
 
 static const ExternalMidiNote kExternalMidiNoteFallback = { -1, 0, 0 };
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Health monitoring
+
+// minimum time between bridge health warnings, in milliseconds
+static const uint32_t kBridgeHealthWarningInterval = 1000;
+
+// how many times a hung bridge is restarted before giving up on it
+static const uint kBridgeMaxHungRestarts = 3;
+
 // ---------------------------------------------------------------------------------------------------------------------
 
 static String findWinePrefix(const String filename, const int recursionLimit = 10)
@@ -421,6 +437,7 @@ public:
           fBufferSize(engine->getBufferSize()),
           fProcWaitTime(0),
           fPendingEmbedCustomUI(0),
+          fHealth(),
           fBridgeBinary(),
           fBridgeThread(engine, this),
           fShmAudioPool(),
@@ -434,7 +451,9 @@ public:
           fInfo(),
           fUniqueId(0),
           fLatency(0),
-          fParams(nullptr)
+          fParams(nullptr),
+          fParamInfoReceived(true),
+          fParamInfoRequestTime(0)
     {
         carla_debug("CarlaPluginBridge::CarlaPluginBridge(%p, %i, %s, %s)", engine, id, BinaryType2Str(btype), PluginType2Str(ptype));
 
@@ -679,6 +698,29 @@ public:
         return false;
     }
 
+    // ask for parameter names, symbols and units once the bridge is up, the reply is handled in handleNonRtData()
+    void requestParameterInfo()
+    {
+        if (fParamInfoReceived || fTimedOut || ! fInitiated)
+            return;
+
+        const uint32_t now = Time::getMillisecondCounter();
+
+        // ask again if the bridge did not reply in time
+        if (fParamInfoRequestTime != 0 && now - fParamInfoRequestTime < 2000)
+            return;
+
+        if (fParamInfoRequestTime != 0)
+            carla_stderr("CarlaPluginBridge::requestParameterInfo() - Timeout while requesting parameter info, retrying");
+
+        fParamInfoRequestTime = now != 0 ? now : 1;
+
+        const CarlaMutexLocker _cml(fShmNonRtClientControl.mutex);
+
+        fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientGetParameterInfo);
+        fShmNonRtClientControl.commitWrite();
+    }
+
     void waitForSaved()
     {
         if (fSaved)
@@ -1109,7 +1151,16 @@ public:
         if (fBridgeThread.isThreadRunning())
         {
             if (fInitiated && fTimedOut && pData->active)
-                setActive(false, true, true);
+            {
+                if (pData->engine->getOptions().restartHungBridges && fHealth.hungRestarts < kBridgeMaxHungRestarts)
+                    restartHungBridge();
+                else
+                    setActive(false, true, true);
+            }
+            else if (fInitiated && pData->active)
+            {
+                checkHealth();
+            }
 
             {
                 const CarlaMutexLocker _cml(fShmNonRtClientControl.mutex);
@@ -1121,6 +1172,8 @@ public:
             try {
                 handleNonRtData();
             } CARLA_SAFE_EXCEPTION("handleNonRtData");
+
+            requestParameterInfo();
         }
         else if (fInitiated)
         {
@@ -1551,17 +1604,9 @@ public:
                         }
 #endif
                         // Control plugin parameters
-                        for (uint32_t k=0; k < pData->param.count; ++k)
+                        for (uint32_t k = pData->param.getFirstMappedParameter(event.channel, ctrlEvent.param);
+                             k < pData->param.count; k = pData->param.getNextMappedParameter(k))
                         {
-                            if (pData->param.data[k].midiChannel != event.channel)
-                                continue;
-                            if (pData->param.data[k].mappedControlIndex != ctrlEvent.param)
-                                continue;
-                            if (pData->param.data[k].type != PARAMETER_INPUT)
-                                continue;
-                            if ((pData->param.data[k].hints & PARAMETER_IS_AUTOMATABLE) == 0)
-                                continue;
-
                             ctrlEvent.handled = true;
                             value = pData->param.getFinalUnnormalizedValue(k, ctrlEvent.normalizedValue);
                             setParameterValueRT(k, value, event.time, true);
@@ -1852,6 +1897,8 @@ public:
         // --------------------------------------------------------------------------------------------------------
         // Run plugin
 
+        const int64_t procStartTime = carla_gettime_us();
+
         {
             fShmRtClientControl.writeOpcode(kPluginBridgeRtClientProcess);
             fShmRtClientControl.writeUInt(frames);
@@ -1866,6 +1913,17 @@ public:
             return false;
         }
 
+        {
+            const int64_t procEndTime = carla_gettime_us();
+
+            if (procEndTime > procStartTime)
+                fHealth.update(fShmRtClientControl.data->telemetry,
+                               static_cast<uint64_t>(procEndTime - procStartTime),
+                               static_cast<double>(frames) / pData->engine->getSampleRate() * 1000000.0,
+                               fProcWaitTime,
+                               pData->engine->isOffline());
+        }
+
         for (uint32_t i=0; i < pData->audioOut.count; ++i)
             carla_copyFloats(audioOut[i], fShmAudioPool.data + ((pData->audioIn.count + i) * fBufferSize), frames);
         for (uint32_t i=0; i < pData->cvOut.count; ++i)
@@ -2254,6 +2312,10 @@ public:
                     fParams = nullptr;
                 }
 
+                // names, symbols and units are only sent on request since API 11
+                fParamInfoReceived    = fBridgeVersion < 11;
+                fParamInfoRequestTime = 0;
+
                 if (count > 0)
                 {
                     pData->param.createNew(count, false);
@@ -2335,6 +2397,7 @@ public:
                     pData->param.data[index].rindex = rindex;
                     pData->param.data[index].hints  = hints;
                     pData->param.data[index].mappedControlIndex = ctrl;
+                    pData->param.invalidateMappedControls();
                 }
             }   break;
 
@@ -2626,6 +2689,12 @@ public:
                 fReceivingParamText.setReceivedData(index, text, textSize);
             }   break;
 
+            case kPluginBridgeNonRtServerParameterInfoDone:
+                fParamInfoReceived    = true;
+                fParamInfoRequestTime = 0;
+                pData->engine->callback(true, true, ENGINE_CALLBACK_RELOAD_PARAMETERS, pData->id, 0, 0, 0, 0.0f, nullptr);
+                break;
+
             case kPluginBridgeNonRtServerReady:
                 fInitiated = true;
                 break;
@@ -2921,6 +2990,94 @@ private:
     uint fProcWaitTime;
     uint64_t fPendingEmbedCustomUI;
 
+    struct Health {
+        // written by the audio thread, reset by the idle thread once reported
+        volatile uint32_t missedDeadlines;
+        volatile uint32_t nearTimeouts;
+        volatile uint64_t worstRoundTrip;
+        volatile uint64_t worstWakeLatency;
+        volatile float worstLoad;
+
+        // only used by the idle thread
+        uint64_t lastFaultCount;
+        uint64_t lastBridgeMissedDeadlines;
+        uint32_t lastWarningTime;
+        uint hungRestarts;
+
+        Health() noexcept
+            : missedDeadlines(0),
+              nearTimeouts(0),
+              worstRoundTrip(0),
+              worstWakeLatency(0),
+              worstLoad(0.0f),
+              lastFaultCount(0),
+              lastBridgeMissedDeadlines(0),
+              lastWarningTime(0),
+              hungRestarts(0) {}
+
+        // called from the audio thread after each processed block
+        void update(const BridgeRtClientTelemetry& telemetry,
+                    const uint64_t roundTrip, const double blockDuration, const uint timeout,
+                    const bool offline) noexcept
+        {
+            const uint64_t wakeLatency = roundTrip > telemetry.processTime ? roundTrip - telemetry.processTime : 0;
+            const float load = static_cast<float>(static_cast<double>(roundTrip) / blockDuration * 100.0);
+
+            if (roundTrip > worstRoundTrip)
+                worstRoundTrip = roundTrip;
+            if (wakeLatency > worstWakeLatency)
+                worstWakeLatency = wakeLatency;
+            if (load > worstLoad)
+                worstLoad = load;
+
+            // a bridge halfway to its timeout is about to be silenced
+            if (roundTrip > static_cast<uint64_t>(timeout) * 500)
+                ++nearTimeouts;
+
+            if (load > 100.0f && ! offline)
+                ++missedDeadlines;
+        }
+
+        // called from the idle thread, returns true if a warning should be sent
+        bool needsWarning(const BridgeRtClientTelemetry& telemetry,
+                          uint32_t& newFaults, uint32_t& newBridgeMissedDeadlines) noexcept
+        {
+            const uint64_t faultCount = telemetry.minorFaults + telemetry.majorFaults;
+            newFaults = faultCount > lastFaultCount ? static_cast<uint32_t>(faultCount - lastFaultCount) : 0;
+
+            // blocks the plugin itself took too long to process, as measured by the bridge
+            newBridgeMissedDeadlines = telemetry.missedDeadlines > lastBridgeMissedDeadlines
+                                     ? static_cast<uint32_t>(telemetry.missedDeadlines - lastBridgeMissedDeadlines)
+                                     : 0;
+
+            if (missedDeadlines == 0 && nearTimeouts == 0 && newBridgeMissedDeadlines == 0)
+                return false;
+
+            const uint32_t now = Time::getMillisecondCounter();
+
+            if (now - lastWarningTime < kBridgeHealthWarningInterval)
+                return false;
+
+            lastFaultCount  = faultCount;
+            lastBridgeMissedDeadlines = telemetry.missedDeadlines;
+            lastWarningTime = now;
+            return true;
+        }
+
+        // called from the idle thread after a warning is sent,
+        // a block being processed meanwhile might get lost, which is fine for reporting purposes
+        void reset() noexcept
+        {
+            missedDeadlines = 0;
+            nearTimeouts = 0;
+            worstRoundTrip = 0;
+            worstWakeLatency = 0;
+            worstLoad = 0.0f;
+        }
+
+        CARLA_DECLARE_NON_COPYABLE(Health)
+    } fHealth;
+
     CarlaString             fBridgeBinary;
     CarlaPluginBridgeThread fBridgeThread;
 
@@ -3089,6 +3246,10 @@ private:
 
     BridgeParamInfo* fParams;
 
+    // parameter names, symbols and units arrive after the rest of the plugin info, see requestParameterInfo()
+    bool fParamInfoReceived;
+    uint32_t fParamInfoRequestTime; // 0 if not requested
+
     void handleProcessStopped() noexcept
     {
         const bool wasActive = pData->active;
@@ -3117,6 +3278,77 @@ private:
         }
     }
 
+    void checkHealth()
+    {
+        const BridgeRtClientTelemetry& telemetry(fShmRtClientControl.data->telemetry);
+
+        uint32_t newFaults, newBridgeMissedDeadlines;
+        if (! fHealth.needsWarning(telemetry, newFaults, newBridgeMissedDeadlines))
+            return;
+
+        char strBuf[STR_MAX+1];
+        carla_zeroChars(strBuf, STR_MAX+1);
+        std::snprintf(strBuf, STR_MAX, "wake latency: " P_UINT64 "us, process time: " P_UINT64 "us (max " P_UINT64 "us), "
+                                       "slow blocks in bridge: %u",
+                      static_cast<uint64_t>(fHealth.worstWakeLatency), telemetry.processTime, telemetry.maxProcessTime,
+                      newBridgeMissedDeadlines);
+
+        pData->engine->callback(true, true,
+                                ENGINE_CALLBACK_BRIDGE_HEALTH_WARNING,
+                                pData->id,
+                                static_cast<int>(fHealth.missedDeadlines),
+                                static_cast<int>(std::min<uint64_t>(static_cast<uint64_t>(fHealth.worstRoundTrip), INT32_MAX)),
+                                static_cast<int>(std::min<uint32_t>(newFaults, INT32_MAX)),
+                                fHealth.worstLoad,
+                                strBuf);
+
+        fHealth.reset();
+    }
+
+    void restartHungBridge()
+    {
+        carla_stderr2("CarlaPluginBridge::restartHungBridge() - bridge for '%s' stopped responding, restarting it",
+                      pData->name);
+        ++fHealth.hungRestarts;
+
+        // the bridge cannot be asked for its state anymore, use whatever we received last.
+        // loadStateSave() modifies our own state save as it goes, so it needs to load from a copy
+        fSaved = true;
+        CarlaStateSave lastState;
+
+        {
+            MemoryOutputStream stream;
+            stream << "<Plugin>\n";
+            getStateSave(false).dumpToMemoryStream(stream);
+            stream << "</Plugin>\n";
+
+            XmlDocument xml(stream.toString());
+            CarlaScopedPointer<XmlElement> xmlElement(xml.getDocumentElement());
+
+            if (xmlElement == nullptr || ! lastState.fillFromXmlElement(xmlElement))
+                carla_stderr2("CarlaPluginBridge::restartHungBridge() - failed to copy last state of '%s'",
+                              pData->name);
+        }
+
+        {
+            // keep the audio thread away while restarting
+            const ScopedDisabler sd(this);
+
+            fBridgeThread.stopThread(6000);
+            activate();
+        }
+
+        if (fTimedOut || ! fInitiated)
+        {
+            carla_stderr2("CarlaPluginBridge::restartHungBridge() - failed to restart bridge for '%s'", pData->name);
+            handleProcessStopped();
+            return;
+        }
+
+        fHealth.reset();
+        loadStateSave(lastState);
+    }
+
     void resizeAudioPool(const uint32_t bufferSize)
     {
         fShmAudioPool.resize(bufferSize, fInfo.aIns+fInfo.aOuts, fInfo.cvIns+fInfo.cvOuts);
@@ -3149,6 +3381,9 @@ private:
         // reset memory
         fShmRtClientControl.data->procFlags = 0;
         carla_zeroStruct(fShmRtClientControl.data->timeInfo);
+        carla_zeroStruct(fShmRtClientControl.data->telemetry);
+        fHealth.lastFaultCount = 0;
+        fHealth.lastBridgeMissedDeadlines = 0;
         carla_zeroBytes(fShmRtClientControl.data->midiOut, kBridgeRtClientDataMidiOutSize);
 
         fShmRtClientControl.clearData();
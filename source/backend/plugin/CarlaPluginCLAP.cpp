@@ -2212,17 +2212,9 @@ public:
 #endif
                         // Control plugin parameters
                         uint32_t k;
-                        for (k=0; k < pData->param.count; ++k)
+                        for (k = pData->param.getFirstMappedParameter(event.channel, ctrlEvent.param);
+                             k < pData->param.count; k = pData->param.getNextMappedParameter(k))
                         {
-                            if (pData->param.data[k].midiChannel != event.channel)
-                                continue;
-                            if (pData->param.data[k].mappedControlIndex != ctrlEvent.param)
-                                continue;
-                            if (pData->param.data[k].type != PARAMETER_INPUT)
-                                continue;
-                            if ((pData->param.data[k].hints & PARAMETER_IS_AUTOMATABLE) == 0)
-                                continue;
-
                             ctrlEvent.handled = true;
                             value = pData->param.getFinalUnnormalizedValue(k, ctrlEvent.normalizedValue);
                             setParameterValueRT(k, value, event.time, true);
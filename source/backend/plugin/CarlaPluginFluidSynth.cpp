@@ -39,6 +39,162 @@ CARLA_BACKEND_START_NAMESPACE
 
 static const ExternalMidiNote kExternalMidiNoteFallback = { -1, 0, 0 };
 
+#if FLUIDSYNTH_VERSION_MAJOR >= 2
+// -------------------------------------------------------------------------------------------------------------------
+// SoundFonts shared by all synths in the process
+//
+// Each SoundFont file is loaded once, by a private synth that keeps ownership of it.
+// Plugin synths then add the same loaded SoundFont to their own stack, so the sample data exists only once
+// no matter how many instances use it. The loaded data is released together with the last instance.
+
+class FluidSynthSoundFontCache
+{
+public:
+    static FluidSynthSoundFontCache& getInstance()
+    {
+        static FluidSynthSoundFontCache cache;
+        return cache;
+    }
+
+    fluid_sfont_t* acquire(const char* const filename)
+    {
+        const CarlaMutexLocker cml(fMutex);
+
+        for (LinkedList<SharedSoundFont*>::Itenerator it = fSoundFonts.begin2(); it.valid(); it.next())
+        {
+            SharedSoundFont* const soundFont(it.getValue(nullptr));
+            CARLA_SAFE_ASSERT_CONTINUE(soundFont != nullptr);
+
+            if (soundFont->filename != filename)
+                continue;
+
+            ++soundFont->refCount;
+            return soundFont->sfont;
+        }
+
+        fluid_settings_t* const settings = new_fluid_settings();
+        CARLA_SAFE_ASSERT_RETURN(settings != nullptr, nullptr);
+
+        // this synth never plays, keep it as small as possible
+        fluid_settings_setint(settings, "synth.polyphony", 1);
+        fluid_settings_setint(settings, "synth.ladspa.active", 0);
+        fluid_settings_setint(settings, "synth.lock-memory", 1);
+        fluid_settings_setint(settings, "synth.dynamic-sample-loading", 0);
+        fluid_settings_setint(settings, "synth.threadsafe-api", 0);
+
+        fluid_synth_t* const loader = new_fluid_synth(settings);
+
+        if (loader == nullptr)
+        {
+            delete_fluid_settings(settings);
+            return nullptr;
+        }
+
+        const int sfontId = fluid_synth_sfload(loader, filename, 0);
+        fluid_sfont_t* const sfont = sfontId >= 0 ? fluid_synth_get_sfont_by_id(loader, sfontId) : nullptr;
+
+        if (sfont == nullptr)
+        {
+            delete_fluid_synth(loader);
+            delete_fluid_settings(settings);
+            return nullptr;
+        }
+
+        SharedSoundFont* const soundFont = new SharedSoundFont;
+        soundFont->filename = filename;
+        soundFont->settings = settings;
+        soundFont->loader   = loader;
+        soundFont->sfont    = sfont;
+        soundFont->refCount = 1;
+
+        if (! fSoundFonts.append(soundFont))
+        {
+            delete_fluid_synth(loader);
+            delete_fluid_settings(settings);
+            delete soundFont;
+            return nullptr;
+        }
+
+        return sfont;
+    }
+
+    void release(fluid_sfont_t* const sfont)
+    {
+        const CarlaMutexLocker cml(fMutex);
+
+        for (LinkedList<SharedSoundFont*>::Itenerator it = fSoundFonts.begin2(); it.valid(); it.next())
+        {
+            SharedSoundFont* const soundFont(it.getValue(nullptr));
+            CARLA_SAFE_ASSERT_CONTINUE(soundFont != nullptr);
+
+            if (soundFont->sfont != sfont)
+                continue;
+
+            if (--soundFont->refCount != 0)
+                return;
+
+            fSoundFonts.remove(it);
+
+            delete_fluid_synth(soundFont->loader);
+            delete_fluid_settings(soundFont->settings);
+            delete soundFont;
+            return;
+        }
+
+        carla_safe_assert("soundFont != nullptr", __FILE__, __LINE__);
+    }
+
+    // whether more than one synth uses a SoundFont, assumed so while the cache is busy
+    bool isShared(const fluid_sfont_t* const sfont) noexcept
+    {
+        const CarlaMutexTryLocker cmtl(fMutex);
+
+        if (cmtl.wasNotLocked())
+            return true;
+
+        for (LinkedList<SharedSoundFont*>::Itenerator it = fSoundFonts.begin2(); it.valid(); it.next())
+        {
+            const SharedSoundFont* const soundFont(it.getValue(nullptr));
+            CARLA_SAFE_ASSERT_CONTINUE(soundFont != nullptr);
+
+            if (soundFont->sfont == sfont)
+                return soundFont->refCount > 1;
+        }
+
+        return false;
+    }
+
+    // SoundFont preset iteration is not reentrant, hold this while iterating a shared SoundFont
+    CarlaMutex& getMutex() noexcept
+    {
+        return fMutex;
+    }
+
+private:
+    struct SharedSoundFont {
+        CarlaString       filename;
+        fluid_settings_t* settings;
+        fluid_synth_t*    loader;
+        fluid_sfont_t*    sfont;
+        uint              refCount;
+    };
+
+    CarlaMutex fMutex;
+    LinkedList<SharedSoundFont*> fSoundFonts;
+
+    FluidSynthSoundFontCache()
+        : fMutex(),
+          fSoundFonts() {}
+
+    ~FluidSynthSoundFontCache()
+    {
+        CARLA_SAFE_ASSERT(fSoundFonts.count() == 0);
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(FluidSynthSoundFontCache)
+};
+#endif
+
 // -------------------------------------------------------------------------------------------------------------------
 
 class CarlaPluginFluidSynth : public CarlaPlugin
@@ -50,6 +206,9 @@ public:
           fSettings(nullptr),
           fSynth(nullptr),
           fSynthId(0),
+#if FLUIDSYNTH_VERSION_MAJOR >= 2
+          fSharedSoundFont(nullptr),
+#endif
           fAudio16Buffers(nullptr),
           fLabel(nullptr)
     {
@@ -66,7 +225,7 @@ public:
         fluid_settings_setint(fSettings, "synth.audio-channels", use16Outs ? 16 : 1);
         fluid_settings_setint(fSettings, "synth.audio-groups", use16Outs ? 16 : 1);
         fluid_settings_setnum(fSettings, "synth.sample-rate", pData->engine->getSampleRate());
-        //fluid_settings_setnum(fSettings, "synth.cpu-cores", 2);
+        fluid_settings_setint(fSettings, "synth.cpu-cores", static_cast<int>(pData->engine->getOptions().fluidSynthCpuCores));
         fluid_settings_setint(fSettings, "synth.ladspa.active", 0);
         fluid_settings_setint(fSettings, "synth.lock-memory", 1);
 #if FLUIDSYNTH_VERSION_MAJOR < 2
@@ -126,6 +285,21 @@ public:
             pData->active = false;
         }
 
+#if FLUIDSYNTH_VERSION_MAJOR >= 2
+        if (fSharedSoundFont != nullptr)
+        {
+            // the SoundFont outlives this synth, stop all voices still using it and take it back
+            if (fSynth != nullptr)
+            {
+                fluid_synth_all_sounds_off(fSynth, -1);
+                fluid_synth_remove_sfont(fSynth, fSharedSoundFont);
+            }
+
+            FluidSynthSoundFontCache::getInstance().release(fSharedSoundFont);
+            fSharedSoundFont = nullptr;
+        }
+#endif
+
         if (fSynth != nullptr)
         {
             delete_fluid_synth(fSynth);
@@ -160,6 +334,14 @@ public:
         return PLUGIN_CATEGORY_SYNTH;
     }
 
+#if FLUIDSYNTH_VERSION_MAJOR >= 2
+    bool isProcessStateShared() const noexcept override
+    {
+        // voices of all synths using the same SoundFont touch its samples
+        return fSharedSoundFont != nullptr && FluidSynthSoundFontCache::getInstance().isShared(fSharedSoundFont);
+    }
+#endif
+
     // -------------------------------------------------------------------
     // Information (count)
 
@@ -997,6 +1179,8 @@ public:
         if (fluid_sfont_t* const f_sfont = fluid_synth_get_sfont_by_id(fSynth, fSynthId))
         {
 #if FLUIDSYNTH_VERSION_MAJOR >= 2
+            const CarlaMutexLocker cml(FluidSynthSoundFontCache::getInstance().getMutex());
+
             fluid_preset_t* f_preset;
 
             // initial check to know how many midi-programs we have
@@ -1699,7 +1883,19 @@ public:
         // ---------------------------------------------------------------
         // open soundfont
 
+#if FLUIDSYNTH_VERSION_MAJOR >= 2
+        fSharedSoundFont = FluidSynthSoundFontCache::getInstance().acquire(filename);
+
+        if (fSharedSoundFont == nullptr)
+        {
+            pData->engine->setLastError("Failed to load SoundFont file");
+            return false;
+        }
+
+        const int synthId = fluid_synth_add_sfont(fSynth, fSharedSoundFont);
+#else
         const int synthId = fluid_synth_sfload(fSynth, filename, 0);
+#endif
 
         if (synthId < 0)
         {
@@ -1861,6 +2057,7 @@ private:
     fluid_synth_t*    fSynth;
 #if FLUIDSYNTH_VERSION_MAJOR >= 2
     int fSynthId;
+    fluid_sfont_t* fSharedSoundFont;
 #else
     uint fSynthId;
 #endif
@@ -30,6 +30,44 @@ CARLA_BACKEND_START_NAMESPACE
 static const MidiProgramData kMidiProgramDataNull  = { 0, 0, nullptr };
 static /* */ CustomData      kCustomDataFallbackNC = { nullptr, nullptr, nullptr };
 
+// -----------------------------------------------------------------------
+// Stateless plugins
+
+struct KnownStatelessPlugin {
+    PluginType type;
+    const char* label;
+    int64_t uniqueId;
+};
+
+static const KnownStatelessPlugin kKnownStatelessPlugins[] = {
+    // LADSPA SDK
+    { PLUGIN_LADSPA, "amp_mono", 1048 },
+    // CMT
+    { PLUGIN_LADSPA, "amp_mono", 1067 },
+    // SWH
+    { PLUGIN_LADSPA, "amp", 1181 },
+    { PLUGIN_LADSPA, "fastOverdrive", 1196 },
+    { PLUGIN_LV2, "http://plugin.org.uk/swh-plugins/amp", 0 },
+    { PLUGIN_LV2, "http://plugin.org.uk/swh-plugins/fastOverdrive", 0 },
+    // LV2 examples
+    { PLUGIN_LV2, "http://lv2plug.in/plugins/eg-amp", 0 },
+};
+
+bool isPluginKnownStateless(const PluginType type, const char* const label, const int64_t uniqueId) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(label != nullptr, false);
+
+    for (std::size_t i=0; i < sizeof(kKnownStatelessPlugins)/sizeof(kKnownStatelessPlugins[0]); ++i)
+    {
+        const KnownStatelessPlugin& plugin(kKnownStatelessPlugins[i]);
+
+        if (plugin.type == type && plugin.uniqueId == uniqueId && std::strcmp(plugin.label, label) == 0)
+            return true;
+    }
+
+    return false;
+}
+
 // -----------------------------------------------------------------------
 // PluginAudioData
 
@@ -191,213 +229,6 @@ void PluginEventData::initBuffers() const noexcept
         portOut->initBuffer();
 }
 
-// -----------------------------------------------------------------------
-// PluginParameterData
-
-PluginParameterData::PluginParameterData() noexcept
-    : count(0),
-      data(nullptr),
-      ranges(nullptr),
-      special(nullptr) {}
-
-PluginParameterData::~PluginParameterData() noexcept
-{
-    CARLA_SAFE_ASSERT_INT(count == 0, count);
-    CARLA_SAFE_ASSERT(data == nullptr);
-    CARLA_SAFE_ASSERT(ranges == nullptr);
-    CARLA_SAFE_ASSERT(special == nullptr);
-}
-
-void PluginParameterData::createNew(const uint32_t newCount, const bool withSpecial)
-{
-    CARLA_SAFE_ASSERT_INT(count == 0, count);
-    CARLA_SAFE_ASSERT_RETURN(data == nullptr,);
-    CARLA_SAFE_ASSERT_RETURN(ranges == nullptr,);
-    CARLA_SAFE_ASSERT_RETURN(special == nullptr,);
-    CARLA_SAFE_ASSERT_RETURN(newCount > 0,);
-
-    data = new ParameterData[newCount];
-    carla_zeroStructs(data, newCount);
-
-    for (uint32_t i=0; i < newCount; ++i)
-    {
-        data[i].index  = PARAMETER_NULL;
-        data[i].rindex = PARAMETER_NULL;
-        data[i].mappedControlIndex = CONTROL_INDEX_NONE;
-        data[i].mappedMinimum = -1.0f;
-        data[i].mappedMaximum = 1.0f;
-    }
-
-    ranges = new ParameterRanges[newCount];
-    carla_zeroStructs(ranges, newCount);
-
-    if (withSpecial)
-    {
-        special = new SpecialParameterType[newCount];
-        carla_zeroStructs(special, newCount);
-    }
-
-    count = newCount;
-}
-
-void PluginParameterData::clear() noexcept
-{
-    if (data != nullptr)
-    {
-        delete[] data;
-        data = nullptr;
-    }
-
-    if (ranges != nullptr)
-    {
-        delete[] ranges;
-        ranges = nullptr;
-    }
-
-    if (special != nullptr)
-    {
-        delete[] special;
-        special = nullptr;
-    }
-
-    count = 0;
-}
-
-float PluginParameterData::getFixedValue(const uint32_t parameterId, float value) const noexcept
-{
-    CARLA_SAFE_ASSERT_RETURN(parameterId < count, 0.0f);
-
-    const uint             paramHints (data[parameterId].hints);
-    const ParameterRanges& paramRanges(ranges[parameterId]);
-
-    // if boolean, return either min or max
-    if (paramHints & PARAMETER_IS_BOOLEAN)
-    {
-        const float middlePoint = paramRanges.min + (paramRanges.max-paramRanges.min)/2.0f;
-        return value >= middlePoint ? paramRanges.max : paramRanges.min;
-    }
-
-    // if integer, round first
-    if (paramHints & PARAMETER_IS_INTEGER)
-        return paramRanges.getFixedValue(std::round(value));
-
-    // normal mode
-    return paramRanges.getFixedValue(value);
-}
-
-// copied from ParameterRanges::getUnnormalizedValue
-static float _getUnnormalizedValue(const float min, const float max, const float value) noexcept
-{
-    if (value <= 0.0f)
-        return min;
-    if (value >= 1.0f)
-        return max;
-
-    return value * (max - min) + min;
-}
-
-// copied from ParameterRanges::getUnnormalizedLogValue
-static float _getUnnormalizedLogValue(const float min, const float max, const float value) noexcept
-{
-    if (value <= 0.0f)
-        return min;
-    if (value >= 1.0f)
-        return max;
-
-    float rmin = min;
-
-    if (std::abs(min) < std::numeric_limits<float>::epsilon())
-        rmin = 0.00001f;
-
-    return rmin * std::pow(max/rmin, value);
-}
-
-float PluginParameterData::getFinalUnnormalizedValue(const uint32_t parameterId,
-                                                     const float normalizedValue) const noexcept
-{
-    float min, max, value;
-
-    if (data[parameterId].mappedControlIndex != CONTROL_INDEX_CV
-        && (data[parameterId].hints & PARAMETER_MAPPED_RANGES_SET) != 0x0)
-    {
-        min = data[parameterId].mappedMinimum;
-        max = data[parameterId].mappedMaximum;
-    }
-    else
-    {
-        min = ranges[parameterId].min;
-        max = ranges[parameterId].max;
-    }
-
-    if (data[parameterId].hints & PARAMETER_IS_BOOLEAN)
-    {
-        value = (normalizedValue < 0.5f) ? min : max;
-    }
-    else
-    {
-        if (data[parameterId].hints & PARAMETER_IS_LOGARITHMIC)
-            value = _getUnnormalizedLogValue(min, max, normalizedValue);
-        else
-            value = _getUnnormalizedValue(min, max, normalizedValue);
-
-        if (data[parameterId].hints & PARAMETER_IS_INTEGER)
-            value = std::rint(value);
-    }
-
-    return value;
-}
-
-float PluginParameterData::getFinalValueWithMidiDelta(const uint32_t parameterId,
-                                                      float value, int8_t delta) const noexcept
-{
-    if (delta < 0)
-        return value;
-    if (data[parameterId].mappedControlIndex <= 0 || data[parameterId].mappedControlIndex >= MAX_MIDI_CONTROL)
-        return value;
-
-    float min, max;
-
-    if ((data[parameterId].hints & PARAMETER_MAPPED_RANGES_SET) != 0x0)
-    {
-        min = data[parameterId].mappedMinimum;
-        max = data[parameterId].mappedMaximum;
-    }
-    else
-    {
-        min = ranges[parameterId].min;
-        max = ranges[parameterId].max;
-    }
-
-    if (data[parameterId].hints & PARAMETER_IS_BOOLEAN)
-    {
-        value = delta > 63 ? min : max;
-    }
-    else
-    {
-        if (data[parameterId].hints & PARAMETER_IS_INTEGER)
-        {
-            if (delta > 63)
-                value += delta - 128.0f;
-            else
-                value += delta;
-        }
-        else
-        {
-            if (delta > 63)
-                delta = static_cast<int8_t>(delta - 128);
-
-            value += (max - min) * (static_cast<float>(delta) / 127.0f);
-        }
-
-        if (value < min)
-            value = min;
-        else if (value > max)
-            value = max;
-    }
-
-    return value;
-}
-
 // -----------------------------------------------------------------------
 // PluginProgramData
 
@@ -744,6 +575,7 @@ CarlaPlugin::ProtectedData::ProtectedData(CarlaEngine* const eng, const uint idx
       cvOut(),
       event(),
       param(),
+      paramSmoother(),
       prog(),
       midiprog(),
       custom(),
@@ -862,6 +694,7 @@ void CarlaPlugin::ProtectedData::clearBuffers() noexcept
     cvIn.clear();
     cvOut.clear();
     param.clear();
+    paramSmoother.clear();
     event.clear();
 #ifndef BUILD_BRIDGE
     latency.clearBuffers();
@@ -1033,6 +866,49 @@ void CarlaPlugin::ProtectedData::updateDefaultParameterValues(CarlaPlugin* const
         param.ranges[i].def = param.ranges[i].getFixedValue(plugin->getParameterValue(i));
 }
 
+bool CarlaPlugin::ProtectedData::isSmoothedParameterEvent(const EngineEvent& event) noexcept
+{
+    if (paramSmoother.count == 0)
+        return false;
+    if (event.type != kEngineEventTypeControl || event.ctrl.type != kEngineControlEventTypeParameter)
+        return false;
+
+    const EngineControlEvent& ctrlEvent(event.ctrl);
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    if (event.channel == kEngineEventNonMidiChannel)
+        return ctrlEvent.param < paramSmoother.count && paramSmoother.smoothable[ctrlEvent.param];
+
+    // dry/wet, volume and balance are applied per block
+    if (event.channel == ctrlChannel)
+    {
+        if (MIDI_IS_CONTROL_BREATH_CONTROLLER(ctrlEvent.param) && (hints & PLUGIN_CAN_DRYWET) != 0)
+            return false;
+        if (MIDI_IS_CONTROL_CHANNEL_VOLUME(ctrlEvent.param) && (hints & PLUGIN_CAN_VOLUME) != 0)
+            return false;
+        if (MIDI_IS_CONTROL_BALANCE(ctrlEvent.param) && (hints & PLUGIN_CAN_BALANCE) != 0)
+            return false;
+    }
+#endif
+
+    // also sent to the plugin as MIDI, at the start of the current block part
+    if ((options & PLUGIN_OPTION_SEND_CONTROL_CHANGES) != 0 && ctrlEvent.param < MAX_MIDI_VALUE)
+        return false;
+
+    uint32_t k = param.getFirstMappedParameter(event.channel, ctrlEvent.param);
+
+    if (k >= param.count)
+        return false;
+
+    for (; k < param.count; k = param.getNextMappedParameter(k))
+    {
+        if (k >= paramSmoother.count || ! paramSmoother.smoothable[k])
+            return false;
+    }
+
+    return true;
+}
+
 // -----------------------------------------------------------------------
 
 CARLA_BACKEND_END_NAMESPACE
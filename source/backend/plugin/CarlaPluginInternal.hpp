@@ -69,6 +69,12 @@ enum SpecialParameterType {
     PARAMETER_SPECIAL_TIME        = 4
 };
 
+// -----------------------------------------------------------------------
+// Plugins known to keep no internal state between runs, safe to run through a single instance per channel.
+// LADSPA plugins are matched by label and unique id, LV2 plugins by URI.
+
+bool isPluginKnownStateless(PluginType type, const char* label, int64_t uniqueId) noexcept;
+
 // -----------------------------------------------------------------------
 
 /*!
@@ -191,6 +197,16 @@ struct PluginParameterData {
     ParameterRanges* ranges;
     SpecialParameterType* special;
 
+    /*
+     * MIDI CC to parameter lookup table, used by the RT thread when dispatching control events.
+     * Each channel and CC pair points to its first mapped parameter, the others are chained through "mappedNext".
+     * Only automatable input parameters are included, in ascending index order.
+     * Non-RT code flags mapping changes with invalidateMappedControls(), the table is then rebuilt on the next lookup.
+     */
+    uint32_t* mappedFirst; // [MAX_MIDI_CHANNELS * MAX_MIDI_CONTROL]
+    uint32_t* mappedNext;  // [count]
+    volatile bool mappedControlsChanged;
+
     PluginParameterData() noexcept;
     ~PluginParameterData() noexcept;
     void createNew(uint32_t newCount, bool withSpecial);
@@ -199,11 +215,68 @@ struct PluginParameterData {
     float getFinalUnnormalizedValue(uint32_t parameterId, float normalizedValue) const noexcept;
     float getFinalValueWithMidiDelta(uint32_t parameterId, float value, int8_t delta) const noexcept;
 
+    // returns a value >= count when nothing (else) is mapped
+    uint32_t getFirstMappedParameter(uint8_t channel, uint16_t control) noexcept;
+    uint32_t getNextMappedParameter(uint32_t parameterId) const noexcept;
+    void invalidateMappedControls() noexcept;
+    void updateMappedControls() noexcept;
+
     CARLA_DECLARE_NON_COPYABLE(PluginParameterData)
 };
 
 // -----------------------------------------------------------------------
 
+/*
+ * Linear ramps for plugin control ports, see ENGINE_OPTION_PARAMETER_SMOOTHING_TIME.
+ * Values are written directly into the plugin-owned port buffer, which also holds the current value of each ramp.
+ * Plugins advance the ramps in steps of kQuantum frames while any is active, running each step with constant values.
+ */
+struct PluginParameterSmoother {
+    static constexpr const uint32_t kQuantum = 32;
+
+    uint32_t count;
+    uint32_t activeCount;
+    uint32_t rampFrames; // 0 if disabled
+    float* buffer;
+    float* targets;
+    float* steps;
+    uint32_t* remaining; // frames left for each ramp, 0 if idle
+    bool* smoothable;
+
+    // ramps stopped from outside the audio thread, applied on the next advance()
+    float* cancelValues;
+    volatile bool* cancelRequested;
+    volatile bool hasCancelRequests;
+
+    PluginParameterSmoother() noexcept;
+    ~PluginParameterSmoother() noexcept;
+    void createNew(const PluginParameterData& param, float* paramBuffer, uint32_t newRampFrames);
+    void clear() noexcept;
+
+    bool isRamping() const noexcept
+    {
+        return activeCount != 0;
+    }
+
+    // the following are only to be called from the audio thread
+    // start a ramp towards value, returns false if the parameter is not smoothed
+    bool setTarget(uint32_t parameterId, float value) noexcept;
+    void advance(uint32_t frames) noexcept;
+
+    // the following can be called from any thread
+    // stop a ramp for a value just written into the port buffer, which the ramp must not overwrite
+    void cancel(uint32_t parameterId, float value) noexcept;
+    // stop all ramps, keeping the current port values, for program and preset changes
+    void cancelAll() noexcept;
+
+    // stop a ramp, leaving the port buffer as it is (audio thread only)
+    void stop(uint32_t parameterId) noexcept;
+
+    CARLA_DECLARE_NON_COPYABLE(PluginParameterSmoother)
+};
+
+// -----------------------------------------------------------------------
+
 typedef const char* ProgramName;
 
 struct PluginProgramData {
@@ -235,6 +308,83 @@ struct PluginMidiProgramData {
     CARLA_DECLARE_NON_COPYABLE(PluginMidiProgramData)
 };
 
+// -----------------------------------------------------------------------
+// Storage for the MIDI events sent to a plugin during one process block, in the plugin API format.
+// The process thread never allocates, when events do not fit it only flags that more space is needed,
+// which the plugin then allocates outside of it, on its next idle call.
+
+template<typename E>
+struct PluginMidiEventStorage {
+    E* data;
+    uint32_t capacity;
+    volatile bool needsMoreSpace;
+
+    PluginMidiEventStorage() noexcept
+        : data(nullptr),
+          capacity(0),
+          needsMoreSpace(false) {}
+
+    ~PluginMidiEventStorage() noexcept
+    {
+        clear();
+    }
+
+    // (re)allocate zeroed storage for at least newCapacity events, previous contents are lost
+    bool resize(const uint32_t newCapacity) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(newCapacity > 0, false);
+
+        needsMoreSpace = false;
+
+        if (newCapacity <= capacity)
+            return true;
+
+        E* newData;
+
+        try {
+            newData = new E[newCapacity];
+        } CARLA_SAFE_EXCEPTION_RETURN("PluginMidiEventStorage::resize", false);
+
+        carla_zeroStructs(newData, newCapacity);
+
+        delete[] data;
+        data     = newData;
+        capacity = newCapacity;
+        return true;
+    }
+
+    void clear() noexcept
+    {
+        if (data != nullptr)
+        {
+            delete[] data;
+            data = nullptr;
+        }
+
+        capacity = 0;
+        needsMoreSpace = false;
+    }
+
+    // check if count more events fit after the used ones, asking for more space if not
+    bool hasSpaceFor(const uint32_t used, const uint32_t count = 1) noexcept
+    {
+        if (used + count <= capacity)
+            return true;
+
+        needsMoreSpace = true;
+        return false;
+    }
+
+    // zero the events used by the previous block, instead of the whole storage
+    void clearUsed(const uint32_t used) noexcept
+    {
+        if (used != 0)
+            carla_zeroStructs(data, std::min(used, capacity));
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(PluginMidiEventStorage)
+};
+
 // -----------------------------------------------------------------------
 
 struct CarlaPlugin::ProtectedData {
@@ -277,6 +427,7 @@ struct CarlaPlugin::ProtectedData {
     PluginCVData cvOut;
     PluginEventData event;
     PluginParameterData param;
+    PluginParameterSmoother paramSmoother;
     PluginProgramData prog;
     PluginMidiProgramData midiprog;
     LinkedList<CustomData> custom;
@@ -453,6 +604,10 @@ struct CarlaPlugin::ProtectedData {
                                bool sendCallback, bool sendOsc, bool useDefault) noexcept;
     void updateDefaultParameterValues(CarlaPlugin* plugin) noexcept;
 
+    // whether a control event only changes parameters that paramSmoother ramps,
+    // in which case processing does not need to split the block at the event time (audio thread only)
+    bool isSmoothedParameterEvent(const EngineEvent& event) noexcept;
+
     // -------------------------------------------------------------------
 
 #ifdef CARLA_PROPER_CPP11_SUPPORT
@@ -81,9 +81,10 @@ class CarlaPluginJackThread : public CarlaThread
 public:
     CarlaPluginJackThread(Announcer* const ann, CarlaEngine* const engine, CarlaPlugin* const plugin) noexcept
         : CarlaThread("CarlaPluginJackThread"),
-          kAnnouncer(ann),
           kEngine(engine),
-          kPlugin(plugin),
+          fAnnouncer(ann),
+          fPlugin(plugin),
+          fOwnerMutex(),
           fShmIds(),
           fSetupLabel(),
 #ifdef HAVE_LIBLO
@@ -104,6 +105,15 @@ public:
         fSetupLabel = setupLabel;
     }
 
+    // called when the running application is handed over to another plugin, or parked (null owner)
+    void setOwner(Announcer* const ann, CarlaPlugin* const plugin) noexcept
+    {
+        const CarlaMutexLocker cml(fOwnerMutex);
+
+        fAnnouncer = ann;
+        fPlugin    = plugin;
+    }
+
     uintptr_t getProcessID() const noexcept
     {
         CARLA_SAFE_ASSERT_RETURN(fProcess != nullptr, 0);
@@ -125,6 +135,19 @@ public:
         lo_send_from(fOscClientAddress, fOscServer, LO_TT_IMMEDIATE, "/nsm/client/save", "");
     }
 
+    void nsmOpen(const char* const setupLabel)
+    {
+        if (fSetupLabel != setupLabel)
+            fSetupLabel = setupLabel;
+
+        if (fOscClientAddress == nullptr)
+            return;
+
+        // force a new open message, so the application switches to the new project path
+        fProject.path.clear();
+        maybeOpenFirstTime(false);
+    }
+
     bool nsmShowGui(const bool yesNo)
     {
         if (fOscClientAddress == nullptr || ! fHasOptionalGui)
@@ -167,7 +190,7 @@ public:
         }
        #endif
 
-        if (kPlugin->getHints() & PLUGIN_HAS_CUSTOM_UI)
+        if (fPlugin->getHints() & PLUGIN_HAS_CUSTOM_UI)
             ret += "export CARLA_FRONTEND_WIN_ID=" + CarlaString(options.frontendWinId) + "\n";
 
         ret += "export CARLA_LIBJACK_SETUP=" + fSetupLabel + "\n";
@@ -188,7 +211,14 @@ protected:
         CARLA_SAFE_ASSERT_RETURN(data != nullptr, 0);
         carla_stdout("CarlaPluginJackThread::_broadcast_handler(%s, %s, %p, %i)", path, types, argv, argc);
 
-        return ((CarlaPluginJackThread*)data)->handleBroadcast(path, types, argv, msg);
+        CarlaPluginJackThread* const self = (CarlaPluginJackThread*)data;
+        const CarlaMutexLocker cml(self->fOwnerMutex);
+
+        // nothing to do while parked as a resident application
+        if (self->fPlugin == nullptr)
+            return 0;
+
+        return self->handleBroadcast(path, types, argv, msg);
     }
 
     void maybeOpenFirstTime(const bool announced)
@@ -196,7 +226,7 @@ protected:
         if (fSetupLabel.length() <= 6)
             return;
 
-        if ((announced || fProject.path.isEmpty()) && fProject.init(kPlugin->getName(),
+        if ((announced || fProject.path.isEmpty()) && fProject.init(fPlugin->getName(),
                                                                     kEngine->getCurrentProjectFolder(),
                                                                     &fSetupLabel[6U]))
         {
@@ -229,7 +259,7 @@ protected:
             fProject.appName = &argv[0]->s;
             fHasOptionalGui  = std::strstr(&argv[1]->s, ":optional-gui:") != nullptr;
 
-            kAnnouncer->nsmAnnounced(fHasOptionalGui);
+            fAnnouncer->nsmAnnounced(fHasOptionalGui);
 
             static const char* const featuresG = ":server-control:optional-gui:";
             static const char* const featuresN = ":server-control:";
@@ -272,7 +302,7 @@ protected:
 
             kEngine->callback(true, true,
                               ENGINE_CALLBACK_UI_STATE_CHANGED,
-                              kPlugin->getId(),
+                              fPlugin->getId(),
                               1,
                               0, 0, 0.0f, nullptr);
         }
@@ -283,7 +313,7 @@ protected:
 
             kEngine->callback(true, true,
                               ENGINE_CALLBACK_UI_STATE_CHANGED,
-                              kPlugin->getId(),
+                              fPlugin->getId(),
                               0,
                               0, 0, 0.0f, nullptr);
         }
@@ -304,7 +334,7 @@ protected:
 
             kEngine->callback(true, true,
                               ENGINE_CALLBACK_UI_STATE_CHANGED,
-                              kPlugin->getId(),
+                              fPlugin->getId(),
                               0,
                               0, 0, 0.0f, nullptr);
         }
@@ -348,8 +378,8 @@ protected:
                 carla_stderr("CarlaPluginJackThread::run() - already running");
             }
 
-            String name(kPlugin->getName());
-            String filename(kPlugin->getFilename());
+            String name(fPlugin->getName());
+            String filename(fPlugin->getFilename());
 
             if (name.isEmpty())
                 name = "(none)";
@@ -388,7 +418,7 @@ protected:
             const CarlaScopedEnvVar sev3("NSM_URL", lo_server_get_url(fOscServer));
            #endif
 
-            if (kPlugin->getHints() & PLUGIN_HAS_CUSTOM_UI)
+            if (fPlugin->getHints() & PLUGIN_HAS_CUSTOM_UI)
                 carla_setenv("CARLA_FRONTEND_WIN_ID", winIdStr);
             else
                 carla_unsetenv("CARLA_FRONTEND_WIN_ID");
@@ -448,16 +478,18 @@ protected:
             else
             {
                 // forced quit, may have crashed
-                if (fProcess->getExitCodeAndClearPID() != 0)
+                const CarlaMutexLocker cml(fOwnerMutex);
+
+                if (fProcess->getExitCodeAndClearPID() != 0 && fPlugin != nullptr)
                 {
                     carla_stderr("CarlaPluginJackThread::run() - application crashed");
 
-                    CarlaString errorString("Plugin '" + CarlaString(kPlugin->getName()) + "' has crashed!\n"
+                    CarlaString errorString("Plugin '" + CarlaString(fPlugin->getName()) + "' has crashed!\n"
                                             "Saving now will lose its current settings.\n"
                                             "Please remove this plugin, and not rely on it from this point.");
                     kEngine->callback(true, true,
                                     ENGINE_CALLBACK_ERROR,
-                                    kPlugin->getId(),
+                                    fPlugin->getId(),
                                     0, 0, 0, 0.0f,
                                     errorString);
                 }
@@ -468,9 +500,11 @@ protected:
     }
 
 private:
-    Announcer* const kAnnouncer;
     CarlaEngine* const kEngine;
-    CarlaPlugin* const kPlugin;
+
+    Announcer* fAnnouncer;
+    CarlaPlugin* fPlugin;
+    CarlaMutex fOwnerMutex;
 
     CarlaString fShmIds;
     CarlaString fSetupLabel;
@@ -522,13 +556,153 @@ private:
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginJackThread)
 };
 
+// -------------------------------------------------------------------------------------------------------------------
+// A running application and its shared memory, which can outlive the plugin that started it
+
+struct CarlaPluginJackSession {
+    CarlaPluginJackThread thread;
+
+    BridgeAudioPool          shmAudioPool;
+    BridgeRtClientControl    shmRtClientControl;
+    BridgeNonRtClientControl shmNonRtClientControl;
+    BridgeNonRtServerControl shmNonRtServerControl;
+
+    // only valid while resident
+    CarlaEngine* engine;
+    CarlaString filename;
+    CarlaString setupLabel;
+    double sampleRate;
+
+    CarlaPluginJackSession(Announcer* const ann, CarlaEngine* const eng, CarlaPlugin* const plugin) noexcept
+        : thread(ann, eng, plugin),
+          shmAudioPool(),
+          shmRtClientControl(),
+          shmNonRtClientControl(),
+          shmNonRtServerControl(),
+          engine(eng),
+          filename(),
+          setupLabel(),
+          sampleRate(0.0) {}
+
+    void quit(const bool waitForClient) noexcept
+    {
+        if (thread.isThreadRunning())
+        {
+            shmRtClientControl.writeOpcode(kPluginBridgeRtClientQuit);
+            shmRtClientControl.commitWrite();
+
+            shmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientQuit);
+            shmNonRtClientControl.commitWrite();
+
+            if (waitForClient && ! shmRtClientControl.waitForClient(3000))
+                carla_stderr2("CarlaPluginJackSession::quit() - timed out");
+        }
+
+        thread.stopThread(3000);
+
+        shmNonRtServerControl.clear();
+        shmNonRtClientControl.clear();
+        shmRtClientControl.clear();
+        shmAudioPool.clear();
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(CarlaPluginJackSession)
+};
+
+// applications kept running between project loads, see ENGINE_OPTION_RESIDENT_JACK_APPS
+static LinkedList<CarlaPluginJackSession*> gResidentJackSessions;
+static CarlaMutex gResidentJackSessionsMutex;
+
+static bool isMatchingSetupLabel(const char* const label1, const char* const label2) noexcept
+{
+    // audio/midi counts, session manager and flags, ignoring the unique project id
+    return std::strncmp(label1, label2, 6) == 0;
+}
+
+static void parkResidentJackSession(CarlaPluginJackSession* const session) noexcept
+{
+    const CarlaMutexLocker cml(gResidentJackSessionsMutex);
+
+    gResidentJackSessions.append(session);
+}
+
+static CarlaPluginJackSession* takeResidentJackSession(CarlaEngine* const engine,
+                                                       const char* const filename,
+                                                       const char* const label) noexcept
+{
+    if (filename == nullptr || filename[0] == '\0' || label == nullptr || std::strlen(label) < 6)
+        return nullptr;
+
+    const CarlaMutexLocker cml(gResidentJackSessionsMutex);
+
+    for (LinkedList<CarlaPluginJackSession*>::Itenerator it = gResidentJackSessions.begin2(); it.valid(); it.next())
+    {
+        CarlaPluginJackSession* const session(it.getValue(nullptr));
+        CARLA_SAFE_ASSERT_CONTINUE(session != nullptr);
+
+        if (session->engine != engine || session->filename != filename)
+            continue;
+        if (! isMatchingSetupLabel(session->setupLabel, label))
+            continue;
+
+        gResidentJackSessions.remove(it);
+
+        // application went away while parked
+        if (! session->thread.isThreadRunning())
+        {
+            session->quit(false);
+            delete session;
+            continue;
+        }
+
+        return session;
+    }
+
+    return nullptr;
+}
+
+static void closeResidentJackSessions(CarlaEngine* const engine) noexcept
+{
+    LinkedList<CarlaPluginJackSession*> sessions;
+
+    {
+        const CarlaMutexLocker cml(gResidentJackSessionsMutex);
+
+        for (LinkedList<CarlaPluginJackSession*>::Itenerator it = gResidentJackSessions.begin2(); it.valid(); it.next())
+        {
+            CarlaPluginJackSession* const session(it.getValue(nullptr));
+            CARLA_SAFE_ASSERT_CONTINUE(session != nullptr);
+
+            if (session->engine != engine)
+                continue;
+
+            sessions.append(session);
+            gResidentJackSessions.remove(it);
+        }
+    }
+
+    // quitting can take a while, do it without the lock
+    for (LinkedList<CarlaPluginJackSession*>::Itenerator it = sessions.begin2(); it.valid(); it.next())
+    {
+        CarlaPluginJackSession* const session(it.getValue(nullptr));
+        CARLA_SAFE_ASSERT_CONTINUE(session != nullptr);
+
+        carla_stdout("Closing unused resident JACK application '%s'", session->filename.buffer());
+
+        session->quit(true);
+        delete session;
+    }
+
+    sessions.clear();
+}
+
 // -------------------------------------------------------------------------------------------------------------------
 
 class CarlaPluginJack : public CarlaPlugin,
                         public Announcer
 {
 public:
-    CarlaPluginJack(CarlaEngine* const engine, const uint id)
+    CarlaPluginJack(CarlaEngine* const engine, const uint id, CarlaPluginJackSession* const session)
         : CarlaPlugin(engine, id),
           fInitiated(false),
           fInitError(false),
@@ -538,16 +712,22 @@ public:
           fBufferSize(engine->getBufferSize()),
           fProcWaitTime(0),
           fSetupHints(0x0),
-          fBridgeThread(this, engine, this),
-          fShmAudioPool(),
-          fShmRtClientControl(),
-          fShmNonRtClientControl(),
-          fShmNonRtServerControl(),
+          fSession(session != nullptr ? session : new CarlaPluginJackSession(this, engine, this)),
+          fAdopted(session != nullptr),
+          fParked(false),
+          fBridgeThread(fSession->thread),
+          fShmAudioPool(fSession->shmAudioPool),
+          fShmRtClientControl(fSession->shmRtClientControl),
+          fShmNonRtClientControl(fSession->shmNonRtClientControl),
+          fShmNonRtServerControl(fSession->shmNonRtServerControl),
           fInfo()
     {
-        carla_debug("CarlaPluginJack::CarlaPluginJack(%p, %i)", engine, id);
+        carla_debug("CarlaPluginJack::CarlaPluginJack(%p, %i, %p)", engine, id, session);
 
         pData->hints |= PLUGIN_IS_BRIDGE;
+
+        if (fAdopted)
+            fBridgeThread.setOwner(this, this);
     }
 
     ~CarlaPluginJack() override
@@ -572,28 +752,27 @@ public:
             pData->active = false;
         }
 
-        if (fBridgeThread.isThreadRunning())
-        {
-            fShmRtClientControl.writeOpcode(kPluginBridgeRtClientQuit);
-            fShmRtClientControl.commitWrite();
+        // a parked application is now owned by the resident list
+        if (! fParked)
+            fSession->quit(! fTimedOut);
 
-            fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientQuit);
-            fShmNonRtClientControl.commitWrite();
+        clearBuffers();
 
-            if (! fTimedOut)
-                waitForClient("stopping", 3000);
-        }
+        fInfo.chunk.clear();
+    }
 
-        fBridgeThread.stopThread(3000);
+    // -------------------------------------------------------------------
 
-        fShmNonRtServerControl.clear();
-        fShmNonRtClientControl.clear();
-        fShmRtClientControl.clear();
-        fShmAudioPool.clear();
+    void prepareForDeletion() noexcept override
+    {
+        CarlaPlugin::prepareForDeletion();
 
-        clearBuffers();
+        if (! canBecomeResident())
+            return;
 
-        fInfo.chunk.clear();
+        try {
+            parkAsResident();
+        } CARLA_SAFE_EXCEPTION("parkAsResident");
     }
 
     // -------------------------------------------------------------------
@@ -1551,6 +1730,7 @@ public:
             case kPluginBridgeNonRtServerVersion:
             case kPluginBridgeNonRtServerRespEmbedUI:
             case kPluginBridgeNonRtServerResizeEmbedUI:
+            case kPluginBridgeNonRtServerParameterInfoDone:
                 break;
 
             case kPluginBridgeNonRtServerSetChunkDataFile:
@@ -1694,34 +1874,38 @@ public:
         // ---------------------------------------------------------------
         // init sem/shm
 
-        if (! fShmAudioPool.initializeServer())
+        // already set up if reusing a resident application
+        if (! fAdopted)
         {
-            carla_stderr("Failed to initialize shared memory audio pool");
-            return false;
-        }
+            if (! fShmAudioPool.initializeServer())
+            {
+                carla_stderr("Failed to initialize shared memory audio pool");
+                return false;
+            }
 
-        if (! fShmRtClientControl.initializeServer())
-        {
-            carla_stderr("Failed to initialize RT client control");
-            fShmAudioPool.clear();
-            return false;
-        }
+            if (! fShmRtClientControl.initializeServer())
+            {
+                carla_stderr("Failed to initialize RT client control");
+                fShmAudioPool.clear();
+                return false;
+            }
 
-        if (! fShmNonRtClientControl.initializeServer())
-        {
-            carla_stderr("Failed to initialize Non-RT client control");
-            fShmRtClientControl.clear();
-            fShmAudioPool.clear();
-            return false;
-        }
+            if (! fShmNonRtClientControl.initializeServer())
+            {
+                carla_stderr("Failed to initialize Non-RT client control");
+                fShmRtClientControl.clear();
+                fShmAudioPool.clear();
+                return false;
+            }
 
-        if (! fShmNonRtServerControl.initializeServer())
-        {
-            carla_stderr("Failed to initialize Non-RT server control");
-            fShmNonRtClientControl.clear();
-            fShmRtClientControl.clear();
-            fShmAudioPool.clear();
-            return false;
+            if (! fShmNonRtServerControl.initializeServer())
+            {
+                carla_stderr("Failed to initialize Non-RT server control");
+                fShmNonRtClientControl.clear();
+                fShmRtClientControl.clear();
+                fShmAudioPool.clear();
+                return false;
+            }
         }
 
         // ---------------------------------------------------------------
@@ -1741,6 +1925,12 @@ public:
         // ---------------------------------------------------------------
         // init bridge thread
 
+        if (fAdopted)
+        {
+            if (! resumeResidentSession())
+                return false;
+        }
+        else
         {
             char shmIdsStr[6*4+1];
             carla_zeroChars(shmIdsStr, 6*4+1);
@@ -1751,10 +1941,10 @@ public:
             std::strncpy(shmIdsStr+6*3, &fShmNonRtServerControl.filename[fShmNonRtServerControl.filename.length()-6], 6);
 
             fBridgeThread.setData(shmIdsStr, fInfo.setupLabel);
-        }
 
-        if (! restartBridgeThread())
-            return false;
+            if (! restartBridgeThread())
+                return false;
+        }
 
         // ---------------------------------------------------------------
         // register client
@@ -1813,12 +2003,16 @@ private:
     uint fProcWaitTime;
     uint fSetupHints;
 
-    CarlaPluginJackThread fBridgeThread;
+    CarlaScopedPointer<CarlaPluginJackSession> fSession;
+    const bool fAdopted;
+    bool fParked;
 
-    BridgeAudioPool          fShmAudioPool;
-    BridgeRtClientControl    fShmRtClientControl;
-    BridgeNonRtClientControl fShmNonRtClientControl;
-    BridgeNonRtServerControl fShmNonRtServerControl;
+    CarlaPluginJackThread& fBridgeThread;
+
+    BridgeAudioPool&          fShmAudioPool;
+    BridgeRtClientControl&    fShmRtClientControl;
+    BridgeNonRtClientControl& fShmNonRtClientControl;
+    BridgeNonRtServerControl& fShmNonRtServerControl;
 
     struct Info {
         uint8_t aIns, aOuts;
@@ -2036,6 +2230,86 @@ private:
         return true;
     }
 
+    bool canBecomeResident() const noexcept
+    {
+        if (! pData->engine->getOptions().residentJackApps)
+            return false;
+        if (pData->engine->isAboutToClose())
+            return false;
+        if (! fInitiated || fInitError || fTimedOut || fTimedError)
+            return false;
+        // we cannot restart an external application later on, so do not bother keeping it
+        if (fSetupHints & LIBJACK_FLAG_EXTERNAL_START)
+            return false;
+
+        return fBridgeThread.isThreadRunning();
+    }
+
+    void parkAsResident()
+    {
+        carla_stdout("Keeping JACK application '%s' resident", pData->filename);
+
+        if (pData->active)
+        {
+            deactivate();
+            pData->active = false;
+        }
+
+        if (pData->hints & PLUGIN_HAS_CUSTOM_UI)
+            showCustomUI(false);
+
+        {
+            const CarlaMutexLocker _cml(fShmNonRtClientControl.mutex);
+
+            // nobody is going to ping the application while it is parked
+            fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientPingOnOff);
+            fShmNonRtClientControl.writeBool(false);
+            fShmNonRtClientControl.commitWrite();
+        }
+
+        fBridgeThread.setOwner(nullptr, nullptr);
+
+        fSession->filename   = pData->filename;
+        fSession->setupLabel = fInfo.setupLabel;
+        fSession->sampleRate = pData->engine->getSampleRate();
+
+        fParked = true;
+        parkResidentJackSession(fSession.release());
+    }
+
+    bool resumeResidentSession()
+    {
+        carla_stdout("Reusing resident JACK application '%s'", pData->filename);
+
+        fInitiated = true;
+
+        {
+            const CarlaMutexLocker _cml(fShmNonRtClientControl.mutex);
+
+            fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientPingOnOff);
+            fShmNonRtClientControl.writeBool(true);
+            fShmNonRtClientControl.commitWrite();
+        }
+
+#ifdef HAVE_LIBLO
+        // let the application load its state for the new project
+        fBridgeThread.nsmOpen(fInfo.setupLabel);
+#endif
+
+        const double sampleRate = pData->engine->getSampleRate();
+
+        if (carla_isNotEqual(fSession->sampleRate, sampleRate))
+            sampleRateChanged(sampleRate);
+
+        if (fTimedOut)
+        {
+            pData->engine->setLastError("Timeout while waiting for a response from resident JACK application");
+            return false;
+        }
+
+        return true;
+    }
+
     void waitForClient(const char* const action, const uint msecs)
     {
         CARLA_SAFE_ASSERT_RETURN(! fTimedOut,);
@@ -2065,7 +2339,11 @@ CarlaPluginPtr CarlaPlugin::newJackApp(const Initializer& init)
                 init.engine, init.filename, init.name, init.label);
 
 #if defined(CARLA_OS_LINUX) || defined(CARLA_OS_MAC)
-    std::shared_ptr<CarlaPluginJack> plugin(new CarlaPluginJack(init.engine, init.id));
+    CarlaPluginJackSession* const session = init.engine->getOptions().residentJackApps
+                                          ? takeResidentJackSession(init.engine, init.filename, init.label)
+                                          : nullptr;
+
+    std::shared_ptr<CarlaPluginJack> plugin(new CarlaPluginJack(init.engine, init.id, session));
 
     if (! plugin->init(plugin, init.filename, init.name, init.label, init.options))
         return nullptr;
@@ -2077,6 +2355,15 @@ CarlaPluginPtr CarlaPlugin::newJackApp(const Initializer& init)
 #endif
 }
 
+void CarlaPlugin::closeResidentJackApps(CarlaEngine* const engine)
+{
+#if defined(CARLA_OS_LINUX) || defined(CARLA_OS_MAC)
+    closeResidentJackSessions(engine);
+#else
+    return; (void)engine;
+#endif
+}
+
 CARLA_BACKEND_END_NAMESPACE
 
 // -------------------------------------------------------------------------------------------------------------------
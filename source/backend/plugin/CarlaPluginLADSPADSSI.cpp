@@ -287,6 +287,85 @@ private:
 };
 #endif
 
+// -----------------------------------------------------
+// DSSI run_multiple_synths support
+//
+// A plugin providing run_multiple_synths must have all of its active instances run in a single call.
+// Plugins that also provide run_synth are run on their own instead, as the group comes at a cost.
+// All Carla plugins using the same DSSI descriptor within an engine join a shared group.
+// While only one of them is active, its instances are run immediately, as with run_synth.
+// Once several are active, each plugin stages its inputs and events for the block, and the last one
+// to do so runs the whole group. Outputs are then picked up on the following block, adding one
+// block of delay to every plugin of the group, which is reported as latency.
+
+class CarlaPluginLADSPADSSI;
+
+struct DssiMultiSynthGroup {
+    CarlaEngine* const engine;
+    const DSSI_Descriptor* const descriptor;
+
+    // protects everything below, and the staged data of all plugins in the group
+    CarlaMutex mutex;
+
+    LinkedList<CarlaPluginLADSPADSSI*> plugins;
+    uint activePlugins;
+
+    // arguments for run_multiple_synths, sized for all instances of the active plugins
+    LADSPA_Handle*    handles;
+    snd_seq_event_t** events;
+    ulong*            eventCounts;
+    uint              capacity;
+
+    DssiMultiSynthGroup(CarlaEngine* const e, const DSSI_Descriptor* const d) noexcept
+        : engine(e),
+          descriptor(d),
+          mutex(),
+          plugins(),
+          activePlugins(0),
+          handles(nullptr),
+          events(nullptr),
+          eventCounts(nullptr),
+          capacity(0) {}
+
+    ~DssiMultiSynthGroup() noexcept
+    {
+        CARLA_SAFE_ASSERT(plugins.count() == 0);
+
+        delete[] handles;
+        delete[] events;
+        delete[] eventCounts;
+    }
+
+    bool isDeferred() const noexcept
+    {
+        return activePlugins > 1;
+    }
+
+    bool tryLock() noexcept
+    {
+        if (engine->isOffline())
+        {
+            mutex.lock();
+            return true;
+        }
+
+        return mutex.tryLock();
+    }
+
+    bool isFullyStaged() const noexcept;
+    void setPluginActive(CarlaPluginLADSPADSSI* plugin, bool active) noexcept;
+    void run(uint32_t frames) noexcept;
+
+    static DssiMultiSynthGroup* join(CarlaEngine* engine, const DSSI_Descriptor* descriptor,
+                                     CarlaPluginLADSPADSSI* plugin) noexcept;
+    static void leave(DssiMultiSynthGroup* group, CarlaPluginLADSPADSSI* plugin) noexcept;
+
+    CARLA_DECLARE_NON_COPYABLE(DssiMultiSynthGroup)
+};
+
+static CarlaMutex gDssiMultiSynthGroupsMutex;
+static LinkedList<DssiMultiSynthGroup*> gDssiMultiSynthGroups;
+
 // -----------------------------------------------------
 
 class CarlaPluginLADSPADSSI : public CarlaPlugin
@@ -302,9 +381,19 @@ public:
           fAudioOutBuffers(nullptr),
           fExtraStereoBuffer(),
           fParamBuffers(nullptr),
+          fSharedParamBuffers(nullptr),
+          fMidiEvents(),
+          fLastMidiEventCount(0),
+          fMultiSynthGroup(nullptr),
+          fMultiSynthInBuffers(nullptr),
+          fMultiSynthEvents(),
+          fMultiSynthEventCount(0),
+          fMultiSynthActive(false),
+          fMultiSynthStaged(false),
           fLatencyIndex(-1),
           fForcedStereoIn(false),
           fForcedStereoOut(false),
+          fForcedStereoShared(false),
           fNeedsFixedBuffers(false),
           fUsesCustomData(false)
 #if defined(HAVE_LIBLO) && !defined(BUILD_BRIDGE)
@@ -345,6 +434,12 @@ public:
             pData->active = false;
         }
 
+        if (fMultiSynthGroup != nullptr)
+        {
+            DssiMultiSynthGroup::leave(fMultiSynthGroup, this);
+            fMultiSynthGroup = nullptr;
+        }
+
         if (fDescriptor != nullptr)
         {
             if (fDescriptor->cleanup != nullptr)
@@ -371,6 +466,9 @@ public:
             fRdfDescriptor = nullptr;
         }
 
+        fMidiEvents.clear();
+        fMultiSynthEvents.clear();
+
         clearBuffers();
     }
 
@@ -417,7 +515,7 @@ public:
                 return PLUGIN_CATEGORY_SYNTH;
         }
 
-        if (fDssiDescriptor != nullptr && fDssiDescriptor->run_synth != nullptr)
+        if (isDssiSynth())
             if (pData->audioIn.count == 0 && pData->audioOut.count > 0)
                 return PLUGIN_CATEGORY_SYNTH;
 
@@ -433,13 +531,24 @@ public:
 
     uint32_t getLatencyInFrames() const noexcept override
     {
+        // outputs of a deferred group are picked up one block later
+        const uint32_t groupLatency = fMultiSynthGroup != nullptr && fMultiSynthGroup->isDeferred()
+                                    ? pData->engine->getBufferSize()
+                                    : 0;
+
         if (fLatencyIndex < 0 || fParamBuffers == nullptr)
-            return 0;
+            return groupLatency;
 
         const float latency(fParamBuffers[fLatencyIndex]);
-        CARLA_SAFE_ASSERT_RETURN(latency >= 0.0f, 0);
+        CARLA_SAFE_ASSERT_RETURN(latency >= 0.0f, groupLatency);
 
-        return static_cast<uint32_t>(latency);
+        return static_cast<uint32_t>(latency) + groupLatency;
+    }
+
+    bool isProcessStateShared() const noexcept override
+    {
+        // any member of the group can run the whole group
+        return fMultiSynthGroup != nullptr;
     }
 
     // -------------------------------------------------------------------
@@ -504,6 +613,13 @@ public:
         else if (pData->audioIn.count == 1 || pData->audioOut.count == 1 || fForcedStereoIn || fForcedStereoOut)
             options |= PLUGIN_OPTION_FORCE_STEREO;
 
+        // single instance processing is only possible for plain mono effects without internal state
+        if (fMultiSynthGroup == nullptr && ! isDssiSynth() && isKnownStateless())
+        {
+            if ((pData->audioIn.count == 1 && pData->audioOut.count == 1) || (fForcedStereoIn && fForcedStereoOut))
+                options |= PLUGIN_OPTION_FORCE_STEREO_SINGLE_INSTANCE;
+        }
+
         if (fDssiDescriptor != nullptr)
         {
             if (fDssiDescriptor->get_program != nullptr && fDssiDescriptor->select_program != nullptr)
@@ -512,7 +628,7 @@ public:
             if (fUsesCustomData)
                 options |= PLUGIN_OPTION_USE_CHUNKS;
 
-            if (fDssiDescriptor->run_synth != nullptr)
+            if (isDssiSynth())
             {
                 options |= PLUGIN_OPTION_SEND_CONTROL_CHANGES;
                 options |= PLUGIN_OPTION_SEND_CHANNEL_PRESSURE;
@@ -728,6 +844,7 @@ public:
 
         const float fixedValue(pData->param.getFixedValue(parameterId, value));
         fParamBuffers[parameterId] = fixedValue;
+        pData->paramSmoother.cancel(parameterId, fixedValue);
 
         CarlaPlugin::setParameterValue(parameterId, fixedValue, sendGui, sendOsc, sendCallback);
     }
@@ -739,10 +856,25 @@ public:
 
         const float fixedValue(pData->param.getFixedValue(parameterId, value));
         fParamBuffers[parameterId] = fixedValue;
+        pData->paramSmoother.cancel(parameterId, fixedValue);
 
         CarlaPlugin::setParameterValueRT(parameterId, fixedValue, frameOffset, sendCallbackLater);
     }
 
+    // automation and MIDI CC changes, ramped if parameter smoothing is enabled
+    void setParameterValueSmoothedRT(const uint32_t parameterId, const float value, const uint32_t frameOffset) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fParamBuffers != nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(parameterId < pData->param.count,);
+
+        const float fixedValue(pData->param.getFixedValue(parameterId, value));
+
+        if (! pData->paramSmoother.setTarget(parameterId, fixedValue))
+            fParamBuffers[parameterId] = fixedValue;
+
+        CarlaPlugin::setParameterValueRT(parameterId, fixedValue, frameOffset, true);
+    }
+
     void setCustomData(const char* const type, const char* const key, const char* const value, const bool sendGui) override
     {
         CARLA_SAFE_ASSERT_RETURN(fDssiDescriptor != nullptr,);
@@ -854,6 +986,9 @@ public:
                 fDssiDescriptor->select_program(handle, bank, program);
             } CARLA_SAFE_EXCEPTION("LADSPA/DSSI setMidiProgram")
         }
+
+        // programs set their own port values
+        pData->paramSmoother.cancelAll();
     }
 
 #if defined(HAVE_LIBLO) && !defined(BUILD_BRIDGE)
@@ -894,6 +1029,19 @@ public:
     // -------------------------------------------------------------------
     // Plugin state
 
+    void idle() override
+    {
+        if (fMidiEvents.needsMoreSpace)
+        {
+            const CarlaMutexLocker cml(pData->masterMutex);
+
+            if (! resizeMidiEvents(fMidiEvents.capacity*2))
+                carla_stderr2("CarlaPluginLADSPADSSI::idle() - failed to grow MIDI event storage");
+        }
+
+        CarlaPlugin::idle();
+    }
+
     void reload() override
     {
         CARLA_SAFE_ASSERT_RETURN(pData->engine != nullptr,);
@@ -917,8 +1065,8 @@ public:
         uint32_t aIns, aOuts, mIns, params;
         aIns = aOuts = mIns = params = 0;
 
-        bool forcedStereoIn, forcedStereoOut;
-        forcedStereoIn = forcedStereoOut = false;
+        bool forcedStereoIn, forcedStereoOut, forcedStereoShared;
+        forcedStereoIn = forcedStereoOut = forcedStereoShared = false;
 
         bool needsCtrlIn, needsCtrlOut;
         needsCtrlIn = needsCtrlOut = false;
@@ -940,8 +1088,23 @@ public:
 
         if (pData->options & PLUGIN_OPTION_FORCE_STEREO)
         {
-            if ((aIns == 1 || aOuts == 1) && fHandles.count() == 1 && addInstance())
+            // instances run together cannot share the output buffers needed for mono input and stereo output
+            const bool canForceStereo = fMultiSynthGroup == nullptr || aOuts <= 1;
+
+            // mono effects can run each channel in turn through the same instance, if requested
+            const bool canShareInstance = aIns == 1 && aOuts == 1 && fMultiSynthGroup == nullptr && ! isDssiSynth()
+                                       && (pData->options & PLUGIN_OPTION_FORCE_STEREO_SINGLE_INSTANCE) != 0
+                                       && isKnownStateless();
+
+            // release the second instance from a previous reload
+            if (canShareInstance)
+                removeExtraInstances();
+
+            if ((aIns == 1 || aOuts == 1) && canForceStereo
+                && (canShareInstance || (fHandles.count() == 1 && addInstance())))
             {
+                forcedStereoShared = canShareInstance;
+
                 if (aIns == 1)
                 {
                     aIns = 2;
@@ -955,7 +1118,7 @@ public:
             }
         }
 
-        if (fDssiDescriptor != nullptr && fDssiDescriptor->run_synth != nullptr)
+        if (isDssiSynth())
         {
             mIns = 1;
             needsCtrlIn = true;
@@ -968,6 +1131,14 @@ public:
 
             for (uint32_t i=0; i < aIns; ++i)
                 fAudioInBuffers[i] = nullptr;
+
+            if (fMultiSynthGroup != nullptr)
+            {
+                fMultiSynthInBuffers = new float*[aIns];
+
+                for (uint32_t i=0; i < aIns; ++i)
+                    fMultiSynthInBuffers[i] = nullptr;
+            }
         }
 
         if (aOuts > 0)
@@ -986,6 +1157,12 @@ public:
 
             fParamBuffers = new float[params];
             carla_zeroFloats(fParamBuffers, params);
+
+            if (forcedStereoShared)
+            {
+                fSharedParamBuffers = new float[params];
+                carla_zeroFloats(fSharedParamBuffers, params);
+            }
         }
 
         const uint portNameSize(pData->engine->getMaxPortNameSize());
@@ -1297,8 +1474,16 @@ public:
         // check initial latency
         findInitialLatencyValue(aIns, aOuts);
 
-        fForcedStereoIn  = forcedStereoIn;
-        fForcedStereoOut = forcedStereoOut;
+        fForcedStereoIn     = forcedStereoIn;
+        fForcedStereoOut    = forcedStereoOut;
+        fForcedStereoShared = forcedStereoShared;
+
+        if (const uint smoothingTime = pData->engine->getOptions().parameterSmoothingTime)
+            pData->paramSmoother.createNew(pData->param, fParamBuffers,
+                                           static_cast<uint32_t>(smoothingTime * sampleRate / 1000.0f));
+
+        if (! resizeMidiEvents(kMaxEngineEventInternalCount))
+            carla_stderr2("CarlaPluginLADSPADSSI::reload() - failed to allocate MIDI event storage");
 
         bufferSizeChanged(pData->engine->getBufferSize());
         reloadPrograms(true);
@@ -1314,6 +1499,10 @@ public:
         if (fLatencyIndex < 0 || fHandles.count() == 0)
             return;
 
+        // cannot run a single instance on its own without run()
+        if (fDescriptor->run == nullptr)
+            return;
+
         // we need to pre-run the plugin so it can update its latency control-port
         const LADSPA_Handle handle(fHandles.getFirst(nullptr));
         CARLA_SAFE_ASSERT_RETURN(handle != nullptr,);
@@ -1477,12 +1666,18 @@ public:
                 } CARLA_SAFE_EXCEPTION("LADSPA/DSSI activate");
             }
         }
+
+        if (fMultiSynthGroup != nullptr)
+            fMultiSynthGroup->setPluginActive(this, true);
     }
 
     void deactivate() noexcept override
     {
         CARLA_SAFE_ASSERT_RETURN(fDescriptor != nullptr,);
 
+        if (fMultiSynthGroup != nullptr)
+            fMultiSynthGroup->setPluginActive(this, false);
+
         if (fDescriptor->deactivate != nullptr)
         {
             for (LinkedList<LADSPA_Handle>::Itenerator it = fHandles.begin2(); it.valid(); it.next())
@@ -1512,38 +1707,38 @@ public:
             return;
         }
 
+        fMidiEvents.clearUsed(fLastMidiEventCount);
         ulong midiEventCount = 0;
-        carla_zeroStructs(fMidiEvents, kPluginMaxMidiEvents);
 
         // --------------------------------------------------------------------------------------------------------
         // Check if needs reset
 
         if (pData->needsReset)
         {
-            if (pData->options & PLUGIN_OPTION_SEND_ALL_SOUND_OFF)
+            if ((pData->options & PLUGIN_OPTION_SEND_ALL_SOUND_OFF) && fMidiEvents.hasSpaceFor(0, MAX_MIDI_CHANNELS*2))
             {
                 midiEventCount = MAX_MIDI_CHANNELS*2;
 
                 for (uchar i=0, k=MAX_MIDI_CHANNELS; i < MAX_MIDI_CHANNELS; ++i)
                 {
-                    fMidiEvents[i].type = SND_SEQ_EVENT_CONTROLLER;
-                    fMidiEvents[i].data.control.channel = i;
-                    fMidiEvents[i].data.control.param   = MIDI_CONTROL_ALL_NOTES_OFF;
+                    fMidiEvents.data[i].type = SND_SEQ_EVENT_CONTROLLER;
+                    fMidiEvents.data[i].data.control.channel = i;
+                    fMidiEvents.data[i].data.control.param   = MIDI_CONTROL_ALL_NOTES_OFF;
 
-                    fMidiEvents[k+i].type = SND_SEQ_EVENT_CONTROLLER;
-                    fMidiEvents[k+i].data.control.channel = i;
-                    fMidiEvents[k+i].data.control.param   = MIDI_CONTROL_ALL_SOUND_OFF;
+                    fMidiEvents.data[k+i].type = SND_SEQ_EVENT_CONTROLLER;
+                    fMidiEvents.data[k+i].data.control.channel = i;
+                    fMidiEvents.data[k+i].data.control.param   = MIDI_CONTROL_ALL_SOUND_OFF;
                 }
             }
-            else if (pData->ctrlChannel >= 0 && pData->ctrlChannel < MAX_MIDI_CHANNELS)
+            else if (pData->ctrlChannel >= 0 && pData->ctrlChannel < MAX_MIDI_CHANNELS && fMidiEvents.hasSpaceFor(0, MAX_MIDI_NOTE))
             {
                 midiEventCount = MAX_MIDI_NOTE;
 
                 for (uchar i=0; i < MAX_MIDI_NOTE; ++i)
                 {
-                    fMidiEvents[i].type = SND_SEQ_EVENT_NOTEOFF;
-                    fMidiEvents[i].data.note.channel = static_cast<uchar>(pData->ctrlChannel);
-                    fMidiEvents[i].data.note.note    = i;
+                    fMidiEvents.data[i].type = SND_SEQ_EVENT_NOTEOFF;
+                    fMidiEvents.data[i].data.note.channel = static_cast<uchar>(pData->ctrlChannel);
+                    fMidiEvents.data[i].data.note.note    = i;
                 }
             }
 
@@ -1562,12 +1757,12 @@ public:
             {
                 ExternalMidiNote note = { 0, 0, 0 };
 
-                for (; midiEventCount < kPluginMaxMidiEvents && ! pData->extNotes.data.isEmpty();)
+                for (; fMidiEvents.hasSpaceFor(static_cast<uint32_t>(midiEventCount)) && ! pData->extNotes.data.isEmpty();)
                 {
                     note = pData->extNotes.data.getFirst(note, true);
                     CARLA_SAFE_ASSERT_CONTINUE(note.channel >= 0 && note.channel < MAX_MIDI_CHANNELS);
 
-                    snd_seq_event_t& seqEvent(fMidiEvents[midiEventCount++]);
+                    snd_seq_event_t& seqEvent(fMidiEvents.data[midiEventCount++]);
 
                     seqEvent.type               = (note.velo > 0) ? SND_SEQ_EVENT_NOTEON : SND_SEQ_EVENT_NOTEOFF;
                     seqEvent.data.note.channel  = static_cast<uchar>(note.channel);
@@ -1585,7 +1780,9 @@ public:
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
             bool allNotesOffSent = false;
 #endif
-            const bool isSampleAccurate = (pData->options & PLUGIN_OPTION_FIXED_BUFFERS) == 0;
+            // instances run together must all get the same block, events are still sent with their frame offset
+            const bool isSampleAccurate = (pData->options & PLUGIN_OPTION_FIXED_BUFFERS) == 0
+                                       && fMultiSynthGroup == nullptr;
 
             uint32_t startTime  = 0;
             uint32_t timeOffset = 0;
@@ -1615,13 +1812,19 @@ public:
                     eventTime = timeOffset;
                 }
 
-                if (isSampleAccurate && eventTime > timeOffset)
+                // changes to smoothed parameters are ramped from the current position instead of splitting the block
+                if (isSampleAccurate && eventTime > timeOffset && ! pData->isSmoothedParameterEvent(event))
                 {
-                    if (processSingle(audioIn, audioOut, eventTime - timeOffset, timeOffset, midiEventCount))
+                    if (processSmoothed(audioIn, audioOut, eventTime - timeOffset, timeOffset, midiEventCount))
                     {
                         startTime  = 0;
                         timeOffset = eventTime;
-                        midiEventCount = 0;
+
+                        if (midiEventCount > 0)
+                        {
+                            carla_zeroStructs(fMidiEvents.data, midiEventCount);
+                            midiEventCount = 0;
+                        }
 
                         if (pData->midiprog.current >= 0 && pData->midiprog.count > 0)
                             nextBankId = pData->midiprog.data[pData->midiprog.current].bank;
@@ -1657,7 +1860,7 @@ public:
 
                             ctrlEvent.handled = true;
                             value = pData->param.getFinalUnnormalizedValue(k, ctrlEvent.normalizedValue);
-                            setParameterValueRT(k, value, event.time, true);
+                            setParameterValueSmoothedRT(k, value, event.time);
                             continue;
                         }
 
@@ -1704,28 +1907,20 @@ public:
                         }
 #endif
                         // Control plugin parameters
-                        for (uint32_t k=0; k < pData->param.count; ++k)
+                        for (uint32_t k = pData->param.getFirstMappedParameter(event.channel, ctrlEvent.param);
+                             k < pData->param.count; k = pData->param.getNextMappedParameter(k))
                         {
-                            if (pData->param.data[k].midiChannel != event.channel)
-                                continue;
-                            if (pData->param.data[k].mappedControlIndex != ctrlEvent.param)
-                                continue;
-                            if (pData->param.data[k].type != PARAMETER_INPUT)
-                                continue;
-                            if ((pData->param.data[k].hints & PARAMETER_IS_AUTOMATABLE) == 0)
-                                continue;
-
                             ctrlEvent.handled = true;
                             value = pData->param.getFinalUnnormalizedValue(k, ctrlEvent.normalizedValue);
-                            setParameterValueRT(k, value, event.time, true);
+                            setParameterValueSmoothedRT(k, value, event.time);
                         }
 
                         if ((pData->options & PLUGIN_OPTION_SEND_CONTROL_CHANGES) != 0 && ctrlEvent.param < MAX_MIDI_VALUE)
                         {
-                            if (midiEventCount >= kPluginMaxMidiEvents)
+                            if (! fMidiEvents.hasSpaceFor(static_cast<uint32_t>(midiEventCount)))
                                 continue;
 
-                            snd_seq_event_t& seqEvent(fMidiEvents[midiEventCount++]);
+                            snd_seq_event_t& seqEvent(fMidiEvents.data[midiEventCount++]);
 
                             seqEvent.time.tick = isSampleAccurate ? startTime : eventTime;
 
@@ -1766,10 +1961,10 @@ public:
                     case kEngineControlEventTypeAllSoundOff:
                         if (pData->options & PLUGIN_OPTION_SEND_ALL_SOUND_OFF)
                         {
-                            if (midiEventCount >= kPluginMaxMidiEvents)
+                            if (! fMidiEvents.hasSpaceFor(static_cast<uint32_t>(midiEventCount)))
                                 continue;
 
-                            snd_seq_event_t& seqEvent(fMidiEvents[midiEventCount++]);
+                            snd_seq_event_t& seqEvent(fMidiEvents.data[midiEventCount++]);
 
                             seqEvent.time.tick = isSampleAccurate ? startTime : eventTime;
 
@@ -1790,10 +1985,10 @@ public:
                             }
 #endif
 
-                            if (midiEventCount >= kPluginMaxMidiEvents)
+                            if (! fMidiEvents.hasSpaceFor(static_cast<uint32_t>(midiEventCount)))
                                 continue;
 
-                            snd_seq_event_t& seqEvent(fMidiEvents[midiEventCount++]);
+                            snd_seq_event_t& seqEvent(fMidiEvents.data[midiEventCount++]);
 
                             seqEvent.time.tick = isSampleAccurate ? startTime : eventTime;
 
@@ -1807,7 +2002,7 @@ public:
                 } // case kEngineEventTypeControl
 
                 case kEngineEventTypeMidi: {
-                    if (midiEventCount >= kPluginMaxMidiEvents)
+                    if (! fMidiEvents.hasSpaceFor(static_cast<uint32_t>(midiEventCount)))
                         continue;
 
                     const EngineMidiEvent& midiEvent(event.midi);
@@ -1821,7 +2016,7 @@ public:
                     if (status == MIDI_STATUS_NOTE_ON && midiEvent.data[2] == 0)
                         status = MIDI_STATUS_NOTE_OFF;
 
-                    snd_seq_event_t& seqEvent(fMidiEvents[midiEventCount++]);
+                    snd_seq_event_t& seqEvent(fMidiEvents.data[midiEventCount++]);
 
                     seqEvent.time.tick = isSampleAccurate ? startTime : eventTime;
 
@@ -1905,7 +2100,7 @@ public:
                         break;
 
                     default:
-                        --midiEventCount;
+                        carla_zeroStruct(fMidiEvents.data[--midiEventCount]);
                         break;
                     } // switch (status)
                 } break;
@@ -1915,7 +2110,7 @@ public:
             pData->postRtEvents.trySplice();
 
             if (frames > timeOffset)
-                processSingle(audioIn, audioOut, frames - timeOffset, timeOffset, midiEventCount);
+                processSmoothed(audioIn, audioOut, frames - timeOffset, timeOffset, midiEventCount);
 
         } // End of Event Input and Processing
 
@@ -1924,10 +2119,12 @@ public:
 
         else
         {
-            processSingle(audioIn, audioOut, frames, 0, midiEventCount);
+            processSmoothed(audioIn, audioOut, frames, 0, midiEventCount);
 
         } // End of Plugin processing (no events)
 
+        fLastMidiEventCount = static_cast<uint32_t>(midiEventCount);
+
         // --------------------------------------------------------------------------------------------------------
         // Control Output
 
@@ -1963,6 +2160,33 @@ public:
 #endif
     }
 
+    bool processSmoothed(const float* const* const audioIn, float** const audioOut, const uint32_t frames,
+                         const uint32_t timeOffset, const ulong midiEventCount)
+    {
+        PluginParameterSmoother& smoother(pData->paramSmoother);
+
+        // ramps advance at a fixed control rate, which needs the block to be split without moving any events
+        if (smoother.isRamping() && midiEventCount == 0
+            && (pData->options & PLUGIN_OPTION_FIXED_BUFFERS) == 0 && fMultiSynthGroup == nullptr)
+        {
+            const uint32_t quantum = PluginParameterSmoother::kQuantum;
+            uint32_t offset = 0;
+            bool ok = true;
+
+            for (; frames - offset > quantum && smoother.isRamping(); offset += quantum)
+            {
+                smoother.advance(quantum);
+                ok = processSingle(audioIn, audioOut, quantum, timeOffset + offset, 0) && ok;
+            }
+
+            smoother.advance(frames - offset);
+            return processSingle(audioIn, audioOut, frames - offset, timeOffset + offset, 0) && ok;
+        }
+
+        smoother.advance(frames);
+        return processSingle(audioIn, audioOut, frames, timeOffset, midiEventCount);
+    }
+
     bool processSingle(const float* const* const audioIn, float** const audioOut, const uint32_t frames,
                        const uint32_t timeOffset, const ulong midiEventCount)
     {
@@ -1998,65 +2222,127 @@ public:
             return false;
         }
 
+        if (fMultiSynthGroup != nullptr && ! fMultiSynthGroup->tryLock())
+        {
+            for (uint32_t i=0; i < pData->audioOut.count; ++i)
+            {
+                for (uint32_t k=0; k < frames; ++k)
+                    audioOut[i][k+timeOffset] = 0.0f;
+            }
+
+            pData->singleMutex.unlock();
+            return false;
+        }
+
+        const bool multiSynthDeferred = fMultiSynthGroup != nullptr && fMultiSynthGroup->isDeferred();
+
         // --------------------------------------------------------------------------------------------------------
         // Set audio buffers
 
         const bool customMonoOut   = pData->audioOut.count == 2 && fForcedStereoOut && ! fForcedStereoIn;
         const bool customStereoOut = pData->audioOut.count == 2 && fForcedStereoIn  && ! fForcedStereoOut;
 
-        if (! customMonoOut)
+        if (multiSynthDeferred)
         {
-            for (uint32_t i=0; i < pData->audioOut.count; ++i)
-                carla_zeroFloats(fAudioOutBuffers[i], frames);
+            // buffers already hold the result of the previous block, unless the group did not run since then
+            if (fMultiSynthStaged)
+                fMultiSynthGroup->run(frames);
         }
+        else
+        {
+            if (! customMonoOut)
+            {
+                for (uint32_t i=0; i < pData->audioOut.count; ++i)
+                    carla_zeroFloats(fAudioOutBuffers[i], frames);
+            }
 
-        for (uint32_t i=0; i < pData->audioIn.count; ++i)
-            carla_copyFloats(fAudioInBuffers[i], audioIn[i]+timeOffset, frames);
+            for (uint32_t i=0; i < pData->audioIn.count; ++i)
+                carla_copyFloats(fAudioInBuffers[i], audioIn[i]+timeOffset, frames);
+        }
 
         // --------------------------------------------------------------------------------------------------------
         // Run plugin
 
-        uint instn = 0;
-        for (LinkedList<LADSPA_Handle>::Itenerator it = fHandles.begin2(); it.valid(); it.next(), ++instn)
+        if (fMultiSynthGroup != nullptr)
         {
-            LADSPA_Handle const handle(it.getValue(nullptr));
-            CARLA_SAFE_ASSERT_CONTINUE(handle != nullptr);
-
-            // ----------------------------------------------------------------------------------------------------
-            // Mixdown for forced stereo
-
-            if (customMonoOut)
-                carla_zeroFloats(fAudioOutBuffers[instn], frames);
-
-            // ----------------------------------------------------------------------------------------------------
-            // Run it
-
-            if (fDssiDescriptor != nullptr && fDssiDescriptor->run_synth != nullptr)
+            if (! multiSynthDeferred)
             {
-                try {
-                    fDssiDescriptor->run_synth(handle, frames, fMidiEvents, midiEventCount);
-                } CARLA_SAFE_EXCEPTION("LADSPA/DSSI run_synth");
+                fMultiSynthEventCount = midiEventCount;
+                fMultiSynthGroup->run(frames);
             }
-            else
+        }
+        else if (fForcedStereoShared)
+        {
+            LADSPA_Handle const handle(fHandles.getFirst(nullptr));
+            CARLA_SAFE_ASSERT(handle != nullptr);
+
+            // run each channel in turn, reconnecting the audio ports in between
+            for (uint32_t c=0; c < 2 && handle != nullptr; ++c)
             {
                 try {
+                    fDescriptor->connect_port(handle, pData->audioIn.ports[c].rindex, fAudioInBuffers[c]);
+                    fDescriptor->connect_port(handle, pData->audioOut.ports[c].rindex, fAudioOutBuffers[c]);
                     fDescriptor->run(handle, frames);
-                } CARLA_SAFE_EXCEPTION("LADSPA/DSSI run");
-            }
+                } CARLA_SAFE_EXCEPTION("LADSPA/DSSI run (single instance forced stereo)");
 
-            // ----------------------------------------------------------------------------------------------------
-            // Mixdown for forced stereo
+                // output parameters report the first channel, like with 2 instances
+                if (c == 0 && fSharedParamBuffers != nullptr)
+                    carla_copyFloats(fSharedParamBuffers, fParamBuffers, pData->param.count);
+            }
 
-            if (customMonoOut)
-                carla_multiply(fAudioOutBuffers[instn], 0.5f, frames);
-            else if (customStereoOut)
-                carla_copyFloats(fExtraStereoBuffer[instn], fAudioOutBuffers[instn], frames);
+            if (fSharedParamBuffers != nullptr)
+            {
+                for (uint32_t k=0; k < pData->param.count; ++k)
+                {
+                    if (pData->param.data[k].type == PARAMETER_OUTPUT)
+                        fParamBuffers[k] = fSharedParamBuffers[k];
+                }
+            }
         }
-
-        if (customStereoOut)
+        else
         {
-            carla_copyFloats(fAudioOutBuffers[0], fExtraStereoBuffer[0], frames);
-            carla_copyFloats(fAudioOutBuffers[1], fExtraStereoBuffer[1], frames);
+            uint instn = 0;
+            for (LinkedList<LADSPA_Handle>::Itenerator it = fHandles.begin2(); it.valid(); it.next(), ++instn)
+            {
+                LADSPA_Handle const handle(it.getValue(nullptr));
+                CARLA_SAFE_ASSERT_CONTINUE(handle != nullptr);
+
+                // ------------------------------------------------------------------------------------------------
+                // Mixdown for forced stereo
+
+                if (customMonoOut)
+                    carla_zeroFloats(fAudioOutBuffers[instn], frames);
+
+                // ------------------------------------------------------------------------------------------------
+                // Run it
+
+                if (fDssiDescriptor != nullptr && fDssiDescriptor->run_synth != nullptr)
+                {
+                    try {
+                        fDssiDescriptor->run_synth(handle, frames, fMidiEvents.data, midiEventCount);
+                    } CARLA_SAFE_EXCEPTION("LADSPA/DSSI run_synth");
+                }
+                else
+                {
+                    try {
+                        fDescriptor->run(handle, frames);
+                    } CARLA_SAFE_EXCEPTION("LADSPA/DSSI run");
+                }
+
+                // ------------------------------------------------------------------------------------------------
+                // Mixdown for forced stereo
+
+                if (customMonoOut)
+                    carla_multiply(fAudioOutBuffers[instn], 0.5f, frames);
+                else if (customStereoOut)
+                    carla_copyFloats(fExtraStereoBuffer[instn], fAudioOutBuffers[instn], frames);
+            }
+
+            if (customStereoOut)
+            {
+                carla_copyFloats(fAudioOutBuffers[0], fExtraStereoBuffer[0], frames);
+                carla_copyFloats(fAudioOutBuffers[1], fExtraStereoBuffer[1], frames);
+            }
         }
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
@@ -2172,6 +2458,28 @@ public:
         }
 #endif
 
+        // --------------------------------------------------------------------------------------------------------
+        // Stage data for the next shared run
+
+        if (fMultiSynthGroup != nullptr)
+        {
+            if (multiSynthDeferred)
+            {
+                for (uint32_t i=0; i < pData->audioIn.count; ++i)
+                    carla_copyFloats(fMultiSynthInBuffers[i], audioIn[i]+timeOffset, frames);
+
+                if (midiEventCount > 0)
+                    carla_copyStructs(fMultiSynthEvents.data, fMidiEvents.data, midiEventCount);
+                fMultiSynthEventCount = midiEventCount;
+                fMultiSynthStaged = true;
+
+                if (fMultiSynthGroup->isFullyStaged())
+                    fMultiSynthGroup->run(frames);
+            }
+
+            fMultiSynthGroup->mutex.unlock();
+        }
+
         // --------------------------------------------------------------------------------------------------------
 
         pData->singleMutex.unlock();
@@ -2190,6 +2498,15 @@ public:
 
             fAudioInBuffers[i] = new float[newBufferSize];
             carla_zeroFloats(fAudioInBuffers[i], newBufferSize);
+
+            if (fMultiSynthInBuffers != nullptr)
+            {
+                if (fMultiSynthInBuffers[i] != nullptr)
+                    delete[] fMultiSynthInBuffers[i];
+
+                fMultiSynthInBuffers[i] = new float[newBufferSize];
+                carla_zeroFloats(fMultiSynthInBuffers[i], newBufferSize);
+            }
         }
 
         for (uint32_t i=0; i < pData->audioOut.count; ++i)
@@ -2266,6 +2583,19 @@ public:
 
     void reconnectAudioPorts() const noexcept
     {
+        if (fForcedStereoShared)
+        {
+            // process() connects each channel in turn before running
+            if (LADSPA_Handle const handle = fHandles.getFirst(nullptr))
+            {
+                try {
+                    fDescriptor->connect_port(handle, pData->audioIn.ports[0].rindex, fAudioInBuffers[0]);
+                    fDescriptor->connect_port(handle, pData->audioOut.ports[0].rindex, fAudioOutBuffers[0]);
+                } CARLA_SAFE_EXCEPTION("LADSPA/DSSI connect_port (single instance forced stereo)");
+            }
+            return;
+        }
+
         if (fForcedStereoIn)
         {
             if (LADSPA_Handle const handle = fHandles.getFirst(nullptr))
@@ -2353,6 +2683,21 @@ public:
             fAudioInBuffers = nullptr;
         }
 
+        if (fMultiSynthInBuffers != nullptr)
+        {
+            for (uint32_t i=0; i < pData->audioIn.count; ++i)
+            {
+                if (fMultiSynthInBuffers[i] != nullptr)
+                {
+                    delete[] fMultiSynthInBuffers[i];
+                    fMultiSynthInBuffers[i] = nullptr;
+                }
+            }
+
+            delete[] fMultiSynthInBuffers;
+            fMultiSynthInBuffers = nullptr;
+        }
+
         if (fAudioOutBuffers != nullptr)
         {
             for (uint32_t i=0; i < pData->audioOut.count; ++i)
@@ -2386,6 +2731,12 @@ public:
             fParamBuffers = nullptr;
         }
 
+        if (fSharedParamBuffers != nullptr)
+        {
+            delete[] fSharedParamBuffers;
+            fSharedParamBuffers = nullptr;
+        }
+
         CarlaPlugin::clearBuffers();
 
         carla_debug("CarlaPluginLADSPADSSI::clearBuffers() - end");
@@ -2850,7 +3201,7 @@ public:
                 fDssiDescriptor = nullptr;
                 break;
             }
-            if (fDescriptor->run == nullptr)
+            if (fDescriptor->run == nullptr && fDssiDescriptor->run_multiple_synths == nullptr)
             {
                 carla_stderr2("WARNING - Plugin has no run, cannot use it");
                 fDescriptor     = nullptr;
@@ -2868,15 +3219,6 @@ public:
             return false;
         }
 
-        // ---------------------------------------------------------------
-        // check if uses global instance
-
-        if (fDssiDescriptor->run_synth == nullptr && fDssiDescriptor->run_multiple_synths != nullptr)
-        {
-            pData->engine->setLastError("This plugin requires run_multiple_synths which is not supported");
-            return false;
-        }
-
         return init2(plugin, filename, name, options, nullptr);
     }
 
@@ -2932,6 +3274,21 @@ public:
         if (! addInstance())
             return false;
 
+        // ---------------------------------------------------------------
+        // join other instances of the same plugin, if it can only run them together
+
+        if (fDssiDescriptor != nullptr && fDssiDescriptor->run_synth == nullptr
+            && fDssiDescriptor->run_multiple_synths != nullptr)
+        {
+            fMultiSynthGroup = DssiMultiSynthGroup::join(pData->engine, fDssiDescriptor, this);
+
+            if (fMultiSynthGroup == nullptr)
+            {
+                pData->engine->setLastError("Out of memory");
+                return false;
+            }
+        }
+
         // ---------------------------------------------------------------
         // find latency port index
 
@@ -3020,6 +3377,9 @@ public:
         else if (options & PLUGIN_OPTION_FORCE_STEREO)
             pData->options |= PLUGIN_OPTION_FORCE_STEREO;
 
+        if (options & PLUGIN_OPTION_FORCE_STEREO_SINGLE_INSTANCE)
+            pData->options |= PLUGIN_OPTION_FORCE_STEREO_SINGLE_INSTANCE;
+
         if (fDssiDescriptor != nullptr)
         {
             if (fDssiDescriptor->get_program != nullptr && fDssiDescriptor->select_program != nullptr)
@@ -3030,7 +3390,7 @@ public:
                 if (isPluginOptionEnabled(options, PLUGIN_OPTION_USE_CHUNKS))
                     pData->options |= PLUGIN_OPTION_USE_CHUNKS;
 
-            if (fDssiDescriptor->run_synth != nullptr)
+            if (isDssiSynth())
             {
                 if (isPluginOptionEnabled(options, PLUGIN_OPTION_SEND_CONTROL_CHANGES))
                     pData->options |= PLUGIN_OPTION_SEND_CONTROL_CHANGES;
@@ -3053,6 +3413,31 @@ public:
     // -------------------------------------------------------------------
 
 private:
+    // needs the plugin to be disabled, or its master mutex locked
+    bool resizeMidiEvents(const uint32_t capacity) noexcept
+    {
+        // staged events are read by whichever plugin of the group runs it
+        if (fMultiSynthGroup != nullptr && capacity > fMultiSynthEvents.capacity)
+        {
+            const CarlaMutexLocker cml(fMultiSynthGroup->mutex);
+
+            if (! fMultiSynthEvents.resize(capacity))
+                return false;
+
+            fMultiSynthEventCount = 0;
+        }
+
+        const uint32_t oldCapacity = fMidiEvents.capacity;
+
+        if (! fMidiEvents.resize(capacity))
+            return false;
+
+        if (fMidiEvents.capacity != oldCapacity)
+            fLastMidiEventCount = 0;
+
+        return true;
+    }
+
     LinkedList<LADSPA_Handle>    fHandles;
     const LADSPA_Descriptor*     fDescriptor;
     const DSSI_Descriptor*       fDssiDescriptor;
@@ -3062,12 +3447,22 @@ private:
     float** fAudioOutBuffers;
     float*  fExtraStereoBuffer[2]; // used only if forcedStereoIn and audioOut == 2
     float*  fParamBuffers;
+    float*  fSharedParamBuffers; // output parameters of the first channel, used only if fForcedStereoShared
 
-    snd_seq_event_t fMidiEvents[kPluginMaxMidiEvents];
+    PluginMidiEventStorage<snd_seq_event_t> fMidiEvents;
+    uint32_t fLastMidiEventCount; // events used by the previous block
+
+    DssiMultiSynthGroup* fMultiSynthGroup; // only used with run_multiple_synths
+    float**          fMultiSynthInBuffers; // inputs staged for the next shared run
+    PluginMidiEventStorage<snd_seq_event_t> fMultiSynthEvents; // events staged for the next shared run
+    ulong            fMultiSynthEventCount;
+    bool             fMultiSynthActive;
+    bool             fMultiSynthStaged;
 
     int32_t fLatencyIndex; // -1 if invalid
     bool    fForcedStereoIn;
     bool    fForcedStereoOut;
+    bool    fForcedStereoShared; // both forced stereo channels run through the first instance
     bool    fNeedsFixedBuffers;
     bool    fUsesCustomData;
 
@@ -3108,6 +3503,30 @@ private:
         return false;
     }
 
+    void removeExtraInstances() noexcept
+    {
+        LADSPA_Handle fallback = nullptr;
+
+        while (fHandles.count() > 1)
+        {
+            LADSPA_Handle const handle(fHandles.getLast(fallback, true));
+            CARLA_SAFE_ASSERT_CONTINUE(handle != nullptr);
+
+            if (fDescriptor->cleanup == nullptr)
+                continue;
+
+            try {
+                fDescriptor->cleanup(handle);
+            } CARLA_SAFE_EXCEPTION("LADSPA/DSSI cleanup");
+        }
+    }
+
+    bool isKnownStateless() const noexcept
+    {
+        return fDescriptor->Label != nullptr
+            && isPluginKnownStateless(PLUGIN_LADSPA, fDescriptor->Label, static_cast<int64_t>(fDescriptor->UniqueID));
+    }
+
     uint32_t getSafePortCount() const noexcept
     {
         if (fDescriptor->PortCount == 0)
@@ -3120,6 +3539,77 @@ private:
         return static_cast<uint32_t>(fDescriptor->PortCount);
     }
 
+    bool isDssiSynth() const noexcept
+    {
+        return fDssiDescriptor != nullptr
+            && (fDssiDescriptor->run_synth != nullptr || fDssiDescriptor->run_multiple_synths != nullptr);
+    }
+
+    // -------------------------------------------------------------------
+    // DSSI run_multiple_synths, called with the group mutex held
+
+    uint prepareMultiSynthRun(const bool deferred, const uint32_t frames, LADSPA_Handle* const handles,
+                              snd_seq_event_t** const events, ulong* const eventCounts, const uint space) noexcept
+    {
+        if (deferred)
+        {
+            for (uint32_t i=0; i < pData->audioIn.count; ++i)
+            {
+                if (fMultiSynthStaged)
+                    carla_copyFloats(fAudioInBuffers[i], fMultiSynthInBuffers[i], frames);
+                else
+                    carla_zeroFloats(fAudioInBuffers[i], frames);
+            }
+        }
+
+        for (uint32_t i=0; i < pData->audioOut.count; ++i)
+            carla_zeroFloats(fAudioOutBuffers[i], frames);
+
+        const ulong eventCount = (! deferred || fMultiSynthStaged) ? fMultiSynthEventCount : 0;
+        uint count = 0;
+
+        for (LinkedList<LADSPA_Handle>::Itenerator it = fHandles.begin2(); it.valid(); it.next())
+        {
+            LADSPA_Handle const handle(it.getValue(nullptr));
+            CARLA_SAFE_ASSERT_CONTINUE(handle != nullptr);
+            CARLA_SAFE_ASSERT_BREAK(count < space);
+
+            handles[count]     = handle;
+            events[count]      = deferred ? fMultiSynthEvents.data : fMidiEvents.data;
+            eventCounts[count] = eventCount;
+            ++count;
+        }
+
+        fMultiSynthStaged = false;
+        return count;
+    }
+
+    void finishMultiSynthRun(const uint32_t frames) const noexcept
+    {
+        // mixdown for forced stereo
+        if (pData->audioOut.count == 2 && fForcedStereoOut && ! fForcedStereoIn)
+        {
+            carla_multiply(fAudioOutBuffers[0], 0.5f, frames);
+            carla_multiply(fAudioOutBuffers[1], 0.5f, frames);
+        }
+    }
+
+    void resetMultiSynthRun() noexcept
+    {
+        fMultiSynthStaged = false;
+
+        if (fAudioOutBuffers == nullptr)
+            return;
+
+        const uint32_t bufferSize = pData->engine->getBufferSize();
+
+        for (uint32_t i=0; i < pData->audioOut.count; ++i)
+        {
+            if (fAudioOutBuffers[i] != nullptr)
+                carla_zeroFloats(fAudioOutBuffers[i], bufferSize);
+        }
+    }
+
     bool getSeparatedParameterNameOrUnit(const char* const paramName, char* const strBuf, const bool wantName) const noexcept
     {
         if (_getSeparatedParameterNameOrUnitImpl(paramName, strBuf, wantName, true))
@@ -3169,11 +3659,186 @@ private:
 
     // -------------------------------------------------------------------
 
+    friend struct DssiMultiSynthGroup;
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginLADSPADSSI)
 };
 
 // -------------------------------------------------------------------------------------------------------------------
 
+bool DssiMultiSynthGroup::isFullyStaged() const noexcept
+{
+    for (LinkedList<CarlaPluginLADSPADSSI*>::Itenerator it = plugins.begin2(); it.valid(); it.next())
+    {
+        const CarlaPluginLADSPADSSI* const plugin(it.getValue(nullptr));
+        CARLA_SAFE_ASSERT_CONTINUE(plugin != nullptr);
+
+        if (plugin->fMultiSynthActive && ! plugin->fMultiSynthStaged)
+            return false;
+    }
+
+    return true;
+}
+
+void DssiMultiSynthGroup::setPluginActive(CarlaPluginLADSPADSSI* const plugin, const bool active) noexcept
+{
+    const CarlaMutexLocker cml(mutex);
+
+    if (plugin->fMultiSynthActive == active)
+        return;
+
+    plugin->fMultiSynthActive = active;
+
+    uint newActivePlugins = 0;
+    uint handleCount = 0;
+
+    for (LinkedList<CarlaPluginLADSPADSSI*>::Itenerator it = plugins.begin2(); it.valid(); it.next())
+    {
+        CarlaPluginLADSPADSSI* const groupPlugin(it.getValue(nullptr));
+        CARLA_SAFE_ASSERT_CONTINUE(groupPlugin != nullptr);
+
+        if (! groupPlugin->fMultiSynthActive)
+            continue;
+
+        ++newActivePlugins;
+        handleCount += static_cast<uint>(groupPlugin->fHandles.count());
+    }
+
+    if (handleCount > capacity)
+    {
+        delete[] handles;
+        delete[] events;
+        delete[] eventCounts;
+        handles = nullptr;
+        events = nullptr;
+        eventCounts = nullptr;
+        capacity = 0;
+
+        try {
+            handles     = new LADSPA_Handle[handleCount];
+            events      = new snd_seq_event_t*[handleCount];
+            eventCounts = new ulong[handleCount];
+            capacity    = handleCount;
+        } CARLA_SAFE_EXCEPTION("DssiMultiSynthGroup::setPluginActive");
+    }
+
+    // staged data and pending outputs are only valid for the mode they were made in
+    if ((newActivePlugins > 1) != (activePlugins > 1))
+    {
+        for (LinkedList<CarlaPluginLADSPADSSI*>::Itenerator it = plugins.begin2(); it.valid(); it.next())
+        {
+            CarlaPluginLADSPADSSI* const groupPlugin(it.getValue(nullptr));
+            CARLA_SAFE_ASSERT_CONTINUE(groupPlugin != nullptr);
+
+            if (groupPlugin->fMultiSynthActive)
+                groupPlugin->resetMultiSynthRun();
+        }
+    }
+
+    plugin->fMultiSynthStaged = false;
+    activePlugins = newActivePlugins;
+}
+
+void DssiMultiSynthGroup::run(const uint32_t frames) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(handles != nullptr,);
+
+    const bool deferred = isDeferred();
+    uint count = 0;
+
+    for (LinkedList<CarlaPluginLADSPADSSI*>::Itenerator it = plugins.begin2(); it.valid(); it.next())
+    {
+        CarlaPluginLADSPADSSI* const plugin(it.getValue(nullptr));
+        CARLA_SAFE_ASSERT_CONTINUE(plugin != nullptr);
+
+        if (plugin->fMultiSynthActive)
+            count += plugin->prepareMultiSynthRun(deferred, frames,
+                                                  handles + count, events + count, eventCounts + count,
+                                                  capacity - count);
+    }
+
+    if (count == 0)
+        return;
+
+    try {
+        descriptor->run_multiple_synths(count, handles, frames, events, eventCounts);
+    } CARLA_SAFE_EXCEPTION("DSSI run_multiple_synths");
+
+    for (LinkedList<CarlaPluginLADSPADSSI*>::Itenerator it = plugins.begin2(); it.valid(); it.next())
+    {
+        const CarlaPluginLADSPADSSI* const plugin(it.getValue(nullptr));
+        CARLA_SAFE_ASSERT_CONTINUE(plugin != nullptr);
+
+        if (plugin->fMultiSynthActive)
+            plugin->finishMultiSynthRun(frames);
+    }
+}
+
+DssiMultiSynthGroup* DssiMultiSynthGroup::join(CarlaEngine* const engine, const DSSI_Descriptor* const descriptor,
+                                               CarlaPluginLADSPADSSI* const plugin) noexcept
+{
+    const CarlaMutexLocker cml(gDssiMultiSynthGroupsMutex);
+
+    DssiMultiSynthGroup* group = nullptr;
+
+    for (LinkedList<DssiMultiSynthGroup*>::Itenerator it = gDssiMultiSynthGroups.begin2(); it.valid(); it.next())
+    {
+        DssiMultiSynthGroup* const groupIt(it.getValue(nullptr));
+        CARLA_SAFE_ASSERT_CONTINUE(groupIt != nullptr);
+
+        if (groupIt->engine == engine && groupIt->descriptor == descriptor)
+        {
+            group = groupIt;
+            break;
+        }
+    }
+
+    if (group == nullptr)
+    {
+        try {
+            group = new DssiMultiSynthGroup(engine, descriptor);
+        } CARLA_SAFE_EXCEPTION_RETURN("DssiMultiSynthGroup::join", nullptr);
+
+        if (! gDssiMultiSynthGroups.append(group))
+        {
+            delete group;
+            return nullptr;
+        }
+    }
+
+    {
+        const CarlaMutexLocker cml2(group->mutex);
+
+        if (group->plugins.append(plugin))
+            return group;
+        if (group->plugins.count() != 0)
+            return nullptr;
+    }
+
+    gDssiMultiSynthGroups.removeOne(group);
+    delete group;
+    return nullptr;
+}
+
+void DssiMultiSynthGroup::leave(DssiMultiSynthGroup* const group, CarlaPluginLADSPADSSI* const plugin) noexcept
+{
+    const CarlaMutexLocker cml(gDssiMultiSynthGroupsMutex);
+
+    {
+        const CarlaMutexLocker cml2(group->mutex);
+
+        CARLA_SAFE_ASSERT(! plugin->fMultiSynthActive);
+        group->plugins.removeOne(plugin);
+
+        if (group->plugins.count() != 0)
+            return;
+    }
+
+    gDssiMultiSynthGroups.removeOne(group);
+    delete group;
+}
+
+// -------------------------------------------------------------------------------------------------------------------
+
 CarlaPluginPtr CarlaPlugin::newLADSPA(const Initializer& init, const LADSPA_RDF_Descriptor* const rdfDescriptor)
 {
     carla_debug("CarlaPlugin::newLADSPA({%p, \"%s\", \"%s\", \"%s\", " P_INT64 ", %x}, %p)",
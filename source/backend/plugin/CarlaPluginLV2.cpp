@@ -643,11 +643,14 @@ public:
           fCvInBuffers(nullptr),
           fCvOutBuffers(nullptr),
           fParamBuffers(nullptr),
+          fSharedParamBuffers(nullptr),
           fHasLoadDefaultState(false),
           fHasThreadSafeRestore(false),
           fNeedsFixedBuffers(false),
           fNeedsUiClose(false),
           fInlineDisplayNeedsRedraw(false),
+          fForcedStereoShared(false),
+          fHasEventPorts(false),
           fInlineDisplayLastRedrawTime(0),
           fLatencyIndex(-1),
           fStrictBounds(-1),
@@ -1031,9 +1034,19 @@ public:
         else if (fEventsOut.count != 0)
             pass();
         // if inputs or outputs are just 1, then yes we can force stereo
-        else if ((pData->audioIn.count == 1 || pData->audioOut.count == 1) || fHandle2 != nullptr)
+        else if ((pData->audioIn.count == 1 || pData->audioOut.count == 1) || fHandle2 != nullptr || fForcedStereoShared)
             options |= PLUGIN_OPTION_FORCE_STEREO;
 
+        // single instance processing is only possible for plain mono effects without internal state
+        if (! fHasEventPorts && fExt.state == nullptr && fExt.worker == nullptr
+            && isPluginKnownStateless(PLUGIN_LV2, fRdfDescriptor->URI, 0))
+        {
+            if (pData->audioIn.count == 1 && pData->audioOut.count == 1)
+                options |= PLUGIN_OPTION_FORCE_STEREO_SINGLE_INSTANCE;
+            else if (pData->audioIn.count == 2 && pData->audioOut.count == 2 && (fHandle2 != nullptr || fForcedStereoShared))
+                options |= PLUGIN_OPTION_FORCE_STEREO_SINGLE_INSTANCE;
+        }
+
         if (fExt.programs != nullptr)
             options |= PLUGIN_OPTION_MAP_PROGRAM_CHANGES;
 
@@ -1512,6 +1525,7 @@ public:
     {
         const float fixedValue(pData->param.getFixedValue(parameterId, value));
         fParamBuffers[parameterId] = fixedValue;
+        pData->paramSmoother.cancel(parameterId, fixedValue);
 
         if (pData->param.data[parameterId].rindex >= static_cast<int32_t>(fRdfDescriptor->PortCount))
         {
@@ -1588,6 +1602,26 @@ public:
         CarlaPlugin::setParameterValueRT(parameterId, fixedValue, frameOffset, sendCallbackLater);
     }
 
+    // automation and MIDI CC changes, ramped if parameter smoothing is enabled (control ports only)
+    void setParameterValueSmoothedRT(const uint32_t parameterId, const float value, const uint32_t frameOffset) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fParamBuffers != nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(parameterId < pData->param.count,);
+
+        if (pData->param.data[parameterId].rindex < static_cast<int32_t>(fRdfDescriptor->PortCount))
+        {
+            const float fixedValue(pData->param.getFixedValue(parameterId, value));
+
+            if (pData->paramSmoother.setTarget(parameterId, fixedValue))
+            {
+                CarlaPlugin::setParameterValueRT(parameterId, fixedValue, frameOffset, true);
+                return;
+            }
+        }
+
+        setParameterValueRT(parameterId, value, frameOffset, true);
+    }
+
     void setCustomData(const char* const type, const char* const key, const char* const value, const bool sendGui) override
     {
         CARLA_SAFE_ASSERT_RETURN(fDescriptor != nullptr,);
@@ -1743,6 +1777,9 @@ public:
                     fExt.programs->select_program(fHandle2, bank, program);
                 } CARLA_SAFE_EXCEPTION("select program 2");
             }
+
+            // programs set their own port values
+            pData->paramSmoother.cancelAll();
         }
 
         CarlaPlugin::setMidiProgram(index, sendGui, sendOsc, sendCallback, doingInit);
@@ -1768,6 +1805,9 @@ public:
                     fExt.programs->select_program(fHandle2, bank, program);
                 } CARLA_SAFE_EXCEPTION("select program RT 2");
             }
+
+            // programs set their own port values
+            pData->paramSmoother.cancelAll();
         }
 
         CarlaPlugin::setMidiProgramRT(uindex, sendCallbackLater);
@@ -2344,8 +2384,8 @@ public:
 
         const uint32_t eventBufferSize = static_cast<uint32_t>(fLv2Options.sequenceSize) + 0xff;
 
-        bool forcedStereoIn, forcedStereoOut;
-        forcedStereoIn = forcedStereoOut = false;
+        bool forcedStereoIn, forcedStereoOut, forcedStereoShared;
+        forcedStereoIn = forcedStereoOut = forcedStereoShared = false;
 
         bool needsCtrlIn, needsCtrlOut, hasPatchParameterOutputs;
         needsCtrlIn = needsCtrlOut = hasPatchParameterOutputs = false;
@@ -2413,14 +2453,28 @@ public:
 
         if ((pData->options & PLUGIN_OPTION_FORCE_STEREO) != 0 && aIns <= 1 && aOuts <= 1 && evOuts.count() == 0 && fExt.state == nullptr && fExt.worker == nullptr)
         {
-            if (fHandle2 == nullptr)
+            // mono effects can run each channel in turn through the same instance, if requested
+            forcedStereoShared = aIns == 1 && aOuts == 1 && evIns.count() == 0
+                              && (pData->options & PLUGIN_OPTION_FORCE_STEREO_SINGLE_INSTANCE) != 0
+                              && isPluginKnownStateless(PLUGIN_LV2, fRdfDescriptor->URI, 0);
+
+            if (forcedStereoShared)
+            {
+                if (fHandle2 != nullptr)
+                {
+                    if (fDescriptor->cleanup != nullptr)
+                        fDescriptor->cleanup(fHandle2);
+                    fHandle2 = nullptr;
+                }
+            }
+            else if (fHandle2 == nullptr)
             {
                 try {
                     fHandle2 = fDescriptor->instantiate(fDescriptor, sampleRate, fRdfDescriptor->Bundle, fFeatures);
                 } catch(...) {}
             }
 
-            if (fHandle2 != nullptr)
+            if (fHandle2 != nullptr || forcedStereoShared)
             {
                 if (aIns == 1)
                 {
@@ -2478,6 +2532,12 @@ public:
             pData->param.createNew(params, true);
             fParamBuffers = new float[params];
             carla_zeroFloats(fParamBuffers, params);
+
+            if (forcedStereoShared)
+            {
+                fSharedParamBuffers = new float[params];
+                carla_zeroFloats(fSharedParamBuffers, params);
+            }
         }
 
         if (const uint32_t count = static_cast<uint32_t>(evIns.count()))
@@ -3286,6 +3346,13 @@ public:
         else
             pData->options &= ~PLUGIN_OPTION_FORCE_STEREO;
 
+        fForcedStereoShared = forcedStereoShared;
+        fHasEventPorts      = evIns.count() != 0 || evOuts.count() != 0;
+
+        if (const uint smoothingTime = pData->engine->getOptions().parameterSmoothingTime)
+            pData->paramSmoother.createNew(pData->param, fParamBuffers,
+                                           static_cast<uint32_t>(smoothingTime * sampleRate / 1000.0f));
+
         // plugin hints
         pData->hints = (pData->hints & PLUGIN_HAS_INLINE_DISPLAY) ? PLUGIN_HAS_INLINE_DISPLAY : 0
                      | (pData->hints & PLUGIN_NEEDS_UI_MAIN_THREAD) ? PLUGIN_NEEDS_UI_MAIN_THREAD : 0;
@@ -3998,9 +4065,10 @@ public:
                     eventTime = timeOffset;
                 }
 
-                if (isSampleAccurate && eventTime > timeOffset)
+                // changes to smoothed parameters are ramped from the current position instead of splitting the block
+                if (isSampleAccurate && eventTime > timeOffset && ! pData->isSmoothedParameterEvent(event))
                 {
-                    if (processSingle(audioIn, audioOut, cvIn, cvOut, eventTime - timeOffset, timeOffset))
+                    if (processSmoothed(audioIn, audioOut, cvIn, cvOut, eventTime - timeOffset, timeOffset))
                     {
                         startTime  = 0;
                         timeOffset = eventTime;
@@ -4077,7 +4145,7 @@ public:
 
                             ctrlEvent.handled = true;
                             value = pData->param.getFinalUnnormalizedValue(k, ctrlEvent.normalizedValue);
-                            setParameterValueRT(k, value, event.time, true);
+                            setParameterValueSmoothedRT(k, value, event.time);
                             continue;
                         }
 
@@ -4125,17 +4193,9 @@ public:
 #endif
                         // Control plugin parameters
                         uint32_t k;
-                        for (k=0; k < pData->param.count; ++k)
+                        for (k = pData->param.getFirstMappedParameter(event.channel, ctrlEvent.param);
+                             k < pData->param.count; k = pData->param.getNextMappedParameter(k))
                         {
-                            if (pData->param.data[k].midiChannel != event.channel)
-                                continue;
-                            if (pData->param.data[k].mappedControlIndex != ctrlEvent.param)
-                                continue;
-                            if (pData->param.data[k].type != PARAMETER_INPUT)
-                                continue;
-                            if ((pData->param.data[k].hints & PARAMETER_IS_AUTOMATABLE) == 0)
-                                continue;
-
                             ctrlEvent.handled = true;
 
                             if (pData->param.data[k].mappedFlags & PARAMETER_MAPPING_MIDI_DELTA)
@@ -4143,7 +4203,7 @@ public:
                             else
                                 value = pData->param.getFinalUnnormalizedValue(k, ctrlEvent.normalizedValue);
 
-                            setParameterValueRT(k, value, event.time, true);
+                            setParameterValueSmoothedRT(k, value, event.time);
                         }
 
                         if ((pData->options & PLUGIN_OPTION_SEND_CONTROL_CHANGES) != 0 && ctrlEvent.param < MAX_MIDI_VALUE)
@@ -4341,7 +4401,7 @@ public:
             pData->postRtEvents.trySplice();
 
             if (frames > timeOffset)
-                processSingle(audioIn, audioOut, cvIn, cvOut, frames - timeOffset, timeOffset);
+                processSmoothed(audioIn, audioOut, cvIn, cvOut, frames - timeOffset, timeOffset);
 
         } // End of Event Input and Processing
 
@@ -4350,7 +4410,7 @@ public:
 
         else
         {
-            processSingle(audioIn, audioOut, cvIn, cvOut, frames, 0);
+            processSmoothed(audioIn, audioOut, cvIn, cvOut, frames, 0);
 
         } // End of Plugin processing (no events)
 
@@ -4525,6 +4585,33 @@ public:
         // --------------------------------------------------------------------------------------------------------
     }
 
+    bool processSmoothed(const float* const* const audioIn, float** const audioOut,
+                         const float* const* const cvIn, float** const cvOut,
+                         const uint32_t frames, const uint32_t timeOffset)
+    {
+        PluginParameterSmoother& smoother(pData->paramSmoother);
+
+        // ramps advance at a fixed control rate, which needs the block to be split without moving any events
+        if (smoother.isRamping() && ! fHasEventPorts && (pData->options & PLUGIN_OPTION_FIXED_BUFFERS) == 0)
+        {
+            const uint32_t quantum = PluginParameterSmoother::kQuantum;
+            uint32_t offset = 0;
+            bool ok = true;
+
+            for (; frames - offset > quantum && smoother.isRamping(); offset += quantum)
+            {
+                smoother.advance(quantum);
+                ok = processSingle(audioIn, audioOut, cvIn, cvOut, quantum, timeOffset + offset) && ok;
+            }
+
+            smoother.advance(frames - offset);
+            return processSingle(audioIn, audioOut, cvIn, cvOut, frames - offset, timeOffset + offset) && ok;
+        }
+
+        smoother.advance(frames);
+        return processSingle(audioIn, audioOut, cvIn, cvOut, frames, timeOffset);
+    }
+
     bool processSingle(const float* const* const audioIn, float** const audioOut,
                        const float* const* const cvIn, float** const cvOut,
                        const uint32_t frames, const uint32_t timeOffset)
@@ -4597,10 +4684,36 @@ public:
         // --------------------------------------------------------------------------------------------------------
         // Run plugin
 
-        fDescriptor->run(fHandle, frames);
+        if (fForcedStereoShared)
+        {
+            // run each channel in turn, reconnecting the audio ports in between
+            for (uint32_t c=0; c < 2; ++c)
+            {
+                fDescriptor->connect_port(fHandle, pData->audioIn.ports[c].rindex, fAudioInBuffers[c]);
+                fDescriptor->connect_port(fHandle, pData->audioOut.ports[c].rindex, fAudioOutBuffers[c]);
+                fDescriptor->run(fHandle, frames);
+
+                // output parameters report the first channel, like with 2 instances
+                if (c == 0 && fSharedParamBuffers != nullptr)
+                    carla_copyFloats(fSharedParamBuffers, fParamBuffers, pData->param.count);
+            }
 
-        if (fHandle2 != nullptr)
-            fDescriptor->run(fHandle2, frames);
+            if (fSharedParamBuffers != nullptr)
+            {
+                for (uint32_t k=0; k < pData->param.count; ++k)
+                {
+                    if (pData->param.data[k].type == PARAMETER_OUTPUT)
+                        fParamBuffers[k] = fSharedParamBuffers[k];
+                }
+            }
+        }
+        else
+        {
+            fDescriptor->run(fHandle, frames);
+
+            if (fHandle2 != nullptr)
+                fDescriptor->run(fHandle2, frames);
+        }
 
         // --------------------------------------------------------------------------------------------------------
         // Handle trigger parameters
@@ -4983,6 +5096,12 @@ public:
             fParamBuffers = nullptr;
         }
 
+        if (fSharedParamBuffers != nullptr)
+        {
+            delete[] fSharedParamBuffers;
+            fSharedParamBuffers = nullptr;
+        }
+
         fEventsIn.clear(pData->event.portIn);
         fEventsOut.clear(pData->event.portOut);
 
@@ -6892,6 +7011,9 @@ public:
         else if (options & PLUGIN_OPTION_FORCE_STEREO)
             pData->options |= PLUGIN_OPTION_FORCE_STEREO;
 
+        if (options & PLUGIN_OPTION_FORCE_STEREO_SINGLE_INSTANCE)
+            pData->options |= PLUGIN_OPTION_FORCE_STEREO_SINGLE_INSTANCE;
+
         if (getMidiInCount() != 0)
         {
             if (isPluginOptionEnabled(options, PLUGIN_OPTION_SEND_CONTROL_CHANGES))
@@ -7487,12 +7609,15 @@ private:
     float** fCvInBuffers;
     float** fCvOutBuffers;
     float*  fParamBuffers;
+    float*  fSharedParamBuffers; // output parameters of the first channel, used only if fForcedStereoShared
 
     bool    fHasLoadDefaultState : 1;
     bool    fHasThreadSafeRestore : 1;
     bool    fNeedsFixedBuffers : 1;
     bool    fNeedsUiClose  : 1;
     bool    fInlineDisplayNeedsRedraw : 1;
+    bool    fForcedStereoShared : 1; // both forced stereo channels run through fHandle
+    bool    fHasEventPorts : 1; // fEventsIn always has at least 1 entry for the engine control port
     int64_t fInlineDisplayLastRedrawTime;
     int32_t fLatencyIndex; // -1 if invalid
     int     fStrictBounds; // -1 unsupported, 0 optional, 1 required
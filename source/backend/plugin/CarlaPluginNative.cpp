@@ -2039,17 +2039,9 @@ public:
                         }
 #endif
                         // Control plugin parameters
-                        for (uint32_t k=0; k < pData->param.count; ++k)
+                        for (uint32_t k = pData->param.getFirstMappedParameter(event.channel, ctrlEvent.param);
+                             k < pData->param.count; k = pData->param.getNextMappedParameter(k))
                         {
-                            if (pData->param.data[k].midiChannel != event.channel)
-                                continue;
-                            if (pData->param.data[k].mappedControlIndex != ctrlEvent.param)
-                                continue;
-                            if (pData->param.data[k].type != PARAMETER_INPUT)
-                                continue;
-                            if ((pData->param.data[k].hints & PARAMETER_IS_AUTOMATABLE) == 0)
-                                continue;
-
                             ctrlEvent.handled = true;
                             value = pData->param.getFinalUnnormalizedValue(k, ctrlEvent.normalizedValue);
                             setParameterValueRT(k, value, event.time, true);
@@ -2937,6 +2929,8 @@ public:
 
         /**/ if (std::strcmp(fDescriptor->label, "audiofile") == 0)
             pData->iconName = carla_strdup_safe("file");
+        else if (std::strcmp(fDescriptor->label, "audiofile8") == 0)
+            pData->iconName = carla_strdup_safe("file");
         else if (std::strcmp(fDescriptor->label, "midifile") == 0)
             pData->iconName = carla_strdup_safe("file");
 
@@ -0,0 +1,523 @@
+/*
+ * Carla Plugin
+ * Copyright (C) 2011-2020 Filipe Coelho <falktx@falktx.com>
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaPluginInternal.hpp"
+
+#include "CarlaMathUtils.hpp"
+#include "CarlaMIDI.h"
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// PluginParameterData
+
+PluginParameterData::PluginParameterData() noexcept
+    : count(0),
+      data(nullptr),
+      ranges(nullptr),
+      special(nullptr),
+      mappedFirst(nullptr),
+      mappedNext(nullptr),
+      mappedControlsChanged(false) {}
+
+PluginParameterData::~PluginParameterData() noexcept
+{
+    CARLA_SAFE_ASSERT_INT(count == 0, count);
+    CARLA_SAFE_ASSERT(data == nullptr);
+    CARLA_SAFE_ASSERT(ranges == nullptr);
+    CARLA_SAFE_ASSERT(special == nullptr);
+    CARLA_SAFE_ASSERT(mappedFirst == nullptr);
+    CARLA_SAFE_ASSERT(mappedNext == nullptr);
+}
+
+void PluginParameterData::createNew(const uint32_t newCount, const bool withSpecial)
+{
+    CARLA_SAFE_ASSERT_INT(count == 0, count);
+    CARLA_SAFE_ASSERT_RETURN(data == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(ranges == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(special == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(mappedFirst == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(mappedNext == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(newCount > 0,);
+
+    data = new ParameterData[newCount];
+    carla_zeroStructs(data, newCount);
+
+    for (uint32_t i=0; i < newCount; ++i)
+    {
+        data[i].index  = PARAMETER_NULL;
+        data[i].rindex = PARAMETER_NULL;
+        data[i].mappedControlIndex = CONTROL_INDEX_NONE;
+        data[i].mappedMinimum = -1.0f;
+        data[i].mappedMaximum = 1.0f;
+    }
+
+    ranges = new ParameterRanges[newCount];
+    carla_zeroStructs(ranges, newCount);
+
+    if (withSpecial)
+    {
+        special = new SpecialParameterType[newCount];
+        carla_zeroStructs(special, newCount);
+    }
+
+    mappedFirst = new uint32_t[MAX_MIDI_CHANNELS * MAX_MIDI_CONTROL];
+    mappedNext  = new uint32_t[newCount];
+
+    count = newCount;
+
+    // parameter details are filled in later by the plugin, table is built on first lookup
+    mappedControlsChanged = true;
+}
+
+void PluginParameterData::clear() noexcept
+{
+    if (data != nullptr)
+    {
+        delete[] data;
+        data = nullptr;
+    }
+
+    if (ranges != nullptr)
+    {
+        delete[] ranges;
+        ranges = nullptr;
+    }
+
+    if (special != nullptr)
+    {
+        delete[] special;
+        special = nullptr;
+    }
+
+    if (mappedFirst != nullptr)
+    {
+        delete[] mappedFirst;
+        mappedFirst = nullptr;
+    }
+
+    if (mappedNext != nullptr)
+    {
+        delete[] mappedNext;
+        mappedNext = nullptr;
+    }
+
+    count = 0;
+    mappedControlsChanged = false;
+}
+
+float PluginParameterData::getFixedValue(const uint32_t parameterId, float value) const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(parameterId < count, 0.0f);
+
+    const uint             paramHints (data[parameterId].hints);
+    const ParameterRanges& paramRanges(ranges[parameterId]);
+
+    // if boolean, return either min or max
+    if (paramHints & PARAMETER_IS_BOOLEAN)
+    {
+        const float middlePoint = paramRanges.min + (paramRanges.max-paramRanges.min)/2.0f;
+        return value >= middlePoint ? paramRanges.max : paramRanges.min;
+    }
+
+    // if integer, round first
+    if (paramHints & PARAMETER_IS_INTEGER)
+        return paramRanges.getFixedValue(std::round(value));
+
+    // normal mode
+    return paramRanges.getFixedValue(value);
+}
+
+// copied from ParameterRanges::getUnnormalizedValue
+static float _getUnnormalizedValue(const float min, const float max, const float value) noexcept
+{
+    if (value <= 0.0f)
+        return min;
+    if (value >= 1.0f)
+        return max;
+
+    return value * (max - min) + min;
+}
+
+// copied from ParameterRanges::getUnnormalizedLogValue
+static float _getUnnormalizedLogValue(const float min, const float max, const float value) noexcept
+{
+    if (value <= 0.0f)
+        return min;
+    if (value >= 1.0f)
+        return max;
+
+    float rmin = min;
+
+    if (std::abs(min) < std::numeric_limits<float>::epsilon())
+        rmin = 0.00001f;
+
+    return rmin * std::pow(max/rmin, value);
+}
+
+float PluginParameterData::getFinalUnnormalizedValue(const uint32_t parameterId,
+                                                     const float normalizedValue) const noexcept
+{
+    float min, max, value;
+
+    if (data[parameterId].mappedControlIndex != CONTROL_INDEX_CV
+        && (data[parameterId].hints & PARAMETER_MAPPED_RANGES_SET) != 0x0)
+    {
+        min = data[parameterId].mappedMinimum;
+        max = data[parameterId].mappedMaximum;
+    }
+    else
+    {
+        min = ranges[parameterId].min;
+        max = ranges[parameterId].max;
+    }
+
+    if (data[parameterId].hints & PARAMETER_IS_BOOLEAN)
+    {
+        value = (normalizedValue < 0.5f) ? min : max;
+    }
+    else
+    {
+        if (data[parameterId].hints & PARAMETER_IS_LOGARITHMIC)
+            value = _getUnnormalizedLogValue(min, max, normalizedValue);
+        else
+            value = _getUnnormalizedValue(min, max, normalizedValue);
+
+        if (data[parameterId].hints & PARAMETER_IS_INTEGER)
+            value = std::rint(value);
+    }
+
+    return value;
+}
+
+float PluginParameterData::getFinalValueWithMidiDelta(const uint32_t parameterId,
+                                                      float value, int8_t delta) const noexcept
+{
+    if (delta < 0)
+        return value;
+    if (data[parameterId].mappedControlIndex <= 0 || data[parameterId].mappedControlIndex >= MAX_MIDI_CONTROL)
+        return value;
+
+    float min, max;
+
+    if ((data[parameterId].hints & PARAMETER_MAPPED_RANGES_SET) != 0x0)
+    {
+        min = data[parameterId].mappedMinimum;
+        max = data[parameterId].mappedMaximum;
+    }
+    else
+    {
+        min = ranges[parameterId].min;
+        max = ranges[parameterId].max;
+    }
+
+    if (data[parameterId].hints & PARAMETER_IS_BOOLEAN)
+    {
+        value = delta > 63 ? min : max;
+    }
+    else
+    {
+        if (data[parameterId].hints & PARAMETER_IS_INTEGER)
+        {
+            if (delta > 63)
+                value += delta - 128.0f;
+            else
+                value += delta;
+        }
+        else
+        {
+            if (delta > 63)
+                delta = static_cast<int8_t>(delta - 128);
+
+            value += (max - min) * (static_cast<float>(delta) / 127.0f);
+        }
+
+        if (value < min)
+            value = min;
+        else if (value > max)
+            value = max;
+    }
+
+    return value;
+}
+
+uint32_t PluginParameterData::getFirstMappedParameter(const uint8_t channel, const uint16_t control) noexcept
+{
+    if (channel >= MAX_MIDI_CHANNELS || control >= MAX_MIDI_CONTROL || mappedFirst == nullptr)
+        return count;
+
+    if (mappedControlsChanged)
+        updateMappedControls();
+
+    return mappedFirst[channel * MAX_MIDI_CONTROL + control];
+}
+
+uint32_t PluginParameterData::getNextMappedParameter(const uint32_t parameterId) const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(parameterId < count, count);
+
+    return mappedNext[parameterId];
+}
+
+void PluginParameterData::invalidateMappedControls() noexcept
+{
+    mappedControlsChanged = true;
+}
+
+void PluginParameterData::updateMappedControls() noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(mappedFirst != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(mappedNext != nullptr,);
+
+    // clear flag first, so changes made while rebuilding trigger another update
+    mappedControlsChanged = false;
+
+    carla_fill<uint32_t>(mappedFirst, count, MAX_MIDI_CHANNELS * MAX_MIDI_CONTROL);
+
+    // walk backwards so each chain ends up in ascending parameter order
+    for (uint32_t i=count; i-- > 0;)
+    {
+        const ParameterData& paramData(data[i]);
+
+        mappedNext[i] = count;
+
+        if (paramData.mappedControlIndex < 0 || paramData.mappedControlIndex >= MAX_MIDI_CONTROL)
+            continue;
+        if (paramData.midiChannel >= MAX_MIDI_CHANNELS)
+            continue;
+        if (paramData.type != PARAMETER_INPUT)
+            continue;
+        if ((paramData.hints & PARAMETER_IS_AUTOMATABLE) == 0)
+            continue;
+
+        uint32_t& first(mappedFirst[paramData.midiChannel * MAX_MIDI_CONTROL
+                                    + static_cast<uint32_t>(paramData.mappedControlIndex)]);
+        mappedNext[i] = first;
+        first = i;
+    }
+}
+
+// -----------------------------------------------------------------------
+// PluginParameterSmoother
+
+PluginParameterSmoother::PluginParameterSmoother() noexcept
+    : count(0),
+      activeCount(0),
+      rampFrames(0),
+      buffer(nullptr),
+      targets(nullptr),
+      steps(nullptr),
+      remaining(nullptr),
+      smoothable(nullptr),
+      cancelValues(nullptr),
+      cancelRequested(nullptr),
+      hasCancelRequests(false) {}
+
+PluginParameterSmoother::~PluginParameterSmoother() noexcept
+{
+    CARLA_SAFE_ASSERT_INT(count == 0, count);
+    CARLA_SAFE_ASSERT(targets == nullptr);
+    CARLA_SAFE_ASSERT(steps == nullptr);
+    CARLA_SAFE_ASSERT(remaining == nullptr);
+    CARLA_SAFE_ASSERT(smoothable == nullptr);
+    CARLA_SAFE_ASSERT(cancelValues == nullptr);
+    CARLA_SAFE_ASSERT(cancelRequested == nullptr);
+}
+
+void PluginParameterSmoother::createNew(const PluginParameterData& param, float* const paramBuffer,
+                                        const uint32_t newRampFrames)
+{
+    CARLA_SAFE_ASSERT_INT(count == 0, count);
+    CARLA_SAFE_ASSERT_RETURN(targets == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(paramBuffer != nullptr,);
+
+    // nothing to do unless enabled
+    if (param.count == 0 || newRampFrames == 0)
+        return;
+
+    targets    = new float[param.count];
+    steps      = new float[param.count];
+    remaining  = new uint32_t[param.count];
+    smoothable = new bool[param.count];
+    cancelValues    = new float[param.count];
+    cancelRequested = new bool[param.count];
+
+    // stepped and trigger values cannot be interpolated
+    const uint steppedHints = PARAMETER_IS_BOOLEAN|PARAMETER_IS_INTEGER|PARAMETER_IS_TRIGGER;
+
+    for (uint32_t i=0; i < param.count; ++i)
+    {
+        targets[i]    = 0.0f;
+        steps[i]      = 0.0f;
+        remaining[i]  = 0;
+        cancelValues[i]    = 0.0f;
+        cancelRequested[i] = false;
+        smoothable[i] = param.data[i].type == PARAMETER_INPUT
+                     && (param.data[i].hints & PARAMETER_IS_ENABLED) != 0
+                     && (param.data[i].hints & steppedHints) == 0;
+    }
+
+    buffer      = paramBuffer;
+    rampFrames  = newRampFrames;
+    activeCount = 0;
+    hasCancelRequests = false;
+    count       = param.count;
+}
+
+void PluginParameterSmoother::clear() noexcept
+{
+    if (targets != nullptr)
+    {
+        delete[] targets;
+        targets = nullptr;
+    }
+
+    if (steps != nullptr)
+    {
+        delete[] steps;
+        steps = nullptr;
+    }
+
+    if (remaining != nullptr)
+    {
+        delete[] remaining;
+        remaining = nullptr;
+    }
+
+    if (smoothable != nullptr)
+    {
+        delete[] smoothable;
+        smoothable = nullptr;
+    }
+
+    if (cancelValues != nullptr)
+    {
+        delete[] cancelValues;
+        cancelValues = nullptr;
+    }
+
+    if (cancelRequested != nullptr)
+    {
+        delete[] cancelRequested;
+        cancelRequested = nullptr;
+    }
+
+    buffer      = nullptr;
+    rampFrames  = 0;
+    activeCount = 0;
+    hasCancelRequests = false;
+    count       = 0;
+}
+
+bool PluginParameterSmoother::setTarget(const uint32_t parameterId, const float value) noexcept
+{
+    if (parameterId >= count || ! smoothable[parameterId])
+        return false;
+
+    // a newer value from the audio thread replaces any pending cancel
+    cancelRequested[parameterId] = false;
+
+    if (carla_isEqual(buffer[parameterId], value))
+    {
+        stop(parameterId);
+        return true;
+    }
+
+    if (remaining[parameterId] == 0)
+        ++activeCount;
+
+    targets[parameterId]   = value;
+    steps[parameterId]     = (value - buffer[parameterId]) / static_cast<float>(rampFrames);
+    remaining[parameterId] = rampFrames;
+    return true;
+}
+
+void PluginParameterSmoother::cancel(const uint32_t parameterId, const float value) noexcept
+{
+    if (parameterId >= count || ! smoothable[parameterId])
+        return;
+
+    cancelValues[parameterId] = value;
+    __sync_synchronize();
+    cancelRequested[parameterId] = true;
+    hasCancelRequests = true;
+}
+
+void PluginParameterSmoother::cancelAll() noexcept
+{
+    for (uint32_t i=0; i < count; ++i)
+    {
+        if (remaining[i] != 0)
+            cancel(i, buffer[i]);
+    }
+}
+
+void PluginParameterSmoother::stop(const uint32_t parameterId) noexcept
+{
+    if (parameterId >= count || remaining[parameterId] == 0)
+        return;
+
+    remaining[parameterId] = 0;
+    --activeCount;
+}
+
+void PluginParameterSmoother::advance(const uint32_t frames) noexcept
+{
+    if (hasCancelRequests)
+    {
+        hasCancelRequests = false;
+        __sync_synchronize();
+
+        for (uint32_t i=0; i < count; ++i)
+        {
+            if (! cancelRequested[i])
+                continue;
+
+            cancelRequested[i] = false;
+            __sync_synchronize();
+
+            // the ramp might have overwritten the value since it was set
+            buffer[i] = cancelValues[i];
+            stop(i);
+        }
+    }
+
+    for (uint32_t i=0, active=activeCount; i < count && active != 0; ++i)
+    {
+        if (remaining[i] == 0)
+            continue;
+
+        --active;
+
+        if (remaining[i] <= frames)
+        {
+            buffer[i] = targets[i];
+            remaining[i] = 0;
+            --activeCount;
+        }
+        else
+        {
+            buffer[i] += steps[i] * static_cast<float>(frames);
+            remaining[i] -= frames;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
@@ -24,6 +24,7 @@
 #endif
 
 #include "CarlaBackendUtils.hpp"
+#include "CarlaEngineUtils.hpp"
 #include "CarlaMathUtils.hpp"
 #include "CarlaProcessUtils.hpp"
 #include "CarlaScopeUtils.hpp"
@@ -76,6 +77,8 @@ public:
           fUnique1(1),
           fEffect(nullptr),
           fMidiEventCount(0),
+          fMidiOutEventCount(0),
+          fMidiEvents(),
           fTimeInfo(),
           fNeedIdle(false),
           fLastChunk(nullptr),
@@ -92,18 +95,14 @@ public:
           fBufferSize(engine->getBufferSize()),
           fAudioOutBuffers(nullptr),
           fLastTimeInfo(),
-          fEvents(),
+          fEvents(nullptr),
           fUI(),
           fUnique2(2)
     {
         carla_debug("CarlaPluginVST2::CarlaPluginVST2(%p, %i)", engine, id);
 
-        carla_zeroStructs(fMidiEvents, kPluginMaxMidiEvents*2);
         carla_zeroStruct(fTimeInfo);
 
-        for (ushort i=0; i < kPluginMaxMidiEvents*2; ++i)
-            fEvents.data[i] = (VstEvent*)&fMidiEvents[i];
-
         // make plugin valid
         srand(id);
         fUnique1 = fUnique2 = rand();
@@ -155,6 +154,12 @@ public:
             fLastChunk = nullptr;
         }
 
+        if (fEvents != nullptr)
+        {
+            std::free(fEvents);
+            fEvents = nullptr;
+        }
+
         clearBuffers();
     }
 
@@ -666,6 +671,14 @@ public:
             dispatcher(effIdle);
         }
 
+        if (fMidiEvents.needsMoreSpace)
+        {
+            const CarlaMutexLocker cml(pData->masterMutex);
+
+            if (! resizeMidiEvents(fMidiEvents.capacity*2))
+                carla_stderr2("CarlaPluginVST2::idle() - failed to grow MIDI event storage");
+        }
+
         CarlaPlugin::idle();
     }
 
@@ -988,6 +1001,10 @@ public:
             pData->event.portOut = (CarlaEngineEventPort*)pData->client->addPort(kEnginePortTypeEvent, portName, false, 0);
         }
 
+        // room for a full engine event buffer, plus as much for plugin output
+        if (! resizeMidiEvents(kMaxEngineEventInternalCount*2))
+            carla_stderr2("CarlaPluginVST2::reload() - failed to allocate MIDI event storage");
+
         // plugin hints
         const intptr_t vstCategory = dispatcher(effGetPlugCategory);
 
@@ -1207,41 +1224,47 @@ public:
             return;
         }
 
+        // each input event is cleared as it is filled, output events are always copied whole
         fMidiEventCount = 0;
-        carla_zeroStructs(fMidiEvents, kPluginMaxMidiEvents*2);
+        fMidiOutEventCount = 0;
 
         // --------------------------------------------------------------------------------------------------------
         // Check if needs reset
 
         if (pData->needsReset)
         {
-            if (pData->options & PLUGIN_OPTION_SEND_ALL_SOUND_OFF)
+            if ((pData->options & PLUGIN_OPTION_SEND_ALL_SOUND_OFF) && fMidiEvents.hasSpaceFor(0, MAX_MIDI_CHANNELS*2))
             {
                 fMidiEventCount = MAX_MIDI_CHANNELS*2;
 
                 for (uint8_t i=0; i < MAX_MIDI_CHANNELS; ++i)
                 {
-                    fMidiEvents[i].type = kVstMidiType;
-                    fMidiEvents[i].byteSize    = kVstMidiEventSize;
-                    fMidiEvents[i].midiData[0] = char(MIDI_STATUS_CONTROL_CHANGE | (i & MIDI_CHANNEL_BIT));
-                    fMidiEvents[i].midiData[1] = MIDI_CONTROL_ALL_NOTES_OFF;
-
-                    fMidiEvents[MAX_MIDI_CHANNELS + i].type = kVstMidiType;
-                    fMidiEvents[MAX_MIDI_CHANNELS + i].byteSize    = kVstMidiEventSize;
-                    fMidiEvents[MAX_MIDI_CHANNELS + i].midiData[0] = char(MIDI_STATUS_CONTROL_CHANGE | (i & MIDI_CHANNEL_BIT));
-                    fMidiEvents[MAX_MIDI_CHANNELS + i].midiData[1] = MIDI_CONTROL_ALL_SOUND_OFF;
+                    carla_zeroStruct(fMidiEvents.data[i]);
+                    carla_zeroStruct(fMidiEvents.data[MAX_MIDI_CHANNELS + i]);
+
+                    fMidiEvents.data[i].type = kVstMidiType;
+                    fMidiEvents.data[i].byteSize    = kVstMidiEventSize;
+                    fMidiEvents.data[i].midiData[0] = char(MIDI_STATUS_CONTROL_CHANGE | (i & MIDI_CHANNEL_BIT));
+                    fMidiEvents.data[i].midiData[1] = MIDI_CONTROL_ALL_NOTES_OFF;
+
+                    fMidiEvents.data[MAX_MIDI_CHANNELS + i].type = kVstMidiType;
+                    fMidiEvents.data[MAX_MIDI_CHANNELS + i].byteSize    = kVstMidiEventSize;
+                    fMidiEvents.data[MAX_MIDI_CHANNELS + i].midiData[0] = char(MIDI_STATUS_CONTROL_CHANGE | (i & MIDI_CHANNEL_BIT));
+                    fMidiEvents.data[MAX_MIDI_CHANNELS + i].midiData[1] = MIDI_CONTROL_ALL_SOUND_OFF;
                 }
             }
-            else if (pData->ctrlChannel >= 0 && pData->ctrlChannel < MAX_MIDI_CHANNELS)
+            else if (pData->ctrlChannel >= 0 && pData->ctrlChannel < MAX_MIDI_CHANNELS && fMidiEvents.hasSpaceFor(0, MAX_MIDI_NOTE))
             {
                 fMidiEventCount = MAX_MIDI_NOTE;
 
                 for (uint8_t i=0; i < MAX_MIDI_NOTE; ++i)
                 {
-                    fMidiEvents[i].type = kVstMidiType;
-                    fMidiEvents[i].byteSize    = kVstMidiEventSize;
-                    fMidiEvents[i].midiData[0] = char(MIDI_STATUS_NOTE_OFF | (pData->ctrlChannel & MIDI_CHANNEL_BIT));
-                    fMidiEvents[i].midiData[1] = char(i);
+                    carla_zeroStruct(fMidiEvents.data[i]);
+
+                    fMidiEvents.data[i].type = kVstMidiType;
+                    fMidiEvents.data[i].byteSize    = kVstMidiEventSize;
+                    fMidiEvents.data[i].midiData[0] = char(MIDI_STATUS_NOTE_OFF | (pData->ctrlChannel & MIDI_CHANNEL_BIT));
+                    fMidiEvents.data[i].midiData[1] = char(i);
                 }
             }
 
@@ -1328,13 +1351,14 @@ public:
             {
                 ExternalMidiNote note = { -1, 0, 0 };
 
-                for (; fMidiEventCount < kPluginMaxMidiEvents*2 && ! pData->extNotes.data.isEmpty();)
+                for (; fMidiEvents.hasSpaceFor(fMidiEventCount + fMidiOutEventCount) && ! pData->extNotes.data.isEmpty();)
                 {
                     note = pData->extNotes.data.getFirst(note, true);
 
                     CARLA_SAFE_ASSERT_CONTINUE(note.channel >= 0 && note.channel < MAX_MIDI_CHANNELS);
 
-                    VstMidiEvent& vstMidiEvent(fMidiEvents[fMidiEventCount++]);
+                    VstMidiEvent& vstMidiEvent(fMidiEvents.data[fMidiEventCount++]);
+                    carla_zeroStruct(vstMidiEvent);
 
                     vstMidiEvent.type        = kVstMidiType;
                     vstMidiEvent.byteSize    = kVstMidiEventSize;
@@ -1386,7 +1410,7 @@ public:
 
                         if (fMidiEventCount > 0)
                         {
-                            carla_zeroStructs(fMidiEvents, fMidiEventCount);
+                            carla_zeroStructs(fMidiEvents.data, fMidiEventCount);
                             fMidiEventCount = 0;
                         }
                     }
@@ -1467,17 +1491,9 @@ public:
 #endif
                         // Control plugin parameters
                         uint32_t k;
-                        for (k=0; k < pData->param.count; ++k)
+                        for (k = pData->param.getFirstMappedParameter(event.channel, ctrlEvent.param);
+                             k < pData->param.count; k = pData->param.getNextMappedParameter(k))
                         {
-                            if (pData->param.data[k].midiChannel != event.channel)
-                                continue;
-                            if (pData->param.data[k].mappedControlIndex != ctrlEvent.param)
-                                continue;
-                            if (pData->param.data[k].type != PARAMETER_INPUT)
-                                continue;
-                            if ((pData->param.data[k].hints & PARAMETER_IS_AUTOMATABLE) == 0)
-                                continue;
-
                             ctrlEvent.handled = true;
                             value = pData->param.getFinalUnnormalizedValue(k, ctrlEvent.normalizedValue);
                             setParameterValueRT(k, value, event.time, true);
@@ -1485,10 +1501,10 @@ public:
 
                         if ((pData->options & PLUGIN_OPTION_SEND_CONTROL_CHANGES) != 0 && ctrlEvent.param < MAX_MIDI_VALUE)
                         {
-                            if (fMidiEventCount >= kPluginMaxMidiEvents*2)
+                            if (! fMidiEvents.hasSpaceFor(fMidiEventCount + fMidiOutEventCount))
                                 continue;
 
-                            VstMidiEvent& vstMidiEvent(fMidiEvents[fMidiEventCount++]);
+                            VstMidiEvent& vstMidiEvent(fMidiEvents.data[fMidiEventCount++]);
                             carla_zeroStruct(vstMidiEvent);
 
                             vstMidiEvent.type        = kVstMidiType;
@@ -1509,10 +1525,10 @@ public:
                     case kEngineControlEventTypeMidiBank:
                         if ((pData->options & PLUGIN_OPTION_SEND_PROGRAM_CHANGES) != 0)
                         {
-                            if (fMidiEventCount >= kPluginMaxMidiEvents*2)
+                            if (! fMidiEvents.hasSpaceFor(fMidiEventCount + fMidiOutEventCount, 2))
                                 continue;
 
-                            VstMidiEvent& vstMidiEvent_MSB(fMidiEvents[fMidiEventCount++]);
+                            VstMidiEvent& vstMidiEvent_MSB(fMidiEvents.data[fMidiEventCount++]);
                             carla_zeroStruct(vstMidiEvent_MSB);
                             vstMidiEvent_MSB.type = kVstMidiType;
                             vstMidiEvent_MSB.byteSize = kVstMidiEventSize;
@@ -1521,7 +1537,7 @@ public:
                             vstMidiEvent_MSB.midiData[1] = MIDI_CONTROL_BANK_SELECT;
                             vstMidiEvent_MSB.midiData[2] = 0;
 
-                            VstMidiEvent& vstMidiEvent_LSB(fMidiEvents[fMidiEventCount++]);
+                            VstMidiEvent& vstMidiEvent_LSB(fMidiEvents.data[fMidiEventCount++]);
                             carla_zeroStruct(vstMidiEvent_LSB);
                             vstMidiEvent_LSB.type        = kVstMidiType;
                             vstMidiEvent_LSB.byteSize    = kVstMidiEventSize;
@@ -1543,10 +1559,10 @@ public:
                         }
                         else if (pData->options & PLUGIN_OPTION_SEND_PROGRAM_CHANGES)
                         {
-                            if (fMidiEventCount >= kPluginMaxMidiEvents*2)
+                            if (! fMidiEvents.hasSpaceFor(fMidiEventCount + fMidiOutEventCount))
                                 continue;
 
-                            VstMidiEvent& vstMidiEvent(fMidiEvents[fMidiEventCount++]);
+                            VstMidiEvent& vstMidiEvent(fMidiEvents.data[fMidiEventCount++]);
                             carla_zeroStruct(vstMidiEvent);
 
                             vstMidiEvent.type        = kVstMidiType;
@@ -1560,10 +1576,10 @@ public:
                     case kEngineControlEventTypeAllSoundOff:
                         if (pData->options & PLUGIN_OPTION_SEND_ALL_SOUND_OFF)
                         {
-                            if (fMidiEventCount >= kPluginMaxMidiEvents*2)
+                            if (! fMidiEvents.hasSpaceFor(fMidiEventCount + fMidiOutEventCount))
                                 continue;
 
-                            VstMidiEvent& vstMidiEvent(fMidiEvents[fMidiEventCount++]);
+                            VstMidiEvent& vstMidiEvent(fMidiEvents.data[fMidiEventCount++]);
                             carla_zeroStruct(vstMidiEvent);
 
                             vstMidiEvent.type        = kVstMidiType;
@@ -1585,10 +1601,10 @@ public:
                             }
 #endif
 
-                            if (fMidiEventCount >= kPluginMaxMidiEvents*2)
+                            if (! fMidiEvents.hasSpaceFor(fMidiEventCount + fMidiOutEventCount))
                                 continue;
 
-                            VstMidiEvent& vstMidiEvent(fMidiEvents[fMidiEventCount++]);
+                            VstMidiEvent& vstMidiEvent(fMidiEvents.data[fMidiEventCount++]);
                             carla_zeroStruct(vstMidiEvent);
 
                             vstMidiEvent.type        = kVstMidiType;
@@ -1603,7 +1619,7 @@ public:
                 } // case kEngineEventTypeControl
 
                 case kEngineEventTypeMidi: {
-                    if (fMidiEventCount >= kPluginMaxMidiEvents*2)
+                    if (! fMidiEvents.hasSpaceFor(fMidiEventCount + fMidiOutEventCount))
                         continue;
 
                     const EngineMidiEvent& midiEvent(event.midi);
@@ -1631,7 +1647,7 @@ public:
                     if (status == MIDI_STATUS_NOTE_ON && midiEvent.data[2] == 0)
                         status = MIDI_STATUS_NOTE_OFF;
 
-                    VstMidiEvent& vstMidiEvent(fMidiEvents[fMidiEventCount++]);
+                    VstMidiEvent& vstMidiEvent(fMidiEvents.data[fMidiEventCount++]);
                     carla_zeroStruct(vstMidiEvent);
 
                     vstMidiEvent.type        = kVstMidiType;
@@ -1674,13 +1690,10 @@ public:
 
         if (pData->event.portOut != nullptr)
         {
-            // reverse lookup MIDI events
-            for (uint32_t k = (kPluginMaxMidiEvents*2)-1; k >= fMidiEventCount; --k)
+            // output events are stored from the end of the storage backwards
+            for (uint32_t i=0; i < fMidiOutEventCount; ++i)
             {
-                if (fMidiEvents[k].type == 0)
-                    break;
-
-                const VstMidiEvent& vstMidiEvent(fMidiEvents[k]);
+                const VstMidiEvent& vstMidiEvent(fMidiEvents.data[fMidiEvents.capacity - 1 - i]);
 
                 CARLA_SAFE_ASSERT_CONTINUE(vstMidiEvent.deltaFrames >= 0);
                 CARLA_SAFE_ASSERT_CONTINUE(vstMidiEvent.midiData[0] != 0);
@@ -1761,9 +1774,9 @@ public:
 
         if (fMidiEventCount > 0)
         {
-            fEvents.numEvents = static_cast<int32_t>(fMidiEventCount);
-            fEvents.reserved  = 0;
-            dispatcher(effProcessEvents, 0, 0, &fEvents, 0.0f);
+            fEvents->numEvents = static_cast<int32_t>(fMidiEventCount);
+            fEvents->reserved  = nullptr;
+            dispatcher(effProcessEvents, 0, 0, fEvents, 0.0f);
         }
 
         // --------------------------------------------------------------------------------------------------------
@@ -2098,12 +2111,9 @@ protected:
             CARLA_SAFE_ASSERT_RETURN(fIsProcessing, 0);
             CARLA_SAFE_ASSERT_RETURN(pData->event.portOut != nullptr, 0);
 
-            if (fMidiEventCount >= kPluginMaxMidiEvents*2-1)
-                return 0;
-
             if (const VstEvents* const vstEvents = (const VstEvents*)ptr)
             {
-                for (int32_t i=0; i < vstEvents->numEvents && i < kPluginMaxMidiEvents*2; ++i)
+                for (int32_t i=0; i < vstEvents->numEvents; ++i)
                 {
                     if (vstEvents->events[i] == nullptr)
                         break;
@@ -2113,15 +2123,15 @@ protected:
                     if (vstMidiEvent->type != kVstMidiType)
                         continue;
 
-                    // reverse-find first free event, and put it there
-                    for (uint32_t j=(kPluginMaxMidiEvents*2)-1; j >= fMidiEventCount; --j)
-                    {
-                        if (fMidiEvents[j].type == 0)
-                        {
-                            std::memcpy(&fMidiEvents[j], vstMidiEvent, sizeof(VstMidiEvent));
-                            break;
-                        }
-                    }
+                    // output events share the storage with input ones, growing from its end.
+                    // the engine cannot take more than kMaxEngineEventInternalCount of them, so extra ones
+                    // are dropped instead of asking for more space, which is only done for input events.
+                    if (fMidiOutEventCount >= kMaxEngineEventInternalCount
+                        || fMidiEventCount + fMidiOutEventCount >= fMidiEvents.capacity)
+                        break;
+
+                    std::memcpy(&fMidiEvents.data[fMidiEvents.capacity - 1 - fMidiOutEventCount++],
+                                vstMidiEvent, sizeof(VstMidiEvent));
                 }
             }
             ret = 1;
@@ -2715,13 +2725,46 @@ public:
     }
 
 private:
+    // needs the plugin to be disabled, or its master mutex locked
+    bool resizeMidiEvents(const uint32_t capacity) noexcept
+    {
+        if (fEvents != nullptr && capacity <= fMidiEvents.capacity)
+        {
+            fMidiEvents.needsMoreSpace = false;
+            return true;
+        }
+
+        // VstEvents ends in a 2-sized array, the remaining pointers follow it
+        VstEvents* const events = (VstEvents*)std::calloc(1, sizeof(VstEvents) + sizeof(VstEvent*)*capacity);
+        CARLA_SAFE_ASSERT_RETURN(events != nullptr, false);
+
+        if (! fMidiEvents.resize(capacity))
+        {
+            std::free(events);
+            return false;
+        }
+
+        VstEvent** const list = events->events;
+
+        for (uint32_t i=0; i < fMidiEvents.capacity; ++i)
+            list[i] = (VstEvent*)&fMidiEvents.data[i];
+
+        std::free(fEvents);
+        fEvents = events;
+
+        fMidiEventCount = 0;
+        fMidiOutEventCount = 0;
+        return true;
+    }
+
     int fUnique1;
 
     AEffect* fEffect;
 
-    uint32_t     fMidiEventCount;
-    VstMidiEvent fMidiEvents[kPluginMaxMidiEvents*2];
-    VstTimeInfo  fTimeInfo;
+    uint32_t fMidiEventCount;
+    uint32_t fMidiOutEventCount;
+    PluginMidiEventStorage<VstMidiEvent> fMidiEvents;
+    VstTimeInfo fTimeInfo;
 
     bool  fNeedIdle;
     void* fLastChunk;
@@ -2742,20 +2785,7 @@ private:
     float** fAudioOutBuffers;
     EngineTimeInfo fLastTimeInfo;
 
-    struct FixedVstEvents {
-        int32_t numEvents;
-        intptr_t reserved;
-        VstEvent* data[kPluginMaxMidiEvents*2];
-
-        FixedVstEvents() noexcept
-            : numEvents(0),
-              reserved(0)
-        {
-            carla_zeroPointers(data, kPluginMaxMidiEvents*2);
-        }
-
-        CARLA_DECLARE_NON_COPYABLE(FixedVstEvents);
-    } fEvents;
+    VstEvents* fEvents; // list for effProcessEvents, pointing to all of fMidiEvents
 
     struct UI {
         bool isEmbed;
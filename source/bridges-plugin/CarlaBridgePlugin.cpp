@@ -624,7 +624,7 @@ int main(int argc, char* argv[])
 
                 if (const CarlaPluginInfo* const pluginInfo = carla_get_plugin_info(gHostHandle, 0))
                 {
-                    if (itype == CARLA_BACKEND_NAMESPACE::PLUGIN_INTERNAL && (std::strcmp(label, "audiofile") == 0 || std::strcmp(label, "midifile") == 0))
+                    if (itype == CARLA_BACKEND_NAMESPACE::PLUGIN_INTERNAL && (std::strcmp(label, "audiofile") == 0 || std::strcmp(label, "audiofile8") == 0 || std::strcmp(label, "midifile") == 0))
                     {
                         if (file.exists())
                             carla_set_custom_data(gHostHandle, 0,
@@ -493,14 +493,9 @@ static void do_dssi_check(lib_t& libHandle, const char* const filename, const bo
             DISCOVERY_OUT("error", "Plugin '" << ldescriptor->Name << "' has no cleanup()");
             continue;
         }
-        if (ldescriptor->run == nullptr && descriptor->run_synth == nullptr)
+        if (ldescriptor->run == nullptr && descriptor->run_synth == nullptr && descriptor->run_multiple_synths == nullptr)
         {
-            DISCOVERY_OUT("error", "Plugin '" << ldescriptor->Name << "' has no run() or run_synth()");
-            continue;
-        }
-        if (descriptor->run_synth == nullptr && descriptor->run_multiple_synths != nullptr)
-        {
-            DISCOVERY_OUT("error", "Plugin '" << ldescriptor->Name << "' requires run_multiple_synths which is not supported");
+            DISCOVERY_OUT("error", "Plugin '" << ldescriptor->Name << "' has no run(), run_synth() or run_multiple_synths()");
             continue;
         }
         if (! LADSPA_IS_HARD_RT_CAPABLE(ldescriptor->Properties))
@@ -545,7 +540,7 @@ static void do_dssi_check(lib_t& libHandle, const char* const filename, const bo
             }
         }
 
-        if (descriptor->run_synth != nullptr)
+        if (descriptor->run_synth != nullptr || descriptor->run_multiple_synths != nullptr)
             midiIns = 1;
 
         if (midiIns > 0 && audioIns == 0 && audioOuts > 0)
@@ -661,12 +656,12 @@ static void do_dssi_check(lib_t& libHandle, const char* const filename, const bo
             if (ldescriptor->activate != nullptr)
                 ldescriptor->activate(handle);
 
-            if (descriptor->run_synth != nullptr)
+            if (descriptor->run_synth != nullptr || descriptor->run_multiple_synths != nullptr)
             {
                 snd_seq_event_t midiEvents[2];
                 carla_zeroStructs(midiEvents, 2);
 
-                const unsigned long midiEventCount = 2;
+                unsigned long midiEventCount = 2;
 
                 midiEvents[0].type = SND_SEQ_EVENT_NOTEON;
                 midiEvents[0].data.note.note     = 64;
@@ -677,7 +672,15 @@ static void do_dssi_check(lib_t& libHandle, const char* const filename, const bo
                 midiEvents[1].data.note.velocity = 0;
                 midiEvents[1].time.tick = kBufferSize/2;
 
-                descriptor->run_synth(handle, kBufferSize, midiEvents, midiEventCount);
+                if (descriptor->run_synth != nullptr)
+                {
+                    descriptor->run_synth(handle, kBufferSize, midiEvents, midiEventCount);
+                }
+                else
+                {
+                    snd_seq_event_t* midiEventsPtr = midiEvents;
+                    descriptor->run_multiple_synths(1, &handle, kBufferSize, &midiEventsPtr, &midiEventCount);
+                }
             }
             else
                 ldescriptor->run(handle, kBufferSize);
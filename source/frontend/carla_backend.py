@@ -249,6 +249,13 @@ PLUGIN_OPTION_SEND_PROGRAM_CHANGES = 0x200
 # We always want notes enabled by default, not the contrary.
 PLUGIN_OPTION_SKIP_SENDING_NOTES = 0x400
 
+# Process both channels of a forced stereo plugin through a single instance, one channel after the other.
+# Only valid for mono effects without internal per-channel state (delay lines, filters, envelopes, etc),
+# as that state would otherwise be shared between channels.
+# Plugins cannot declare that, so this is only available for a built-in list of known stateless plugins.
+# Has no effect unless PLUGIN_OPTION_FORCE_STEREO is also set.
+PLUGIN_OPTION_FORCE_STEREO_SINGLE_INSTANCE = 0x800
+
 # Special flag to indicate that plugin options are not yet set.
 # This flag exists because 0x0 as an option value is a valid one, so we need something else to indicate "null-ness".
 PLUGIN_OPTIONS_NULL = 0x10000
@@ -841,6 +848,27 @@ ENGINE_CALLBACK_PARAMETER_MAPPED_RANGE_CHANGED = 46
 # @a valuef   Y position 2
 ENGINE_CALLBACK_PATCHBAY_CLIENT_POSITION_CHANGED = 47
 
+# A plugin embed UI has been resized.
+# @a pluginId Plugin Id to resize
+# @a value1   New width
+# @a value2   New height
+ENGINE_CALLBACK_EMBED_UI_RESIZED = 48
+
+# A plugin bridge is close to missing its deadlines or timing out.
+# Sent at most once per second while the bridge keeps misbehaving.
+# @a pluginId Plugin Id
+# @a value1   Number of missed deadlines since the last warning
+# @a value2   Worst round-trip time since the last warning, in microseconds
+# @a value3   Number of page faults in the bridge process thread since the last warning
+# @a valuef   Worst round-trip time relative to the block duration, in percent
+ENGINE_CALLBACK_BRIDGE_HEALTH_WARNING = 49
+
+# Progress of an offline render started with carla_render_to_file().
+# @a value1   Progress, in percent
+# @a value2   1 when the render has finished, 0 otherwise
+# @a valueStr Main output filename
+ENGINE_CALLBACK_RENDER_PROGRESS = 50
+
 # ---------------------------------------------------------------------------------------------------------------------
 # NSM Callback Opcode
 # NSM callback opcodes.
@@ -1026,6 +1054,40 @@ ENGINE_OPTION_CLIENT_NAME_PREFIX = 34
 # Treat loaded plugins as standalone (that is, there is no host UI to manage them)
 ENGINE_OPTION_PLUGINS_ARE_STANDALONE = 35
 
+# Automatically restart plugin bridges that stopped responding, restoring their last known state.
+# Default is no.
+ENGINE_OPTION_RESTART_HUNG_BRIDGES = 36
+
+# Keep JACK applications running when their plugin is removed, so that loading a project using
+# the same applications reuses them instead of starting them again.
+# Unused applications are closed after the next project load, or when the engine closes.
+# Default is no.
+ENGINE_OPTION_RESIDENT_JACK_APPS = 37
+
+# Process plugins as a pipeline over all CPU cores while rendering offline (rack mode only).
+# Each plugin works on its own block at the same time, adding (number of plugins - 1) blocks of latency.
+# Default is no.
+ENGINE_OPTION_OFFLINE_PIPELINE = 38
+
+# Number of CPU cores each FluidSynth instance may use to render its voices.
+# Values above 1 enable the FluidSynth parallel renderer, which runs its own realtime worker threads.
+# Applies to SoundFonts loaded afterwards.
+# Default is 1.
+ENGINE_OPTION_FLUIDSYNTH_CPU_CORES = 39
+
+# Lock all process memory into RAM and prefault the stack of audio threads,
+# so buffers allocated for plugins and the engine never page fault while processing.
+# Applies when the engine starts.
+# Default is no.
+ENGINE_OPTION_LOCK_MEMORY = 40
+
+# Time in milliseconds over which automation and MIDI CC changes of plugin control ports are ramped.
+# Ramps advance at a fixed control rate, so parameter events no longer need to split the audio block.
+# Only applies to LADSPA, DSSI and LV2 control ports, set to 0 to apply changes as steps.
+# Applies to plugins loaded afterwards.
+# Default is 0.
+ENGINE_OPTION_PARAMETER_SMOOTHING_TIME = 41
+
 # ---------------------------------------------------------------------------------------------------------------------
 # Engine Process Mode
 # Engine process mode.
@@ -1405,7 +1467,14 @@ class CarlaRuntimeEngineInfo(Structure):
         ("load", c_float),
 
         # Number of xruns.
-        ("xruns", c_uint32)
+        ("xruns", c_uint32),
+
+        # Number of minor page faults taken by audio threads while processing, since the engine started.
+        # Only counted while ENGINE_OPTION_LOCK_MEMORY is enabled.
+        ("minorPageFaults", c_uint32),
+
+        # Number of major page faults taken by audio threads while processing, since the engine started.
+        ("majorPageFaults", c_uint32)
     ]
 
 # Runtime engine driver device information.
@@ -1497,7 +1566,9 @@ PyCarlaTransportInfo = {
 # @see CarlaRuntimeEngineInfo
 PyCarlaRuntimeEngineInfo = {
     'load': 0.0,
-    'xruns': 0
+    'xruns': 0,
+    'minorPageFaults': 0,
+    'majorPageFaults': 0
 }
 
 # @see CarlaRuntimeEngineDriverDeviceInfo
@@ -1698,6 +1769,16 @@ class CarlaHostMeta():
     def clear_project_filename(self):
         raise NotImplementedError
 
+    # Render the current project offline into a file, plus one stem file per listed plugin.
+    # Progress is reported through ENGINE_CALLBACK_RENDER_PROGRESS.
+    # Stems are per plugin only, individual patchbay ports cannot be rendered as stems yet.
+    # @param startFrame     First frame to render
+    # @param endFrame       Frame where rendering stops
+    # @param stemPluginIds  Plugin Ids to write as separate stems
+    @abstractmethod
+    def render_to_file(self, filename, startFrame, endFrame, stemPluginIds):
+        raise NotImplementedError
+
     # Connect two patchbay ports.
     # @param groupIdA Output group
     # @param portIdA  Output port
@@ -2345,6 +2426,9 @@ class CarlaHostNull(CarlaHostMeta):
     def clear_project_filename(self):
         return
 
+    def render_to_file(self, filename, startFrame, endFrame, stemPluginIds):
+        return False
+
     def patchbay_connect(self, external, groupIdA, portIdA, groupIdB, portIdB):
         return False
 
@@ -2666,6 +2750,9 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_clear_project_filename.argtypes = (c_void_p,)
         self.lib.carla_clear_project_filename.restype = None
 
+        self.lib.carla_render_to_file.argtypes = (c_void_p, c_char_p, c_uint64, c_uint64, POINTER(c_uint), c_uint)
+        self.lib.carla_render_to_file.restype = c_bool
+
         self.lib.carla_patchbay_connect.argtypes = (c_void_p, c_bool, c_uint, c_uint, c_uint, c_uint)
         self.lib.carla_patchbay_connect.restype = c_bool
 
@@ -2982,6 +3069,12 @@ class CarlaHostDLL(CarlaHostMeta):
     def clear_project_filename(self):
         self.lib.carla_clear_project_filename(self.handle)
 
+    def render_to_file(self, filename, startFrame, endFrame, stemPluginIds):
+        stemCount = len(stemPluginIds)
+        stemArray = (c_uint * stemCount)(*stemPluginIds)
+        return bool(self.lib.carla_render_to_file(self.handle, filename.encode("utf-8"),
+                                                  startFrame, endFrame, stemArray, stemCount))
+
     def patchbay_connect(self, external, groupIdA, portIdA, groupIdB, portIdB):
         return bool(self.lib.carla_patchbay_connect(self.handle, external, groupIdA, portIdA, groupIdB, portIdB))
 
@@ -3300,7 +3393,9 @@ class CarlaHostPlugin(CarlaHostMeta):
         # runtime engine info
         self.fRuntimeEngineInfo = {
             "load": 0.0,
-            "xruns": 0
+            "xruns": 0,
+            "minorPageFaults": 0,
+            "majorPageFaults": 0
         }
 
         # transport info
@@ -3390,6 +3485,9 @@ class CarlaHostPlugin(CarlaHostMeta):
     def clear_project_filename(self):
         return self.sendMsgAndSetError(["clear_project_filename"])
 
+    def render_to_file(self, filename, startFrame, endFrame, stemPluginIds):
+        return False
+
     def patchbay_connect(self, external, groupIdA, portIdA, groupIdB, portIdB):
         return self.sendMsgAndSetError(["patchbay_connect", external, groupIdA, portIdA, groupIdB, portIdB])
 
@@ -3667,7 +3765,9 @@ class CarlaHostPlugin(CarlaHostMeta):
     def _set_runtime_info(self, load, xruns):
         self.fRuntimeEngineInfo = {
             "load": load,
-            "xruns": xruns
+            "xruns": xruns,
+            "minorPageFaults": 0,
+            "majorPageFaults": 0
         }
 
     def _set_transport(self, playing, frame, bar, beat, tick, bpm):
@@ -1272,6 +1272,7 @@ bool CarlaJackAppClient::handleNonRtData()
         case kPluginBridgeNonRtClientUiMidiProgramChange:
         case kPluginBridgeNonRtClientUiNoteOn:
         case kPluginBridgeNonRtClientUiNoteOff:
+        case kPluginBridgeNonRtClientGetParameterInfo:
             break;
 
         case kPluginBridgeNonRtClientEmbedUI:
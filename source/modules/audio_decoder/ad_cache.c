@@ -0,0 +1,204 @@
+/**
+   Copyright (C) 2026 agent <agent@local>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 2.1, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "ad_plugin.h"
+
+/* persistent seek-data cache
+ *
+ * Decoders that need to scan a whole file to learn its length or build a seek table
+ * store the result here, one small file per source under the user cache directory.
+ * Entries are keyed by path, size and modification time, so an edited source is rescanned.
+ *
+ * Only the dr_mp3 and minimp3 backends use it. ffmpeg and libsndfile probe files inside the library
+ * (avformat_find_stream_info, sf_open), neither accepts a stored index, and their seeking is already
+ * done by the library without a full scan.
+ */
+
+#define AD_CACHE_MAGIC "ADCACHE1"
+
+struct ad_cache_header {
+	char     magic[8];
+	char     backend[16];
+	uint64_t file_size;
+	int64_t  file_mtime;
+	uint32_t path_len;
+	uint32_t reserved;
+	uint64_t data_size;
+};
+
+static int ad_cache_mkdir(const char *dir) {
+#ifdef _WIN32
+	return mkdir(dir);
+#else
+	return mkdir(dir, 0755);
+#endif
+}
+
+/* returns 0 if @path was filled with the cache entry location for @fn */
+static int ad_cache_entry_path(const char *fn, const char *backend, char *path, size_t path_size, int create) {
+	const char *base;
+	const char *sub;
+	char dir[PATH_MAX];
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	const unsigned char *c;
+
+	sub = "";
+#ifdef _WIN32
+	if ((base = getenv("LOCALAPPDATA")) == NULL || *base == '\0')
+		return -1;
+#else
+	if ((base = getenv("XDG_CACHE_HOME")) == NULL || *base == '\0') {
+		if ((base = getenv("HOME")) == NULL || *base == '\0')
+			return -1;
+		sub = "/.cache";
+	}
+#endif
+
+	/* FNV-1a of the full path, the path itself is stored and compared on load */
+	for (c = (const unsigned char*)fn; *c; ++c) {
+		hash ^= *c;
+		hash *= 0x100000001b3ULL;
+	}
+
+	if (create) {
+		snprintf(dir, sizeof(dir), "%s%s", base, sub);
+		ad_cache_mkdir(dir);
+		snprintf(dir, sizeof(dir), "%s%s/carla", base, sub);
+		ad_cache_mkdir(dir);
+		snprintf(dir, sizeof(dir), "%s%s/carla/audio-decoder", base, sub);
+		ad_cache_mkdir(dir);
+	}
+
+	if (snprintf(path, path_size, "%s%s/carla/audio-decoder/%s-%016" PRIx64 ".seek",
+	             base, sub, backend, hash) >= (int)path_size)
+		return -1;
+	return 0;
+}
+
+static int ad_cache_stat(const char *fn, uint64_t *size, int64_t *mtime) {
+	struct stat st;
+	if (stat(fn, &st) != 0)
+		return -1;
+	*size = (uint64_t)st.st_size;
+	*mtime = (int64_t)st.st_mtime;
+	return 0;
+}
+
+void *ad_cache_load(const char *fn, const char *backend, size_t *size) {
+	struct ad_cache_header hdr;
+	char path[PATH_MAX];
+	char *stored_fn = NULL;
+	void *data = NULL;
+	uint64_t file_size;
+	int64_t file_mtime;
+	const size_t fn_len = fn ? strlen(fn) : 0;
+	FILE *f;
+
+	*size = 0;
+
+	if (!fn)
+		return NULL;
+	if (ad_cache_stat(fn, &file_size, &file_mtime) != 0)
+		return NULL;
+	if (ad_cache_entry_path(fn, backend, path, sizeof(path), 0) != 0)
+		return NULL;
+	if ((f = fopen(path, "rb")) == NULL)
+		return NULL;
+
+	if (fread(&hdr, sizeof(hdr), 1, f) != 1
+			|| memcmp(hdr.magic, AD_CACHE_MAGIC, sizeof(hdr.magic)) != 0
+			|| strncmp(hdr.backend, backend, sizeof(hdr.backend)) != 0
+			|| hdr.file_size != file_size
+			|| hdr.file_mtime != file_mtime
+			|| hdr.path_len != fn_len
+			|| hdr.data_size == 0 || hdr.data_size > SIZE_MAX) {
+		goto fail;
+	}
+
+	stored_fn = (char*) malloc(fn_len);
+	if (!stored_fn || fread(stored_fn, fn_len, 1, f) != 1 || memcmp(stored_fn, fn, fn_len) != 0)
+		goto fail;
+
+	data = malloc((size_t)hdr.data_size);
+	if (!data || fread(data, (size_t)hdr.data_size, 1, f) != 1)
+		goto fail;
+
+	free(stored_fn);
+	fclose(f);
+	*size = (size_t)hdr.data_size;
+	dbg(1, "using cached seek data for '%s'", fn);
+	return data;
+
+fail:
+	free(stored_fn);
+	free(data);
+	fclose(f);
+	return NULL;
+}
+
+void ad_cache_store(const char *fn, const char *backend, const void *data, size_t size) {
+	struct ad_cache_header hdr;
+	char path[PATH_MAX];
+	char tmp_path[PATH_MAX + 32];
+	FILE *f;
+	int ok;
+
+	if (!fn || size == 0)
+		return;
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, AD_CACHE_MAGIC, sizeof(hdr.magic));
+	strncpy(hdr.backend, backend, sizeof(hdr.backend) - 1);
+	hdr.path_len = (uint32_t)strlen(fn);
+	hdr.data_size = size;
+
+	if (ad_cache_stat(fn, &hdr.file_size, &hdr.file_mtime) != 0)
+		return;
+	if (ad_cache_entry_path(fn, backend, path, sizeof(path), 1) != 0)
+		return;
+
+	/* write to a private file first, so concurrent readers never see a partial entry */
+	snprintf(tmp_path, sizeof(tmp_path), "%s.%i.tmp", path, (int)getpid());
+
+	if ((f = fopen(tmp_path, "wb")) == NULL) {
+		dbg(1, "unable to write seek cache '%s'", tmp_path);
+		return;
+	}
+
+	ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1
+	  && fwrite(fn, hdr.path_len, 1, f) == 1
+	  && fwrite(data, size, 1, f) == 1;
+
+	if (fclose(f) != 0)
+		ok = 0;
+
+#ifdef _WIN32
+	if (ok)
+		remove(path);
+#endif
+	if (!ok || rename(tmp_path, path) != 0)
+		remove(tmp_path);
+}
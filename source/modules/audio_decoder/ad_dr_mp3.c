@@ -17,6 +17,7 @@
 
 */
 
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -37,15 +38,53 @@
 
 typedef struct {
 	drmp3 mp3;
+	drmp3_uint64 frames;
 	drmp3_seek_point seekPoints[DR_MP3_MAX_SEEK_POINTS];
 } drmp3_audio_decoder;
 
+/* seek cache entry, only the used seek points are stored */
+typedef struct {
+	drmp3_uint64 frames;
+	drmp3_uint32 seekPointCount;
+	drmp3_uint32 reserved;
+	drmp3_seek_point seekPoints[DR_MP3_MAX_SEEK_POINTS];
+} drmp3_seek_cache;
+
+#define DR_MP3_SEEK_CACHE_SIZE(count) (offsetof(drmp3_seek_cache, seekPoints) + (count) * sizeof(drmp3_seek_point))
+
+static int load_seek_cache(drmp3_audio_decoder *priv, const char *filename, drmp3_uint32 *seekPointCount) {
+	size_t size;
+	drmp3_seek_cache *cache = (drmp3_seek_cache*) ad_cache_load (filename, "dr_mp3", &size);
+	if (!cache) return 0;
+	if (size < DR_MP3_SEEK_CACHE_SIZE(0)
+			|| cache->seekPointCount > DR_MP3_MAX_SEEK_POINTS
+			|| size != DR_MP3_SEEK_CACHE_SIZE(cache->seekPointCount)) {
+		free (cache);
+		return 0;
+	}
+	priv->frames = cache->frames;
+	*seekPointCount = cache->seekPointCount;
+	memcpy (priv->seekPoints, cache->seekPoints, cache->seekPointCount * sizeof(drmp3_seek_point));
+	free (cache);
+	return 1;
+}
+
+static void store_seek_cache(const drmp3_audio_decoder *priv, const char *filename, drmp3_uint32 seekPointCount) {
+	drmp3_seek_cache *cache = (drmp3_seek_cache*) calloc (1, sizeof(drmp3_seek_cache));
+	if (!cache) return;
+	cache->frames = priv->frames;
+	cache->seekPointCount = seekPointCount;
+	memcpy (cache->seekPoints, priv->seekPoints, seekPointCount * sizeof(drmp3_seek_point));
+	ad_cache_store (filename, "dr_mp3", cache, DR_MP3_SEEK_CACHE_SIZE(seekPointCount));
+	free (cache);
+}
+
 static int ad_info_dr_mp3(void *sf, struct adinfo *nfo) {
 	drmp3_audio_decoder *priv = (drmp3_audio_decoder*) sf;
 	if (!priv) return -1;
 	if (nfo) {
 		nfo->channels = priv->mp3.channels;
-		nfo->frames = drmp3_get_pcm_frame_count(&priv->mp3);
+		nfo->frames = priv->frames;
 		nfo->sample_rate = priv->mp3.sampleRate;
 		nfo->length = nfo->sample_rate ? (nfo->frames * 1000) / nfo->sample_rate : 0;
 		nfo->bit_depth = 16;
@@ -65,7 +104,13 @@ static void *ad_open_dr_mp3(const char *filename, struct adinfo *nfo) {
 		return NULL;
 	}
 	drmp3_uint32 seekPointCount = DR_MP3_MAX_SEEK_POINTS;
-	drmp3_calculate_seek_points (&priv->mp3, &seekPointCount, priv->seekPoints);
+	/* both of these scan the whole file, reuse previous results when possible */
+	if (!load_seek_cache (priv, filename, &seekPointCount)) {
+		if (!drmp3_calculate_seek_points (&priv->mp3, &seekPointCount, priv->seekPoints))
+			seekPointCount = 0;
+		priv->frames = drmp3_get_pcm_frame_count (&priv->mp3);
+		store_seek_cache (priv, filename, seekPointCount);
+	}
 	drmp3_bind_seek_table (&priv->mp3, seekPointCount, priv->seekPoints);
 	ad_info_dr_mp3 (priv, nfo);
 	return (void*) priv;
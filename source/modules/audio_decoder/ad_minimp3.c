@@ -41,8 +41,59 @@
 
 typedef struct {
 	mp3dec_ex_t dec_ex;
+	const char *filename;
+	int index_cached;
 } minimp3_audio_decoder;
 
+/* seek cache entry, followed by the frame index */
+typedef struct {
+	uint64_t samples;
+	uint64_t num_frames;
+} minimp3_seek_cache;
+
+static int load_seek_cache(minimp3_audio_decoder *priv) {
+	size_t size;
+	minimp3_seek_cache *cache = (minimp3_seek_cache*) ad_cache_load (priv->filename, "minimp3", &size);
+	if (!cache) return 0;
+	if (size < sizeof(minimp3_seek_cache)
+			|| cache->num_frames == 0
+			|| cache->num_frames > (size - sizeof(minimp3_seek_cache)) / sizeof(mp3dec_frame_t)
+			|| size != sizeof(minimp3_seek_cache) + cache->num_frames * sizeof(mp3dec_frame_t)) {
+		free (cache);
+		return 0;
+	}
+	mp3dec_frame_t *frames = (mp3dec_frame_t*) malloc (cache->num_frames * sizeof(mp3dec_frame_t));
+	if (!frames) {
+		free (cache);
+		return 0;
+	}
+	memcpy (frames, cache + 1, cache->num_frames * sizeof(mp3dec_frame_t));
+	/* replaces what a full scan would have built, mp3dec_ex_close frees it */
+	free (priv->dec_ex.index.frames);
+	priv->dec_ex.index.frames = frames;
+	priv->dec_ex.index.num_frames = priv->dec_ex.index.capacity = (size_t)cache->num_frames;
+	priv->dec_ex.samples = cache->samples;
+	priv->dec_ex.indexes_built = 1;
+	free (cache);
+	return 1;
+}
+
+/* the index is built during open, or on the first seek for files with a VBR tag */
+static void store_seek_cache(minimp3_audio_decoder *priv) {
+	const mp3dec_index_t *index = &priv->dec_ex.index;
+	if (priv->index_cached || !priv->dec_ex.indexes_built || !index->frames || !index->num_frames)
+		return;
+	const size_t size = sizeof(minimp3_seek_cache) + index->num_frames * sizeof(mp3dec_frame_t);
+	minimp3_seek_cache *cache = (minimp3_seek_cache*) malloc (size);
+	if (!cache) return;
+	cache->samples = priv->dec_ex.samples;
+	cache->num_frames = index->num_frames;
+	memcpy (cache + 1, index->frames, index->num_frames * sizeof(mp3dec_frame_t));
+	ad_cache_store (priv->filename, "minimp3", cache, size);
+	free (cache);
+	priv->index_cached = 1;
+}
+
 static void err_to_string(int err_code, char *buf) {
 	switch (err_code)
 	{
@@ -85,16 +136,33 @@ static int ad_info_minimp3(void *sf, struct adinfo *nfo) {
 
 static void *ad_open_minimp3(const char *filename, struct adinfo *nfo) {
 	minimp3_audio_decoder *priv = (minimp3_audio_decoder*)calloc (1, sizeof(minimp3_audio_decoder));
-	int res = mp3dec_ex_open(&priv->dec_ex, filename, MP3D_SEEK_TO_SAMPLE);
+	if (!priv) return NULL;
+	priv->filename = strdup (filename);
+	if (!priv->filename) {
+		free (priv);
+		return NULL;
+	}
+	/* skip the full scan when a previous one was cached */
+	int res = mp3dec_ex_open(&priv->dec_ex, filename, MP3D_SEEK_TO_SAMPLE | MP3D_DO_NOT_SCAN);
+	if (!res) {
+		if (load_seek_cache (priv)) {
+			priv->index_cached = 1;
+		} else {
+			mp3dec_ex_close (&priv->dec_ex);
+			res = mp3dec_ex_open(&priv->dec_ex, filename, MP3D_SEEK_TO_SAMPLE);
+		}
+	}
 	if (res) {
 		dbg(0, "unable to open file '%s'.", filename);
 		char err_str[600];
 		err_to_string (res, err_str);
 		puts (err_str);
 		dbg (0, "error=%i", res);
+		free ((void*)priv->filename);
 		free (priv);
 		return NULL;
 	}
+	store_seek_cache (priv);
 	ad_info_minimp3 (priv, nfo);
 	return (void*) priv;
 }
@@ -106,7 +174,9 @@ static int ad_close_minimp3(void *sf) {
 		dbg (0, "fatal: bad file close.\n");
 		return -1;
 	}
+	store_seek_cache (priv);
 	mp3dec_ex_close (&priv->dec_ex);
+	free ((void*)priv->filename);
 	free (priv);
 	return 0;
 }
@@ -37,6 +37,9 @@
 #ifndef PRIi64
 # define PRIi64   __PRI64_PREFIX "i"
 #endif
+#ifndef PRIx64
+# define PRIx64   __PRI64_PREFIX "x"
+#endif
 
 extern int ad_debug_level;
 
@@ -60,6 +63,11 @@ int64_t ad_seek_null(void *, int64_t);
 ssize_t ad_read_null(void *, float*, size_t);
 int     ad_bitrate_null(void *);
 
+/* persistent seek-data cache, keyed by file path, size and mtime
+ * ad_cache_load returns a malloc'ed copy of the stored data, or NULL if there is no valid entry */
+void *  ad_cache_load(const char *fn, const char *backend, size_t *size);
+void    ad_cache_store(const char *fn, const char *backend, const void *data, size_t size);
+
 /* hardcoded backends */
 const ad_plugin * adp_get_sndfile();
 const ad_plugin * adp_get_dr_mp3();
@@ -108,7 +108,8 @@ static const NativePluginDescriptor sNativePluginDescriptors[] = {
 },
 {
     /* category  */ NATIVE_PLUGIN_CATEGORY_UTILITY,
-    /* hints     */ NATIVE_PLUGIN_IS_RTSAFE,
+    /* hints     */ static_cast<NativePluginHints>(NATIVE_PLUGIN_IS_RTSAFE
+                                                  |NATIVE_PLUGIN_USES_CONTROL_VOLTAGE),
     /* supports  */ NATIVE_PLUGIN_SUPPORTS_NOTHING,
     /* audioIns  */ 0,
     /* audioOuts */ 0,
@@ -120,7 +121,13 @@ static const NativePluginDescriptor sNativePluginDescriptors[] = {
     /* label     */ "lfo",
     /* maker     */ "falkTX",
     /* copyright */ "GNU GPL v2+",
-    DESCFUNCS_WITHOUTCV
+    DESCFUNCS_WITHCV,
+    /* cvIns      */ 0,
+    /* cvOuts     */ 1,
+    /* bufnamefn  */ nullptr,
+    /* bufrangefn */ nullptr,
+    /* ui_width   */ 0,
+    /* ui_height  */ 0
 },
 {
     /* category  */ NATIVE_PLUGIN_CATEGORY_UTILITY,
@@ -298,6 +305,27 @@ static const NativePluginDescriptor sNativePluginDescriptors[] = {
     /* copyright */ "GNU GPL v2+",
     DESCFUNCS_WITHOUTCV
 },
+{
+    /* category  */ NATIVE_PLUGIN_CATEGORY_UTILITY,
+    /* hints     */ static_cast<NativePluginHints>(NATIVE_PLUGIN_IS_RTSAFE
+                                                  |NATIVE_PLUGIN_HAS_INLINE_DISPLAY
+                                                  |NATIVE_PLUGIN_HAS_UI
+                                                  |NATIVE_PLUGIN_NEEDS_UI_OPEN_SAVE
+                                                  |NATIVE_PLUGIN_REQUESTS_IDLE
+                                                  |NATIVE_PLUGIN_USES_TIME),
+    /* supports  */ NATIVE_PLUGIN_SUPPORTS_NOTHING,
+    /* audioIns  */ 0,
+    /* audioOuts */ 8,
+    /* midiIns   */ 0,
+    /* midiOuts  */ 0,
+    /* paramIns  */ 1,
+    /* paramOuts */ 0,
+    /* name      */ "Audio File (8ch)",
+    /* label     */ "audiofile8",
+    /* maker     */ "falkTX",
+    /* copyright */ "GNU GPL v2+",
+    DESCFUNCS_WITHOUTCV
+},
 
 // --------------------------------------------------------------------------------------------------------------------
 // MIDI file and sequencer
@@ -19,6 +19,8 @@
 #define AUDIO_BASE_HPP_INCLUDED
 
 #include "CarlaMathUtils.hpp"
+#include "CarlaString.hpp"
+#include "CarlaThread.hpp"
 
 extern "C" {
 #include "audio_decoder/ad.h"
@@ -52,9 +54,47 @@ extern "C" {
 
 typedef struct adinfo ADInfo;
 
+// -----------------------------------------------------------------------
+// Deinterleave helper with channel offset and mono/extra channel handling, the stereo case uses the shared kernel
+
+static inline
+void carla_deinterleaveFloats(float* const* const dst, const uint numDstChannels, const uint32_t dstOffset,
+                              const float* const src, const uint numSrcChannels, const uint32_t frames) noexcept
+{
+    switch (numSrcChannels)
+    {
+    case 1:
+        carla_copyFloats(dst[0] + dstOffset, src, frames);
+        return;
+
+    case 2:
+        if (numDstChannels >= 2)
+        {
+            float* const dst2[2] = { dst[0] + dstOffset, dst[1] + dstOffset };
+            carla_deinterleaveFloats(dst2, src, 2, frames);
+            return;
+        }
+        break;
+    }
+
+    for (uint c=0; c<numDstChannels; ++c)
+    {
+        float* const dstc = dst[c] + dstOffset;
+        const float* const srcc = src + c;
+
+        for (uint32_t i=0; i<frames; ++i)
+            dstc[i] = srcc[i*numSrcChannels];
+    }
+}
+
+// -----------------------------------------------------------------------
+
 struct AudioFilePool {
-    float*   buffer[2];
-    float*   tmpbuf[2];
+    static const uint kMaxChannels = 8;
+
+    float*   buffer[kMaxChannels];
+    float*   tmpbuf[kMaxChannels];
+    uint     numChannels;
     uint32_t numFrames;
     uint32_t maxFrame;
     volatile uint64_t startFrame;
@@ -64,18 +104,21 @@ struct AudioFilePool {
     AudioFilePool() noexcept
         : buffer{nullptr},
           tmpbuf{nullptr},
+          numChannels(0),
           numFrames(0),
           maxFrame(0),
           startFrame(0),
           mutex() {}
 #else
     AudioFilePool() noexcept
-        : numFrames(0),
+        : numChannels(0),
+          numFrames(0),
+          maxFrame(0),
           startFrame(0),
           mutex()
     {
-        buffer[0] = buffer[1] = nullptr;
-        tmpbuf[0] = tmpbuf[1] = nullptr;
+        for (uint c=0; c<kMaxChannels; ++c)
+            buffer[c] = tmpbuf[c] = nullptr;
     }
 #endif
 
@@ -84,36 +127,34 @@ struct AudioFilePool {
         destroy();
     }
 
-    void create(const uint32_t desiredNumFrames, const uint32_t fileNumFrames, const bool withTempBuffers)
+    void create(const uint32_t desiredNumFrames, const uint32_t fileNumFrames, const uint desiredNumChannels, const bool withTempBuffers)
     {
         CARLA_ASSERT(buffer[0] == nullptr);
-        CARLA_ASSERT(buffer[1] == nullptr);
         CARLA_ASSERT(tmpbuf[0] == nullptr);
-        CARLA_ASSERT(tmpbuf[1] == nullptr);
         CARLA_ASSERT(startFrame == 0);
+        CARLA_ASSERT(numChannels == 0);
         CARLA_ASSERT(numFrames == 0);
         CARLA_ASSERT(maxFrame == 0);
+        CARLA_SAFE_ASSERT_RETURN(desiredNumChannels > 0 && desiredNumChannels <= kMaxChannels,);
 
-        buffer[0] = new float[desiredNumFrames];
-        buffer[1] = new float[desiredNumFrames];
-        carla_zeroFloats(buffer[0], desiredNumFrames);
-        carla_zeroFloats(buffer[1], desiredNumFrames);
-        CARLA_MLOCK(buffer[0], sizeof(float)*desiredNumFrames);
-        CARLA_MLOCK(buffer[1], sizeof(float)*desiredNumFrames);
-
-        if (withTempBuffers)
+        for (uint c=0; c<desiredNumChannels; ++c)
         {
-            tmpbuf[0] = new float[desiredNumFrames];
-            tmpbuf[1] = new float[desiredNumFrames];
-            carla_zeroFloats(tmpbuf[0], desiredNumFrames);
-            carla_zeroFloats(tmpbuf[1], desiredNumFrames);
-            CARLA_MLOCK(tmpbuf[0], sizeof(float)*desiredNumFrames);
-            CARLA_MLOCK(tmpbuf[1], sizeof(float)*desiredNumFrames);
+            buffer[c] = new float[desiredNumFrames];
+            carla_zeroFloats(buffer[c], desiredNumFrames);
+            CARLA_MLOCK(buffer[c], sizeof(float)*desiredNumFrames);
+
+            if (withTempBuffers)
+            {
+                tmpbuf[c] = new float[desiredNumFrames];
+                carla_zeroFloats(tmpbuf[c], desiredNumFrames);
+                CARLA_MLOCK(tmpbuf[c], sizeof(float)*desiredNumFrames);
+            }
         }
 
         const water::GenericScopedLock<water::SpinLock> gsl(mutex);
 
         startFrame = 0;
+        numChannels = desiredNumChannels;
         numFrames = desiredNumFrames;
         maxFrame = fileNumFrames;
     }
@@ -123,38 +164,52 @@ struct AudioFilePool {
         {
             const water::GenericScopedLock<water::SpinLock> gsl(mutex);
             startFrame = 0;
+            numChannels = 0;
             numFrames = 0;
             maxFrame = 0;
         }
 
-        if (buffer[0] != nullptr)
+        for (uint c=0; c<kMaxChannels; ++c)
         {
-            delete[] buffer[0];
-            buffer[0] = nullptr;
-        }
+            if (buffer[c] != nullptr)
+            {
+                delete[] buffer[c];
+                buffer[c] = nullptr;
+            }
 
-        if (buffer[1] != nullptr)
-        {
-            delete[] buffer[1];
-            buffer[1] = nullptr;
+            if (tmpbuf[c] != nullptr)
+            {
+                delete[] tmpbuf[c];
+                tmpbuf[c] = nullptr;
+            }
         }
+    }
 
-        if (tmpbuf[0] != nullptr)
+    // copy pool frames into the plugin outputs, mono files go to the first 2 outputs
+    // NOTE it is assumed that mutex is locked
+    void copyFrames(float* const* const outs, const uint numOuts, const uint32_t outOffset,
+                    const uint32_t poolOffset, const uint32_t frames) const noexcept
+    {
+        for (uint o=0; o<numOuts; ++o)
         {
-            delete[] tmpbuf[0];
-            tmpbuf[0] = nullptr;
-        }
+            const uint c = numChannels == 1 && o < 2 ? 0 : o;
 
-        if (tmpbuf[1] != nullptr)
-        {
-            delete[] tmpbuf[1];
-            tmpbuf[1] = nullptr;
+            if (c < numChannels)
+                carla_copyFloats(outs[o] + outOffset, buffer[c] + poolOffset, frames);
+            else
+                carla_zeroFloats(outs[o] + outOffset, frames);
         }
     }
 
+    static void zeroFrames(float* const* const outs, const uint numOuts, const uint32_t outOffset, const uint32_t frames) noexcept
+    {
+        for (uint o=0; o<numOuts; ++o)
+            carla_zeroFloats(outs[o] + outOffset, frames);
+    }
+
     // NOTE it is assumed that mutex is locked
-    bool tryPutData(float* const out1,
-                    float* const out2,
+    bool tryPutData(float* const* const outs,
+                    const uint numOuts,
                     uint64_t framePos,
                     const uint32_t frames,
                     const bool loopingMode,
@@ -194,8 +249,7 @@ struct AudioFilePool {
                 return false;
             }
 
-            carla_copyFloats(out1, buffer[0] + frameDiff, frames);
-            carla_copyFloats(out2, buffer[1] + frameDiff, frames);
+            copyFrames(outs, numOuts, 0, static_cast<uint32_t>(frameDiff), frames);
         }
         else
         {
@@ -208,8 +262,7 @@ struct AudioFilePool {
                 return false;
             }
 
-            carla_copyFloats(out1, buffer[0] + frameDiff, frames);
-            carla_copyFloats(out2, buffer[1] + frameDiff, frames);
+            copyFrames(outs, numOuts, 0, static_cast<uint32_t>(frameDiff), frames);
         }
 
         if (frameDiff > numFramesNearEnd)
@@ -224,11 +277,257 @@ struct AudioFilePool {
     CARLA_DECLARE_NON_COPYABLE(AudioFilePool)
 };
 
-class AudioFileReader
+// -----------------------------------------------------------------------
+// Peak overview of a file, as a pyramid of min/max/rms levels.
+// Level 0 has up to kMaxBins bins, each next level halves the number of bins.
+
+struct AudioFilePeak {
+    float min;
+    float max;
+    float rms;
+};
+
+class AudioFilePeaks
+{
+public:
+    static const uint     kMaxLevels = 17;
+    static const uint32_t kMaxBins = 65536;
+    static const uint32_t kMinFramesPerBin = 256;
+
+    AudioFilePeaks() noexcept
+        : fData(nullptr),
+          fNumFrames(0),
+          fNumChannels(0),
+          fNumLevels(0),
+          fFramesPerBin(0),
+          fCurrentBin(0),
+          fCurrentFrames(0),
+          fCurrentMin(0.0f),
+          fCurrentMax(0.0f),
+          fCurrentSumSq(0.0)
+    {
+        carla_zeroStructs(fLevelOffsets, kMaxLevels);
+        carla_zeroStructs(fLevelSizes, kMaxLevels);
+    }
+
+    ~AudioFilePeaks()
+    {
+        clear();
+    }
+
+    void clear() noexcept
+    {
+        if (fData != nullptr)
+        {
+            delete[] fData;
+            fData = nullptr;
+        }
+
+        fNumFrames = 0;
+        fNumChannels = 0;
+        fNumLevels = 0;
+        fFramesPerBin = 0;
+        _resetCurrentBin();
+        fCurrentBin = 0;
+    }
+
+    bool init(const uint64_t numFrames, const uint numChannels)
+    {
+        clear();
+        CARLA_SAFE_ASSERT_RETURN(numFrames > 0, false);
+        CARLA_SAFE_ASSERT_RETURN(numChannels > 0, false);
+
+        uint32_t framesPerBin = kMinFramesPerBin;
+
+        while (numFrames > static_cast<uint64_t>(framesPerBin) * kMaxBins)
+            framesPerBin *= 2;
+
+        uint32_t numBins = static_cast<uint32_t>((numFrames + framesPerBin - 1) / framesPerBin);
+        std::size_t totalBins = 0;
+        uint numLevels = 0;
+
+        for (; numLevels < kMaxLevels; numBins = (numBins + 1) / 2)
+        {
+            fLevelOffsets[numLevels] = totalBins;
+            fLevelSizes[numLevels] = numBins;
+            totalBins += numBins;
+            ++numLevels;
+
+            if (numBins == 1)
+                break;
+        }
+
+        try {
+            fData = new AudioFilePeak[totalBins];
+        } CARLA_SAFE_EXCEPTION_RETURN("AudioFilePeaks::init", false);
+
+        carla_zeroStructs(fData, totalBins);
+
+        fNumFrames = numFrames;
+        fNumChannels = numChannels;
+        fNumLevels = numLevels;
+        fFramesPerBin = framesPerBin;
+        return true;
+    }
+
+    // feed interleaved samples, in file order
+    void process(const float* samples, const uint32_t numFrames) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fData != nullptr,);
+
+        for (uint32_t i=0; i<numFrames; ++i)
+        {
+            for (uint c=0; c<fNumChannels; ++c)
+            {
+                const float sample = *samples++;
+
+                if (sample < fCurrentMin)
+                    fCurrentMin = sample;
+                if (sample > fCurrentMax)
+                    fCurrentMax = sample;
+
+                fCurrentSumSq += static_cast<double>(sample * sample);
+            }
+
+            if (++fCurrentFrames == fFramesPerBin)
+                _flushCurrentBin();
+        }
+    }
+
+    // flush last partial bin and build the upper levels
+    void finish() noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fData != nullptr,);
+
+        if (fCurrentFrames != 0)
+            _flushCurrentBin();
+
+        for (uint l=1; l<fNumLevels; ++l)
+        {
+            const AudioFilePeak* const src = fData + fLevelOffsets[l-1];
+            AudioFilePeak* const dst = fData + fLevelOffsets[l];
+            const uint32_t srcSize = fLevelSizes[l-1];
+
+            for (uint32_t i=0, j=0; i<fLevelSizes[l]; ++i, j+=2)
+            {
+                if (j + 1 >= srcSize)
+                {
+                    dst[i] = src[j];
+                    continue;
+                }
+
+                // last bin of a level can be partial, weight rms by the frames each side covers
+                const float weight1 = static_cast<float>(_getBinNumFrames(l-1, j+1)) / static_cast<float>(_getBinNumFrames(l, i));
+                const float weight0 = 1.0f - weight1;
+
+                dst[i].min = std::min(src[j].min, src[j+1].min);
+                dst[i].max = std::max(src[j].max, src[j+1].max);
+                dst[i].rms = std::sqrt(src[j].rms * src[j].rms * weight0 + src[j+1].rms * src[j+1].rms * weight1);
+            }
+        }
+    }
+
+    uint getLevelCount() const noexcept
+    {
+        return fNumLevels;
+    }
+
+    uint32_t getFramesPerBin(const uint level) const noexcept
+    {
+        return fFramesPerBin << level;
+    }
+
+    const AudioFilePeak* getLevel(const uint level, uint32_t& numBins) const noexcept
+    {
+        CARLA_SAFE_ASSERT_UINT2_RETURN(level < fNumLevels, level, fNumLevels, nullptr);
+
+        numBins = fLevelSizes[level];
+        return fData + fLevelOffsets[level];
+    }
+
+    // absolute peak values, using the coarsest level that still has a bin per preview point
+    void getPreview(float* const previewData, const uint32_t previewDataSize) const noexcept
+    {
+        carla_zeroFloats(previewData, previewDataSize);
+
+        if (fNumLevels == 0 || previewDataSize == 0)
+            return;
+
+        uint level = 0;
+        while (level + 1 < fNumLevels && fLevelSizes[level + 1] >= previewDataSize)
+            ++level;
+
+        const AudioFilePeak* const peaks = fData + fLevelOffsets[level];
+        const uint64_t numBins = fLevelSizes[level];
+
+        for (uint32_t i=0; i<previewDataSize; ++i)
+        {
+            const uint32_t start = static_cast<uint32_t>(i * numBins / previewDataSize);
+            const uint32_t end = std::max(start + 1U, static_cast<uint32_t>((i + 1U) * numBins / previewDataSize));
+            float value = 0.0f;
+
+            for (uint32_t j=start; j<end; ++j)
+                value = std::max(value, std::max(std::fabs(peaks[j].min), std::fabs(peaks[j].max)));
+
+            previewData[i] = value;
+        }
+    }
+
+private:
+    AudioFilePeak* fData;
+    uint64_t fNumFrames;
+    std::size_t fLevelOffsets[kMaxLevels];
+    uint32_t fLevelSizes[kMaxLevels];
+    uint fNumChannels;
+    uint fNumLevels;
+    uint32_t fFramesPerBin;
+
+    uint32_t fCurrentBin;
+    uint32_t fCurrentFrames;
+    float fCurrentMin;
+    float fCurrentMax;
+    double fCurrentSumSq;
+
+    uint64_t _getBinNumFrames(const uint level, const uint32_t index) const noexcept
+    {
+        const uint64_t binFrames = static_cast<uint64_t>(fFramesPerBin) << level;
+        const uint64_t start = binFrames * index;
+
+        return std::min(fNumFrames, start + binFrames) - start;
+    }
+
+    void _resetCurrentBin() noexcept
+    {
+        fCurrentFrames = 0;
+        fCurrentMin = 0.0f;
+        fCurrentMax = 0.0f;
+        fCurrentSumSq = 0.0;
+    }
+
+    void _flushCurrentBin() noexcept
+    {
+        if (fCurrentBin < fLevelSizes[0])
+        {
+            AudioFilePeak& peak(fData[fCurrentBin++]);
+            peak.min = fCurrentMin;
+            peak.max = fCurrentMax;
+            peak.rms = static_cast<float>(std::sqrt(fCurrentSumSq / (fCurrentFrames * fNumChannels)));
+        }
+
+        _resetCurrentBin();
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(AudioFilePeaks)
+};
+
+// -----------------------------------------------------------------------
+
+class AudioFileReader : private CarlaThread
 {
 public:
     AudioFileReader()
-        : fEntireFileLoaded(false),
+        : CarlaThread("AudioFilePeaks"),
+          fEntireFileLoaded(false),
           fLoopingMode(true),
           fCurrentBitRate(0),
           fNeedsFrame(0),
@@ -244,13 +543,19 @@ public:
           fPoolMutex(),
           fPoolReadyToSwap(false),
           fResampler(),
-          fReaderMutex()
+          fReaderMutex(),
+          fPeaks(),
+          fPeaksReady(false),
+          fPeaksFailed(false),
+          fPeaksFilename(),
+          fPeaksNumFrames(0)
     {
         ad_clear_nfo(&fFileNfo);
     }
 
     ~AudioFileReader()
     {
+        stopThread(-1);
         cleanup();
     }
 
@@ -310,6 +615,18 @@ public:
         return fFileNfo;
     }
 
+    // returns null while the peaks are still being computed
+    const AudioFilePeaks* getPeaks() const noexcept
+    {
+        return fPeaksReady ? &fPeaks : nullptr;
+    }
+
+    // peaks could not be computed, getPeaks() will never return valid data for the current file
+    bool havePeaksFailed() const noexcept
+    {
+        return fPeaksFailed;
+    }
+
     void setLoopingMode(const bool on) noexcept
     {
         fLoopingMode = on;
@@ -324,8 +641,7 @@ public:
         fNeedsRead = true;
     }
 
-    bool loadFilename(const char* const filename, const uint32_t sampleRate,
-                      const uint32_t previewDataSize, float* previewData)
+    bool loadFilename(const char* const filename, const uint32_t sampleRate)
     {
         CARLA_SAFE_ASSERT_RETURN(filename != nullptr && *filename != '\0', false);
 
@@ -349,10 +665,27 @@ public:
         if (fFileNfo.frames <= 0)
             carla_stderr("L: filename \"%s\" has 0 frames", filename);
 
-        if ((fFileNfo.channels == 1 || fFileNfo.channels == 2) && fFileNfo.frames > 0)
+        if (fFileNfo.channels > AudioFilePool::kMaxChannels)
+            carla_stderr("L: filename \"%s\" has %u channels, only the first %u will be used",
+                         filename, fFileNfo.channels, AudioFilePool::kMaxChannels);
+
+        if (fFileNfo.channels > 0 && fFileNfo.frames > 0)
         {
-            // valid
+            // valid, peaks are kept when reloading the same file
+            const bool peaksCached = fPeaksNumFrames == fFileNfo.frames && fPeaksFilename == filename;
+
+            if (! peaksCached)
+            {
+                stopThread(-1);
+                fPeaks.clear();
+                fPeaksReady = false;
+                fPeaksFailed = false;
+                fPeaksFilename = filename;
+                fPeaksNumFrames = fFileNfo.frames;
+            }
+
             const uint32_t fileNumFrames = static_cast<uint32_t>(fFileNfo.frames);
+            const uint poolNumChannels = std::min(fFileNfo.channels, AudioFilePool::kMaxChannels);
             const uint32_t maxPoolNumFrames = sampleRate * 30;
             const bool needsResample = fFileNfo.sample_rate != sampleRate;
             uint32_t maxFrame;
@@ -384,19 +717,10 @@ public:
                 const uint32_t poolNumFrames = needsResample
                                              ? static_cast<uint32_t>(static_cast<double>(fileNumFrames) * fResampleRatio + 0.5)
                                              : fileNumFrames;
-                fPool.create(poolNumFrames, maxFrame, false);
-                readEntireFileIntoPool(needsResample);
+                fPool.create(poolNumFrames, maxFrame, poolNumChannels, false);
+                readEntireFileIntoPool(needsResample, ! peaksCached);
                 ad_close(fFilePtr);
                 fFilePtr = nullptr;
-
-                const float fileNumFramesF = static_cast<float>(fileNumFrames);
-                const float previewDataSizeF = static_cast<float>(previewDataSize);
-                for (uint i=0; i<previewDataSize; ++i)
-                {
-                    const float stepF = static_cast<float>(i)/previewDataSizeF * fileNumFramesF;
-                    const uint step = carla_fixedValue(0U, fileNumFrames-1U, static_cast<uint>(stepF + 0.5f));
-                    previewData[i] = std::max(std::fabs(fPool.buffer[0][step]), std::fabs(fPool.buffer[1][step]));
-                }
             }
             else
             {
@@ -405,9 +729,11 @@ public:
                 const uint pollTempSize = poolNumFrames * fFileNfo.channels;
                 uint resampleTempSize = 0;
 
-                readFilePreview(previewDataSize, previewData);
+                // decode the whole file once in the background for the peaks
+                if (! peaksCached)
+                    startThread();
 
-                fPool.create(poolNumFrames, maxFrame, true);
+                fPool.create(poolNumFrames, maxFrame, poolNumChannels, true);
 
                 try {
                     fPollTempData = new float[pollTempSize];
@@ -460,7 +786,7 @@ public:
 
     void createSwapablePool(AudioFilePool& pool)
     {
-        pool.create(fPool.numFrames, fPool.maxFrame, false);
+        pool.create(fPool.numFrames, fPool.maxFrame, fPool.numChannels, false);
     }
 
     void putAndSwapAllData(AudioFilePool& pool)
@@ -475,19 +801,23 @@ public:
         CARLA_SAFE_ASSERT_RETURN(pool.tmpbuf[0] == nullptr,);
 
         pool.startFrame = fPool.startFrame;
+        pool.numChannels = fPool.numChannels;
         pool.numFrames = fPool.numFrames;
-        pool.buffer[0] = fPool.buffer[0];
-        pool.buffer[1] = fPool.buffer[1];
+
+        for (uint c=0; c<AudioFilePool::kMaxChannels; ++c)
+        {
+            pool.buffer[c] = fPool.buffer[c];
+            fPool.buffer[c] = nullptr;
+        }
 
         fPool.startFrame = 0;
+        fPool.numChannels = 0;
         fPool.numFrames = 0;
-        fPool.buffer[0] = nullptr;
-        fPool.buffer[1] = nullptr;
     }
 
     bool tryPutData(AudioFilePool& pool,
-                    float* const out1,
-                    float* const out2,
+                    float* const* const outs,
+                    const uint numOuts,
                     uint64_t framePos,
                     const uint32_t frames,
                     const bool loopMode,
@@ -498,7 +828,7 @@ public:
 
         bool needsRead = false;
         uint64_t needsReadFrame;
-        const bool ret = pool.tryPutData(out1, out2, framePos, frames, loopMode, isOffline, needsRead, needsReadFrame);
+        const bool ret = pool.tryPutData(outs, numOuts, framePos, frames, loopMode, isOffline, needsRead, needsReadFrame);
 
         if (needsRead)
         {
@@ -514,33 +844,7 @@ public:
         return ret;
     }
 
-    void readFilePreview(uint32_t previewDataSize, float* previewData)
-    {
-        carla_zeroFloats(previewData, previewDataSize);
-
-        const uint fileNumFrames = static_cast<uint>(fFileNfo.frames);
-        const float fileNumFramesF = static_cast<float>(fileNumFrames);
-        const float previewDataSizeF = static_cast<float>(previewDataSize);
-        const uint samplesPerRun = fFileNfo.channels;
-        const uint maxSampleToRead = fileNumFrames - samplesPerRun;
-        CARLA_SAFE_ASSERT_INT_RETURN(samplesPerRun == 1 || samplesPerRun == 2, samplesPerRun,);
-        float tmp[2] = { 0.0f, 0.0f };
-
-        if (samplesPerRun == 2)
-            previewDataSize -= 1;
-
-        for (uint i=0; i<previewDataSize; ++i)
-        {
-            const float posF = static_cast<float>(i)/previewDataSizeF * fileNumFramesF;
-            const uint pos = carla_fixedValue(0U, maxSampleToRead, static_cast<uint>(posF));
-
-            ad_seek(fFilePtr, pos);
-            ad_read(fFilePtr, tmp, samplesPerRun);
-            previewData[i] = std::max(std::fabs(tmp[0]), std::fabs(tmp[1]));
-        }
-    }
-
-    void readEntireFileIntoPool(const bool needsResample)
+    void readEntireFileIntoPool(const bool needsResample, const bool needsPeaks)
     {
         CARLA_SAFE_ASSERT_RETURN(fPool.numFrames > 0,);
 
@@ -560,6 +864,20 @@ public:
 
         fCurrentBitRate = ad_get_bitrate(fFilePtr);
 
+        if (needsPeaks)
+        {
+            if (fPeaks.init(fileNumFrames, numChannels))
+            {
+                fPeaks.process(buffer, fileNumFrames);
+                fPeaks.finish();
+                fPeaksReady = true;
+            }
+            else
+            {
+                fPeaksFailed = true;
+            }
+        }
+
         float* rbuffer;
 
         if (needsResample)
@@ -586,26 +904,8 @@ public:
             // lock, and put data asap
             const water::GenericScopedLock<water::SpinLock> gsl(fPool.mutex);
 
-            if (numChannels == 1)
-            {
-                for (ssize_t i=0, j=0; j < rv; ++i, ++j)
-                    fPool.buffer[0][i] = fPool.buffer[1][i] = rbuffer[j];
-            }
-            else
-            {
-                for (ssize_t i=0, j=0; j < rv; ++j)
-                {
-                    if (j % 2 == 0)
-                    {
-                        fPool.buffer[0][i] = rbuffer[j];
-                    }
-                    else
-                    {
-                        fPool.buffer[1][i] = rbuffer[j];
-                        ++i;
-                    }
-                }
-            }
+            const uint32_t numFrames = std::min(fPool.numFrames, static_cast<uint32_t>(rv / static_cast<ssize_t>(numChannels)));
+            carla_deinterleaveFloats(fPool.buffer, fPool.numChannels, 0, rbuffer, numChannels, numFrames);
         }
 
         if (rbuffer != buffer)
@@ -721,49 +1021,40 @@ public:
 
             // local copy
             const uint32_t poolNumFrames = fPool.numFrames;
-            float* const pbuffer0 = fPool.tmpbuf[0];
-            float* const pbuffer1 = fPool.tmpbuf[1];
+            const uint poolNumChannels = fPool.numChannels;
+            const uint numChannels = fFileNfo.channels;
+            float* const* const pbuffers = fPool.tmpbuf;
             const float* tmpbuf = fPollTempData;
+            const int64_t readFrames = rv / static_cast<ssize_t>(numChannels);
+            uint32_t rvFrames = static_cast<uint32_t>(readFrames);
 
             // resample as needed
             if (fResampleTempSize != 0)
             {
                 tmpbuf = fResampleTempData;
-                fResampler.inp_count = static_cast<uint>(rv / fFileNfo.channels);
-                fResampler.out_count = fResampleTempSize / fFileNfo.channels;
+                fResampler.inp_count = rvFrames;
+                fResampler.out_count = fResampleTempSize / numChannels;
                 fResampler.inp_data = fPollTempData;
                 fResampler.out_data = fResampleTempData;
                 fResampler.process();
                 CARLA_ASSERT_INT(fResampler.inp_count <= 1, fResampler.inp_count);
+
+                // use what the resampler produced, not what was read
+                rvFrames = fResampleTempSize / numChannels - fResampler.out_count;
             }
+            uint32_t k;
 
             j = 0;
             do {
-                if (fFileNfo.channels == 1)
-                {
-                    for (; i < poolNumFrames && j < rv; ++i, ++j)
-                        pbuffer0[i] = pbuffer1[i] = tmpbuf[j];
-                }
-                else
-                {
-                    for (; i < poolNumFrames && j < rv; ++j)
-                    {
-                        if (j % 2 == 0)
-                        {
-                            pbuffer0[i] = tmpbuf[j];
-                        }
-                        else
-                        {
-                            pbuffer1[i] = tmpbuf[j];
-                            ++i;
-                        }
-                    }
-                }
+                k = std::min(static_cast<uint32_t>(poolNumFrames - i), rvFrames - static_cast<uint32_t>(j));
+                carla_deinterleaveFloats(pbuffers, poolNumChannels, static_cast<uint32_t>(i), tmpbuf + j * numChannels, numChannels, k);
+                i += k;
+                j += k;
 
                 if (i >= poolNumFrames)
                     break;
 
-                if (rv == fFileNfo.frames)
+                if (readFrames == fFileNfo.frames)
                 {
                     // full file read
                     j = 0;
@@ -776,8 +1067,8 @@ public:
 #ifdef DEBUG_FILE_OPS
                     carla_stdout("read break, not enough space");
 #endif
-                    carla_zeroFloats(pbuffer0, poolNumFrames - i);
-                    carla_zeroFloats(pbuffer1, poolNumFrames - i);
+                    for (uint c=0; c<poolNumChannels; ++c)
+                        carla_zeroFloats(pbuffers[c] + i, poolNumFrames - i);
                     break;
                 }
 
@@ -787,8 +1078,9 @@ public:
             const CarlaMutexLocker cmlp(fPoolMutex);
             const water::GenericScopedLock<water::SpinLock> gsl(fPool.mutex);
 
-            std::memcpy(fPool.buffer[0], pbuffer0, sizeof(float)*poolNumFrames);
-            std::memcpy(fPool.buffer[1], pbuffer1, sizeof(float)*poolNumFrames);
+            for (uint c=0; c<poolNumChannels; ++c)
+                std::memcpy(fPool.buffer[c], pbuffers[c], sizeof(float)*poolNumFrames);
+
             fPool.startFrame = static_cast<uint64_t>(readFrame);
             fPoolReadyToSwap = true;
 #ifdef DEBUG_FILE_OPS
@@ -822,6 +1114,58 @@ private:
     Resampler     fResampler;
     CarlaMutex    fReaderMutex;
 
+    AudioFilePeaks fPeaks;
+    volatile bool  fPeaksReady;
+    volatile bool  fPeaksFailed;
+    CarlaString    fPeaksFilename;
+    int64_t        fPeaksNumFrames;
+
+    // single sequential decode of the file, so that no seeking is needed for the peaks
+    void run() override
+    {
+        ADInfo nfo;
+        ad_clear_nfo(&nfo);
+
+        void* const filePtr = ad_open(fPeaksFilename, &nfo);
+
+        if (filePtr == nullptr)
+        {
+            carla_stderr2("AudioFileReader: failed to open \"%s\" for peaks", fPeaksFilename.buffer());
+            fPeaksFailed = true;
+            return;
+        }
+
+        const uint numChannels = nfo.channels;
+
+        if (numChannels == 0 || nfo.frames <= 0 || ! fPeaks.init(static_cast<uint64_t>(nfo.frames), numChannels))
+        {
+            ad_close(filePtr);
+            fPeaksFailed = true;
+            return;
+        }
+
+        float buffer[8192];
+        const size_t bufferSize = sizeof(buffer)/sizeof(float) / numChannels * numChannels;
+
+        while (! shouldThreadExit())
+        {
+            const ssize_t rv = ad_read(filePtr, buffer, bufferSize);
+
+            if (rv <= 0)
+                break;
+
+            fPeaks.process(buffer, static_cast<uint32_t>(rv) / numChannels);
+        }
+
+        ad_close(filePtr);
+
+        if (shouldThreadExit())
+            return;
+
+        fPeaks.finish();
+        fPeaksReady = true;
+    }
+
     // try a pool data swap if possible and relevant
     // NOTE it is assumed that `pool` mutex is locked
     void _tryPoolSwap(AudioFilePool& pool)
@@ -848,13 +1192,12 @@ private:
         pool.numFrames = fPool.numFrames;
         fPool.numFrames = tmp_u32;
 
-        tmp_fp = pool.buffer[0];
-        pool.buffer[0] = fPool.buffer[0];
-        fPool.buffer[0] = tmp_fp;
-
-        tmp_fp = pool.buffer[1];
-        pool.buffer[1] = fPool.buffer[1];
-        fPool.buffer[1] = tmp_fp;
+        for (uint c=0; c<AudioFilePool::kMaxChannels; ++c)
+        {
+            tmp_fp = pool.buffer[c];
+            pool.buffer[c] = fPool.buffer[c];
+            fPool.buffer[c] = tmp_fp;
+        }
 
         fPoolReadyToSwap = false;
 
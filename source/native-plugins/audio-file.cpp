@@ -67,8 +67,9 @@ public:
         kParameterCount
     };
 
-    AudioFilePlugin(const NativeHostDescriptor* const host)
+    AudioFilePlugin(const NativeHostDescriptor* const host, const uint numOutputs = 2)
         : NativePluginWithMidiPrograms<FileAudio>(host, fPrograms, 2),
+          kNumOutputs(numOutputs),
           fLoopMode(true),
 #ifdef __MOD_DEVICES__
           fHostSync(false),
@@ -79,6 +80,8 @@ public:
           fDoProcess(false),
           fWasPlayingBefore(false),
           fNeedsFileRead(false),
+          fNeedsPreviewSend(false),
+          fPreviewIdleRequested(false),
           fEntireFileLoaded(false),
           fMaxFrame(0),
           fInternalTransportFrame(0),
@@ -339,20 +342,24 @@ protected:
     void process2(const float* const*, float** const outBuffer, const uint32_t frames,
                   const NativeMidiEvent*, uint32_t) override
     {
-        float* const out1 = outBuffer[0];
-        float* const out2 = outBuffer[1];
-
         const water::GenericScopedLock<water::SpinLock> gsl(fPool.mutex);
 
         if (! fDoProcess)
         {
             // carla_stderr("P: no process");
-            carla_zeroFloats(out1, frames);
-            carla_zeroFloats(out2, frames);
+            AudioFilePool::zeroFrames(outBuffer, kNumOutputs, 0, frames);
             fLastPosition = 0.0f;
             return;
         }
 
+        // background peaks are done (or failed), send preview on next idle
+        if (fNeedsPreviewSend && ! fPreviewIdleRequested
+            && (fReader.getPeaks() != nullptr || fReader.havePeaksFailed()))
+        {
+            fPreviewIdleRequested = true;
+            hostRequestIdle();
+        }
+
         const bool loopMode = fLoopMode;
         const float volume = fVolume;
         bool needsIdleRequest = false;
@@ -381,8 +388,7 @@ protected:
             if (frame == 0 && fWasPlayingBefore)
                 fReader.setNeedsRead(frame);
 
-            carla_zeroFloats(out1, frames);
-            carla_zeroFloats(out2, frames);
+            AudioFilePool::zeroFrames(outBuffer, kNumOutputs, 0, frames);
             fWasPlayingBefore = false;
             return;
         }
@@ -401,8 +407,7 @@ protected:
                 fReader.setNeedsRead(frame);
             }
 
-            carla_zeroFloats(out1, frames);
-            carla_zeroFloats(out2, frames);
+            AudioFilePool::zeroFrames(outBuffer, kNumOutputs, 0, frames);
 
 #ifndef __MOD_DEVICES__
             if (fInlineDisplay.writtenValues < 32)
@@ -440,14 +445,12 @@ protected:
                 if (targetStartFrame + framesToDo <= fMaxFrame)
                 {
                     // everything fits together
-                    carla_copyFloats(out1+framesDone, fPool.buffer[0]+targetStartFrame, framesToDo);
-                    carla_copyFloats(out2+framesDone, fPool.buffer[1]+targetStartFrame, framesToDo);
+                    fPool.copyFrames(outBuffer, kNumOutputs, framesDone, targetStartFrame, framesToDo);
                     break;
                 }
 
                 remainingFrames = std::min(fMaxFrame - targetStartFrame, framesToDo);
-                carla_copyFloats(out1+framesDone, fPool.buffer[0]+targetStartFrame, remainingFrames);
-                carla_copyFloats(out2+framesDone, fPool.buffer[1]+targetStartFrame, remainingFrames);
+                fPool.copyFrames(outBuffer, kNumOutputs, framesDone, targetStartFrame, remainingFrames);
                 framesDone += remainingFrames;
                 framesToDo -= remainingFrames;
 
@@ -456,8 +459,7 @@ protected:
                     // not looping, stop here
                     if (framesToDo != 0)
                     {
-                        carla_zeroFloats(out1+framesDone, framesToDo);
-                        carla_zeroFloats(out2+framesDone, framesToDo);
+                        AudioFilePool::zeroFrames(outBuffer, kNumOutputs, framesDone, framesToDo);
                     }
                     break;
                 }
@@ -472,11 +474,8 @@ protected:
         {
             const bool offline = isOffline();
 
-            if (! fReader.tryPutData(fPool, out1, out2, frame, frames, loopMode, offline, needsIdleRequest))
-            {
-                carla_zeroFloats(out1, frames);
-                carla_zeroFloats(out2, frames);
-            }
+            if (! fReader.tryPutData(fPool, outBuffer, kNumOutputs, frame, frames, loopMode, offline, needsIdleRequest))
+                AudioFilePool::zeroFrames(outBuffer, kNumOutputs, 0, frames);
 
             if (needsIdleRequest)
             {
@@ -487,11 +486,8 @@ protected:
                     needsIdleRequest = false;
                     fReader.readPoll();
 
-                    if (! fReader.tryPutData(fPool, out1, out2, frame, frames, loopMode, offline, needsIdleRequest))
-                    {
-                        carla_zeroFloats(out1, frames);
-                        carla_zeroFloats(out2, frames);
-                    }
+                    if (! fReader.tryPutData(fPool, outBuffer, kNumOutputs, frame, frames, loopMode, offline, needsIdleRequest))
+                        AudioFilePool::zeroFrames(outBuffer, kNumOutputs, 0, frames);
 
                     if (needsIdleRequest)
                         fNeedsFileRead = true;
@@ -509,15 +505,15 @@ protected:
 
         if (carla_isNotZero(volume-1.0f))
         {
-            carla_multiply(out1, volume, frames);
-            carla_multiply(out2, volume, frames);
+            for (uint i=0; i<kNumOutputs; ++i)
+                carla_multiply(outBuffer[i], volume, frames);
         }
 
 #ifndef __MOD_DEVICES__
         if (fInlineDisplay.writtenValues < 32)
         {
-            fInlineDisplay.lastValuesL[fInlineDisplay.writtenValues] = carla_findMaxNormalizedFloat(out1, frames);
-            fInlineDisplay.lastValuesR[fInlineDisplay.writtenValues] = carla_findMaxNormalizedFloat(out2, frames);
+            fInlineDisplay.lastValuesL[fInlineDisplay.writtenValues] = carla_findMaxNormalizedFloat(outBuffer[0], frames);
+            fInlineDisplay.lastValuesR[fInlineDisplay.writtenValues] = carla_findMaxNormalizedFloat(outBuffer[1], frames);
             ++fInlineDisplay.writtenValues;
         }
         if (fInlineDisplay.pending == InlineDisplayNotPending)
@@ -566,6 +562,20 @@ protected:
             fNeedsFileRead = false;
         }
 
+        if (fNeedsPreviewSend)
+        {
+            if (const AudioFilePeaks* const peaks = fReader.getPeaks())
+            {
+                fNeedsPreviewSend = false;
+                sendPreview(peaks);
+            }
+            else if (fReader.havePeaksFailed())
+            {
+                fNeedsPreviewSend = false;
+                sendPreview(nullptr);
+            }
+        }
+
 #ifndef __MOD_DEVICES__
         if (fInlineDisplay.pending == InlineDisplayNeedRequest)
         {
@@ -699,12 +709,16 @@ protected:
     // -------------------------------------------------------------------
 
 private:
+    const uint kNumOutputs;
+
     bool fLoopMode;
     bool fHostSync;
     bool fEnabled;
     bool fDoProcess;
     bool fWasPlayingBefore;
     volatile bool fNeedsFileRead;
+    volatile bool fNeedsPreviewSend;
+    volatile bool fPreviewIdleRequested;
 
     bool fEntireFileLoaded;
     uint32_t fMaxFrame;
@@ -762,6 +776,7 @@ private:
         carla_debug("AudioFilePlugin::loadFilename(\"%s\")", filename);
 
         fDoProcess = false;
+        fNeedsPreviewSend = false;
         fLastPoolFill = 0.0f;
         fInternalTransportFrame = 0;
         fPool.destroy();
@@ -774,9 +789,7 @@ private:
             return;
         }
 
-        const uint32_t previewDataSize = sizeof(fPreviewData)/sizeof(float);
-
-        if (fReader.loadFilename(filename, static_cast<uint32_t>(getSampleRate()), previewDataSize, fPreviewData))
+        if (fReader.loadFilename(filename, static_cast<uint32_t>(getSampleRate())))
         {
             fEntireFileLoaded = fReader.isEntireFileLoaded();
             fMaxFrame = fReader.getMaxFrame();
@@ -794,16 +807,46 @@ private:
 
             fDoProcess = true;
             fFilename = filename;
-            hostSendPreviewBufferData('f', previewDataSize, fPreviewData);
+
+            // peaks of big files are computed in the background, preview is sent during idle once ready
+            if (const AudioFilePeaks* const peaks = fReader.getPeaks())
+            {
+                sendPreview(peaks);
+            }
+            else
+            {
+                fPreviewIdleRequested = false;
+                fNeedsPreviewSend = true;
+            }
         }
         else
         {
             fEntireFileLoaded = false;
             fMaxFrame = 0;
+            sendPreview(nullptr);
         }
     }
 
+    // sends an empty preview if peaks is null
+    void sendPreview(const AudioFilePeaks* const peaks)
+    {
+        const uint32_t previewDataSize = sizeof(fPreviewData)/sizeof(float);
+
+        if (peaks != nullptr)
+            peaks->getPreview(fPreviewData, previewDataSize);
+        else
+            carla_zeroFloats(fPreviewData, previewDataSize);
+
+        hostSendPreviewBufferData('f', previewDataSize, fPreviewData);
+    }
+
     PluginClassEND(AudioFilePlugin)
+
+    static NativePluginHandle _instantiate8(const NativeHostDescriptor* host)
+    {
+        return (host != nullptr) ? new AudioFilePlugin(host, AudioFilePool::kMaxChannels) : nullptr;
+    }
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioFilePlugin)
 };
 
@@ -833,6 +876,53 @@ static const NativePluginDescriptor audiofileDesc = {
     PluginDescriptorFILL(AudioFilePlugin)
 };
 
+// multichannel variant, channels beyond the file's count stay silent
+static const NativePluginDescriptor audiofile8Desc = {
+    /* category  */ NATIVE_PLUGIN_CATEGORY_UTILITY,
+    /* hints     */ static_cast<NativePluginHints>(NATIVE_PLUGIN_IS_RTSAFE
+                                                  |NATIVE_PLUGIN_HAS_UI
+#ifndef __MOD_DEVICES__
+                                                  |NATIVE_PLUGIN_HAS_INLINE_DISPLAY
+#endif
+                                                  |NATIVE_PLUGIN_REQUESTS_IDLE
+                                                  |NATIVE_PLUGIN_NEEDS_UI_OPEN_SAVE
+                                                  |NATIVE_PLUGIN_USES_TIME),
+    /* supports  */ NATIVE_PLUGIN_SUPPORTS_NOTHING,
+    /* audioIns  */ 0,
+    /* audioOuts */ AudioFilePool::kMaxChannels,
+    /* midiIns   */ 0,
+    /* midiOuts  */ 0,
+    /* paramIns  */ 1,
+    /* paramOuts */ 0,
+    /* name      */ "Audio File (8ch)",
+    /* label     */ "audiofile8",
+    /* maker     */ "falkTX",
+    /* copyright */ "GNU GPL v2+",
+    AudioFilePlugin::_instantiate8,
+    AudioFilePlugin::_cleanup,
+    AudioFilePlugin::_get_parameter_count,
+    AudioFilePlugin::_get_parameter_info,
+    AudioFilePlugin::_get_parameter_value,
+    AudioFilePlugin::_get_midi_program_count,
+    AudioFilePlugin::_get_midi_program_info,
+    AudioFilePlugin::_set_parameter_value,
+    AudioFilePlugin::_set_midi_program,
+    AudioFilePlugin::_set_custom_data,
+    AudioFilePlugin::_ui_show,
+    AudioFilePlugin::_ui_idle,
+    AudioFilePlugin::_ui_set_parameter_value,
+    AudioFilePlugin::_ui_set_midi_program,
+    AudioFilePlugin::_ui_set_custom_data,
+    AudioFilePlugin::_activate,
+    AudioFilePlugin::_deactivate,
+    AudioFilePlugin::_process,
+    AudioFilePlugin::_get_state,
+    AudioFilePlugin::_set_state,
+    AudioFilePlugin::_dispatcher,
+    AudioFilePlugin::_render_inline_display,
+    0, 0, nullptr, nullptr, 0, 0
+};
+
 // -----------------------------------------------------------------------
 
 CARLA_API_EXPORT
@@ -842,6 +932,7 @@ CARLA_API_EXPORT
 void carla_register_native_plugin_audiofile()
 {
     carla_register_native_plugin(&audiofileDesc);
+    carla_register_native_plugin(&audiofile8Desc);
 }
 
 // -----------------------------------------------------------------------
@@ -41,6 +41,10 @@ typedef struct {
     float  multiplier;
     float  baseStart;
     float  value;
+    // phase of the next frame, in [0, 1)
+    double   phase;
+    uint64_t nextFrame;
+    bool     synced;
 } LfoHandle;
 
 // -----------------------------------------------------------------------
@@ -58,6 +62,9 @@ static NativePluginHandle lfo_instantiate(const NativeHostDescriptor* host)
     handle->multiplier = 1.0f;
     handle->baseStart  = 0.0f;
     handle->value      = 0.0f;
+    handle->phase      = 0.0;
+    handle->nextFrame  = 0;
+    handle->synced     = false;
     return handle;
 }
 
@@ -91,7 +98,7 @@ static const NativeParameter* lfo_get_parameter_info(NativePluginHandle handle,
     paramModes[0].label = "Triangle";
     paramModes[1].label = "Sawtooth";
     paramModes[2].label = "Sawtooth (inverted)";
-    paramModes[3].label = "Sine (TODO)";
+    paramModes[3].label = "Sine";
     paramModes[4].label = "Square";
 
     paramModes[0].value = 1.0f;
@@ -205,60 +212,134 @@ static void lfo_set_parameter_value(NativePluginHandle handle, uint32_t index, f
     }
 }
 
-// FIXME for v3.0, use const for the input buffer
-static void lfo_process(NativePluginHandle handle,
-                        float** inBuffer, float** outBuffer, uint32_t frames,
-                        const NativeMidiEvent* midiEvents, uint32_t midiEventCount)
+static const NativePortRange* lfo_get_buffer_port_range(NativePluginHandle handle, uint32_t index, bool isOutput)
 {
-    const NativeHostDescriptor* const host     = handlePtr->host;
-    const NativeTimeInfo*       const timeInfo = host->get_time_info(host->handle);
+    if (! isOutput || index != 0)
+        return NULL;
 
-    if (! timeInfo->playing)
-       return;
+    static NativePortRange npr;
+    npr.minimum = 0.0f;
+    npr.maximum = 1.0f;
+    return &npr;
 
-    const double bpm        = timeInfo->bbt.valid ? timeInfo->bbt.beatsPerMinute : 120.0;
-    const double sampleRate = host->get_sample_rate(host->handle);
+    // unused
+    (void)handle;
+}
+
+static const char* lfo_get_buffer_port_name(NativePluginHandle handle, uint32_t index, bool isOutput)
+{
+    if (! isOutput || index != 0)
+        return NULL;
+
+    return "LFO Out";
+
+    // unused
+    (void)handle;
+}
+
+static void lfo_activate(NativePluginHandle handle)
+{
+    handlePtr->synced = false;
+}
 
-    const double speedRate  = handlePtr->speed/(bpm/60.0/sampleRate);
-    const uint   speedRatei = (uint)speedRate;
+// -----------------------------------------------------------------------
 
-    double value = 0.0;
+static inline double lfo_phase_at(const double start, const double inc, const uint32_t i)
+{
+    const double phase = start + inc * (double)i;
+    return phase - floor(phase);
+}
+
+// write the raw 0..1 waveform for consecutive phases into out
+static void lfo_generate(float* const out, const uint32_t frames, const int mode, const double start, const double inc)
+{
+    uint32_t i;
 
-    switch (handlePtr->mode)
+    switch (mode)
     {
     case 1: // Triangle
-        value = fabs(1.0-(double)(timeInfo->frame % speedRatei)/(speedRate/2.0));
+        for (i=0; i < frames; ++i)
+            out[i] = (float)fabs(1.0 - 2.0 * lfo_phase_at(start, inc, i));
         break;
     case 2: // Sawtooth
-        value = (double)(timeInfo->frame % speedRatei)/speedRate;
+        for (i=0; i < frames; ++i)
+            out[i] = (float)lfo_phase_at(start, inc, i);
         break;
     case 3: // Sawtooth (inverted)
-        value = 1.0 - (double)(timeInfo->frame % speedRatei)/speedRate;
+        for (i=0; i < frames; ++i)
+            out[i] = (float)(1.0 - lfo_phase_at(start, inc, i));
         break;
-    case 4: // Sine -- TODO!
-        value = 0.0;
+    case 4: // Sine, aligned with triangle
+        for (i=0; i < frames; ++i)
+            out[i] = (float)(0.5 + 0.5 * cos(2.0 * M_PI * lfo_phase_at(start, inc, i)));
         break;
     case 5: // Square
-        value = (timeInfo->frame % speedRatei <= speedRatei/2) ? 1.0 : 0.0;
+        for (i=0; i < frames; ++i)
+            out[i] = lfo_phase_at(start, inc, i) <= 0.5 ? 1.0f : 0.0f;
         break;
+    default:
+        for (i=0; i < frames; ++i)
+            out[i] = 0.0f;
+        break;
+    }
+}
+
+// FIXME for v3.0, use const for the input buffer
+static void lfo_process(NativePluginHandle handle,
+                        float** inBuffer, float** outBuffer, uint32_t frames,
+                        const NativeMidiEvent* midiEvents, uint32_t midiEventCount)
+{
+    const NativeHostDescriptor* const host     = handlePtr->host;
+    const NativeTimeInfo*       const timeInfo = host->get_time_info(host->handle);
+
+    float* const out = outBuffer[0];
+
+    if (! timeInfo->playing)
+    {
+        // hold last value, resync with transport once playing again
+        for (uint32_t i=0; i < frames; ++i)
+            out[i] = handlePtr->value;
+
+        handlePtr->synced = false;
+        return;
+    }
+
+    double bpm = timeInfo->bbt.valid ? timeInfo->bbt.beatsPerMinute : 120.0;
+    if (bpm <= 0.0)
+        bpm = 120.0;
+
+    const double sampleRate = host->get_sample_rate(host->handle);
+
+    // length of one cycle in frames, kept fractional to avoid drift
+    const double speedRate = handlePtr->speed/(bpm/60.0/sampleRate);
+    const double phaseInc  = 1.0/speedRate;
+
+    // follow transport on relocation, otherwise keep phase continuous across speed changes
+    if (! handlePtr->synced || timeInfo->frame != handlePtr->nextFrame)
+    {
+        handlePtr->phase  = fmod((double)timeInfo->frame, speedRate)/speedRate;
+        handlePtr->synced = true;
     }
 
-    value *= (double)handlePtr->multiplier;
-    value += (double)handlePtr->baseStart;
+    lfo_generate(out, frames, handlePtr->mode, handlePtr->phase, phaseInc);
+
+    handlePtr->phase     = lfo_phase_at(handlePtr->phase, phaseInc, frames);
+    handlePtr->nextFrame = timeInfo->frame + frames;
 
-    if (value <= 0.0)
-        handlePtr->value = 0.0f;
-    else if (value >= 1.0)
-        handlePtr->value = 1.0f;
-    else
-        handlePtr->value = (float)value;
+    const float multiplier = handlePtr->multiplier;
+    const float baseStart  = handlePtr->baseStart;
+
+    for (uint32_t i=0; i < frames; ++i)
+        out[i] = fminf(fmaxf(out[i] * multiplier + baseStart, 0.0f), 1.0f);
+
+    // parameter output is kept for compatibility, reports the latest value
+    if (frames != 0)
+        handlePtr->value = out[frames-1];
 
     return;
 
     // unused
     (void)inBuffer;
-    (void)outBuffer;
-    (void)frames;
     (void)midiEvents;
     (void)midiEventCount;
 }
@@ -269,12 +350,12 @@ static void lfo_process(NativePluginHandle handle,
 
 static const NativePluginDescriptor lfoDesc = {
     .category  = NATIVE_PLUGIN_CATEGORY_UTILITY,
-    .hints     = NATIVE_PLUGIN_IS_RTSAFE,
+    .hints     = NATIVE_PLUGIN_IS_RTSAFE|NATIVE_PLUGIN_USES_CONTROL_VOLTAGE,
     .supports  = NATIVE_PLUGIN_SUPPORTS_NOTHING,
     .audioIns  = 0,
     .audioOuts = 0,
     .cvIns     = 0,
-    .cvOuts    = 0,
+    .cvOuts    = 1,
     .midiIns   = 0,
     .midiOuts  = 0,
     .paramIns  = PARAM_COUNT-1,
@@ -298,6 +379,9 @@ static const NativePluginDescriptor lfoDesc = {
     .set_midi_program    = NULL,
     .set_custom_data     = NULL,
 
+    .get_buffer_port_name = lfo_get_buffer_port_name,
+    .get_buffer_port_range = lfo_get_buffer_port_range,
+
     .ui_show = NULL,
     .ui_idle = NULL,
 
@@ -305,7 +389,7 @@ static const NativePluginDescriptor lfoDesc = {
     .ui_set_midi_program    = NULL,
     .ui_set_custom_data     = NULL,
 
-    .activate   = NULL,
+    .activate   = lfo_activate,
     .deactivate = NULL,
     .process    = lfo_process,
 
@@ -19,6 +19,7 @@
 #define MIDI_BASE_HPP_INCLUDED
 
 #include "CarlaMIDI.h"
+#include "CarlaBase64Utils.hpp"
 #include "CarlaMutex.hpp"
 #include "LinkedList.hpp"
 
@@ -31,6 +32,9 @@
 #define MIN_PREALLOCATED_EVENT_COUNT 100
 #define MAX_PREALLOCATED_EVENT_COUNT 1000
 
+// state prefix for the binary format, older projects store plain text
+#define MIDI_PATTERN_STATE_PREFIX    "mpb1:"
+
 // -----------------------------------------------------------------------
 
 struct RawMidiEvent {
@@ -175,14 +179,43 @@ public:
         rawEvent->size = size;
 
         carla_copy<uint8_t>(rawEvent->data, data, size);
-
-        // Fix zero-velocity note-ons
-        if (MIDI_IS_STATUS_NOTE_ON(data[0]) && data[2] == 0)
-            rawEvent->data[0] = uint8_t(MIDI_STATUS_NOTE_OFF | (data[0] & MIDI_CHANNEL_BIT));
+        fixZeroVelocityNoteOn(rawEvent);
 
         appendSorted(rawEvent);
     }
 
+    // -------------------------------------------------------------------
+    // replace all data at once, events must already be sorted by time
+
+    void setSortedRaw(const RawMidiEvent* const events, const std::size_t count)
+    {
+        LinkedList<const RawMidiEvent*> newData, oldData;
+
+        for (std::size_t i=0; i<count; ++i)
+        {
+            CARLA_SAFE_ASSERT_CONTINUE(i == 0 || events[i].time >= events[i-1].time);
+
+            RawMidiEvent* const rawEvent(new RawMidiEvent());
+            carla_copyStruct(*rawEvent, events[i]);
+            fixZeroVelocityNoteOn(rawEvent);
+
+            newData.append(rawEvent);
+        }
+
+        {
+            const CarlaMutexLocker cmlr(fReadMutex);
+            const CarlaMutexLocker cmlw(fWriteMutex);
+
+            if (fData.isNotEmpty())
+                fData.moveTo(oldData);
+            if (newData.isNotEmpty())
+                newData.moveTo(fData);
+        }
+
+        for (LinkedList<const RawMidiEvent*>::Itenerator it = oldData.begin2(); it.valid(); it.next())
+            delete it.getValue(nullptr);
+    }
+
     // -------------------------------------------------------------------
     // remove data
 
@@ -304,56 +337,183 @@ public:
 
     char* getState() const
     {
-        static const std::size_t maxTimeSize = 20;                        // std::strlen("18446744073709551615");
-        static const std::size_t maxDataSize = 4 + 4*MAX_EVENT_DATA_SIZE; // std::strlen("0xFF:127:127:127");
-        static const std::size_t maxMsgSize  = maxTimeSize + 3 /* sep + size + sep */ + maxDataSize + 1 /* newline */;
+        std::vector<uint8_t> binary;
 
-        const CarlaMutexLocker cmlw(fWriteMutex);
+        {
+            const CarlaMutexLocker cmlw(fWriteMutex);
 
-        char* const data((char*)std::calloc(1, fData.count() * maxMsgSize + 1));
-        CARLA_SAFE_ASSERT_RETURN(data != nullptr, nullptr);
+            binary.reserve(fData.count() * (5 /* max varint */ + 1 /* size */ + MAX_EVENT_DATA_SIZE));
+
+            uint32_t lastTime = 0;
+
+            for (LinkedList<const RawMidiEvent*>::Itenerator it = fData.begin2(); it.valid(); it.next())
+            {
+                const RawMidiEvent* const rawMidiEvent(it.getValue(nullptr));
+                CARLA_SAFE_ASSERT_CONTINUE(rawMidiEvent != nullptr);
+                CARLA_SAFE_ASSERT_CONTINUE(rawMidiEvent->time >= lastTime);
+                CARLA_SAFE_ASSERT_CONTINUE(rawMidiEvent->size > 0 && rawMidiEvent->size <= MAX_EVENT_DATA_SIZE);
+
+                _writeVarInt(binary, rawMidiEvent->time - lastTime);
+                binary.push_back(rawMidiEvent->size);
+                binary.insert(binary.end(), rawMidiEvent->data, rawMidiEvent->data + rawMidiEvent->size);
+
+                lastTime = rawMidiEvent->time;
+            }
+        }
 
-        if (fData.count() == 0)
+        if (binary.empty())
         {
-            *data = '\0';
+            char* const data((char*)std::calloc(1, 1));
+            CARLA_SAFE_ASSERT_RETURN(data != nullptr, nullptr);
             return data;
         }
 
-        char* dataWrtn = data;
-        int wrtn;
+        const std::size_t prefixLen = std::strlen(MIDI_PATTERN_STATE_PREFIX);
 
-        for (LinkedList<const RawMidiEvent*>::Itenerator it = fData.begin2(); it.valid(); it.next())
+        char* const data((char*)std::malloc(prefixLen + (binary.size() + 2) / 3 * 4 + 1));
+        CARLA_SAFE_ASSERT_RETURN(data != nullptr, nullptr);
+
+        std::memcpy(data, MIDI_PATTERN_STATE_PREFIX, prefixLen);
+        _encodeBase64(data + prefixLen, &binary.front(), binary.size());
+
+        return data;
+    }
+
+    void setState(const char* const data)
+    {
+        CARLA_SAFE_ASSERT_RETURN(data != nullptr,);
+
+        const std::size_t prefixLen = std::strlen(MIDI_PATTERN_STATE_PREFIX);
+
+        if (std::strncmp(data, MIDI_PATTERN_STATE_PREFIX, prefixLen) == 0)
+            setStateFromBinary(data + prefixLen);
+        else
+            setStateFromText(data);
+    }
+
+    // -------------------------------------------------------------------
+
+private:
+    AbstractMidiPlayer* const kPlayer;
+
+    uint8_t  fMidiPort;
+    uint32_t fStartTime;
+
+    CarlaMutex fReadMutex;
+    CarlaMutex fWriteMutex;
+    LinkedList<const RawMidiEvent*> fData;
+
+    static void fixZeroVelocityNoteOn(RawMidiEvent* const event) noexcept
+    {
+        if (MIDI_IS_STATUS_NOTE_ON(event->data[0]) && event->data[2] == 0)
+            event->data[0] = uint8_t(MIDI_STATUS_NOTE_OFF | (event->data[0] & MIDI_CHANNEL_BIT));
+    }
+
+    // -------------------------------------------------------------------
+    // binary state, as base64 of [varint delta-time, size, data...] per event
+
+    void setStateFromBinary(const char* const base64)
+    {
+        std::vector<uint8_t> binary;
+        carla_getChunkFromBase64String_impl(binary, base64);
+
+        std::vector<RawMidiEvent> events;
+        events.reserve(binary.size() / 3);
+
+        RawMidiEvent midiEvent;
+        uint32_t time = 0, delta;
+
+        for (std::size_t pos=0, size=binary.size(); pos < size;)
         {
-            const RawMidiEvent* const rawMidiEvent(it.getValue(nullptr));
-            CARLA_SAFE_ASSERT_CONTINUE(rawMidiEvent != nullptr);
+            CARLA_SAFE_ASSERT_RETURN(_readVarInt(binary, pos, delta),);
+            CARLA_SAFE_ASSERT_RETURN(delta <= 0xFFFFFFFFU - time,);
+            CARLA_SAFE_ASSERT_RETURN(pos < size,);
+
+            carla_zeroStruct(midiEvent);
+            time += delta;
+            midiEvent.time = time;
+            midiEvent.size = binary[pos++];
 
-            wrtn = std::snprintf(dataWrtn, maxTimeSize+6, "%u:%u:", rawMidiEvent->time, rawMidiEvent->size);
-            CARLA_SAFE_ASSERT_BREAK(wrtn > 0);
-            dataWrtn += wrtn;
+            CARLA_SAFE_ASSERT_RETURN(midiEvent.size > 0 && midiEvent.size <= MAX_EVENT_DATA_SIZE,);
+            CARLA_SAFE_ASSERT_RETURN(pos + midiEvent.size <= size,);
 
-            wrtn = std::snprintf(dataWrtn, 5, "0x%02X", rawMidiEvent->data[0]);
-            CARLA_SAFE_ASSERT_BREAK(wrtn > 0);
-            dataWrtn += wrtn;
+            std::memcpy(midiEvent.data, &binary[pos], midiEvent.size);
+            pos += midiEvent.size;
 
-            for (uint8_t i=1, size=rawMidiEvent->size; i<size; ++i)
+            CARLA_SAFE_ASSERT_RETURN(midiEvent.data[0] >= 0x80,);
+
+            for (uint8_t i=1; i<midiEvent.size; ++i)
             {
-                wrtn = std::snprintf(dataWrtn, 5, ":%03u", rawMidiEvent->data[i]);
-                CARLA_SAFE_ASSERT_BREAK(wrtn > 0);
-                dataWrtn += wrtn;
+                CARLA_SAFE_ASSERT_RETURN(midiEvent.data[i] < MAX_MIDI_VALUE,);
             }
 
-            *dataWrtn++ = '\n';
+            events.push_back(midiEvent);
         }
 
-        *dataWrtn = '\0';
+        if (events.empty())
+            clear();
+        else
+            setSortedRaw(&events.front(), events.size());
+    }
 
-        return data;
+    static void _writeVarInt(std::vector<uint8_t>& binary, uint32_t value)
+    {
+        for (; value >= 0x80; value >>= 7)
+            binary.push_back(static_cast<uint8_t>((value & 0x7F) | 0x80));
+
+        binary.push_back(static_cast<uint8_t>(value));
     }
 
-    void setState(const char* const data)
+    static bool _readVarInt(const std::vector<uint8_t>& binary, std::size_t& pos, uint32_t& value) noexcept
     {
-        CARLA_SAFE_ASSERT_RETURN(data != nullptr,);
+        value = 0;
+
+        for (uint shift=0; shift < 32 && pos < binary.size(); shift += 7)
+        {
+            const uint8_t byte = binary[pos++];
+
+            if (shift == 28 && byte > 0x0F)
+                return false;
+
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+
+            if ((byte & 0x80) == 0)
+                return true;
+        }
 
+        return false;
+    }
+
+    static void _encodeBase64(char* dst, const uint8_t* src, std::size_t size) noexcept
+    {
+        const char* const chars = CarlaBase64Helpers::kBase64Chars;
+
+        for (; size >= 3; size -= 3, src += 3)
+        {
+            *dst++ = chars[src[0] >> 2];
+            *dst++ = chars[((src[0] & 0x03) << 4) | (src[1] >> 4)];
+            *dst++ = chars[((src[1] & 0x0F) << 2) | (src[2] >> 6)];
+            *dst++ = chars[src[2] & 0x3F];
+        }
+
+        if (size != 0)
+        {
+            const uint8_t src1 = size > 1 ? src[1] : 0;
+
+            *dst++ = chars[src[0] >> 2];
+            *dst++ = chars[((src[0] & 0x03) << 4) | (src1 >> 4)];
+            *dst++ = size > 1 ? chars[(src1 & 0x0F) << 2] : '=';
+            *dst++ = '=';
+        }
+
+        *dst = '\0';
+    }
+
+    // -------------------------------------------------------------------
+    // text state, used by older versions
+
+    void setStateFromText(const char* const data)
+    {
         const size_t dataLen  = std::strlen(data);
         const char*  dataRead = data;
         const char*  needle;
@@ -453,16 +613,6 @@ public:
 
     // -------------------------------------------------------------------
 
-private:
-    AbstractMidiPlayer* const kPlayer;
-
-    uint8_t  fMidiPort;
-    uint32_t fStartTime;
-
-    CarlaMutex fReadMutex;
-    CarlaMutex fWriteMutex;
-    LinkedList<const RawMidiEvent*> fData;
-
     void appendSorted(const RawMidiEvent* const event)
     {
         const CarlaMutexLocker cmlw(fWriteMutex);
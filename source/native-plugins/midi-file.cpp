@@ -21,6 +21,9 @@
 #include "water/files/FileInputStream.h"
 #include "water/midi/MidiFile.h"
 
+#include <algorithm>
+#include <vector>
+
 // -----------------------------------------------------------------------
 
 class MidiFilePlugin : public NativePluginWithMidiPrograms<FileMIDI>,
@@ -353,6 +356,11 @@ private:
     uint64_t fLastFrame;
     NativeMidiPrograms fPrograms;
 
+    static bool _compareEventTime(const RawMidiEvent& a, const RawMidiEvent& b) noexcept
+    {
+        return a.time < b.time;
+    }
+
     void _loadMidiFile(const char* const filename)
     {
         fMidiOut.clear();
@@ -382,6 +390,16 @@ private:
         const double sampleRate = getSampleRate();
         const size_t numTracks = midiFile.getNumTracks();
 
+        // collect events from all tracks first, then sort and hand them over in one go
+        std::vector<RawMidiEvent> events;
+        {
+            size_t totalEvents = 0;
+            for (size_t i=0; i<numTracks; ++i)
+                if (const MidiMessageSequence* const track = midiFile.getTrack(i))
+                    totalEvents += static_cast<size_t>(track->getNumEvents());
+            events.reserve(totalEvents);
+        }
+
         for (size_t i=0; i<numTracks; ++i)
         {
             const MidiMessageSequence* const track = midiFile.getTrack(i);
@@ -406,11 +424,22 @@ private:
                 // const double time = track->getEventTime(i) * sampleRate;
                 CARLA_SAFE_ASSERT_CONTINUE(time >= 0.0);
 
-                fMidiOut.addRaw(static_cast<uint32_t>(time + 0.5),
-                                midiMessage.getRawData(), static_cast<uint8_t>(dataSize));
+                RawMidiEvent rawEvent;
+                carla_zeroStruct(rawEvent);
+                rawEvent.time = static_cast<uint32_t>(time + 0.5);
+                rawEvent.size = static_cast<uint8_t>(dataSize);
+                carla_copy<uint8_t>(rawEvent.data, data, rawEvent.size);
+
+                events.push_back(rawEvent);
             }
         }
 
+        // stable, so events with the same time keep their track and file order
+        std::stable_sort(events.begin(), events.end(), _compareEventTime);
+
+        if (! events.empty())
+            fMidiOut.setSortedRaw(&events.front(), events.size());
+
         const double lastTimeStamp = midiFile.getLastTimestamp();
 
         fFileLength = static_cast<float>(lastTimeStamp);
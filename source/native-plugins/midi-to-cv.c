@@ -39,8 +39,6 @@ typedef enum {
 typedef struct {
     // keep track of active notes
     uint8_t activeNotesList[NUM_NOTESBUFFER];
-    uint8_t reTriggerBuffer[NUM_NOTESBUFFER];
-    uint8_t triggerIndex;
     uint8_t activeNotes;
     uint8_t activeVelocity;
     uint8_t reTriggered;
@@ -49,6 +47,7 @@ typedef struct {
 
     // other stuff
     bool triggerState;
+    bool retriggerPending; // gate goes low for 1 sample at the next written frame
     int notesPressed;
     float params[PARAM_COUNT];
 
@@ -57,8 +56,6 @@ typedef struct {
 static void panic(Midi2CvHandle* const handle)
 {
     memset(handle->activeNotesList, 200, sizeof(uint8_t)*NUM_NOTESBUFFER);
-    memset(handle->reTriggerBuffer, 0, sizeof(uint8_t)*NUM_NOTESBUFFER);
-    handle->triggerIndex = 0;
     handle->reTriggered = 200;
     handle->activeNotes = 0;
     handle->activeVelocity = 0;
@@ -66,6 +63,7 @@ static void panic(Midi2CvHandle* const handle)
     handle->notesPressed = 0;
     handle->notesIndex = 0;
     handle->triggerState = false;
+    handle->retriggerPending = false;
 }
 
 static void set_status(Midi2CvHandle* const handle, int status)
@@ -74,6 +72,52 @@ static void set_status(Midi2CvHandle* const handle, int status)
   handle->triggerState = status;
 }
 
+static void update_status(Midi2CvHandle* const handle)
+{
+    int checked_note = 0;
+    bool active_notes_found = false;
+    while (checked_note < NUM_NOTESBUFFER && ! active_notes_found)
+    {
+        if (handle->activeNotesList[checked_note] != 200)
+            active_notes_found = true;
+        checked_note++;
+    }
+
+    if (active_notes_found)
+    {
+        set_status(handle, 1);
+    }
+    else
+    {
+        set_status(handle, 0);
+        handle->activeVelocity = 0;
+    }
+}
+
+static void fill_floats(float* const data, const float value, const uint32_t count)
+{
+    for (uint32_t i=0; i < count; ++i)
+        data[i] = value;
+}
+
+// write current state into the outputs for frames [start, start+count)
+static void write_outputs(Midi2CvHandle* const handle, float** const outBuffer,
+                          const uint32_t start, const uint32_t count, const float pitchOffset)
+{
+    if (count == 0)
+        return;
+
+    fill_floats(outBuffer[0] + start, pitchOffset + (float)handle->activeNotes * 1/12.0f, count);
+    fill_floats(outBuffer[1] + start, (float)handle->activeVelocity * 1/12.0f, count);
+    fill_floats(outBuffer[2] + start, handle->triggerState ? 10.0f : 0.0f, count);
+
+    if (handle->retriggerPending)
+    {
+        handle->retriggerPending = false;
+        outBuffer[2][start] = 0.0f;
+    }
+}
+
 // -----------------------------------------------------------------------
 
 static NativePluginHandle midi2cv_instantiate(const NativeHostDescriptor* host)
@@ -239,16 +283,15 @@ static void midi2cv_process(NativePluginHandle handle,
                                 float** inBuffer, float** outBuffer, uint32_t frames,
                                 const NativeMidiEvent* midiEvents, uint32_t midiEventCount)
 {
-    float* const pitch    = outBuffer[0];
-    float* const velocity = outBuffer[1];
-    float* const trigger  = outBuffer[2];
-
     const float oC = handlePtr->params[PARAM_OCTAVE];
     const float sC = handlePtr->params[PARAM_SEMITONE];
     const float cC = handlePtr->params[PARAM_CENT];
     const bool  rC = handlePtr->params[PARAM_RETRIGGER] > 0.5f;
 
+    const float pitchOffset = 0.0f + (float)((oC) + (sC/12.0f)+(cC/1200.0f));
+
     bool retrigger = true;
+    uint32_t pos = 0;
 
     for (uint32_t i=0; i < midiEventCount; ++i)
     {
@@ -257,6 +300,16 @@ static void midi2cv_process(NativePluginHandle handle,
         if (midiEvent->size <= 1 || midiEvent->size > 3)
             continue;
 
+        // output the state so far up to this event
+        uint32_t time = midiEvent->time;
+        if (time > frames)
+            time = frames;
+        if (time > pos)
+        {
+            write_outputs(handlePtr, outBuffer, pos, time - pos, pitchOffset);
+            pos = time;
+        }
+
         const uint8_t* const mdata = midiEvent->data;
         const uint8_t status = MIDI_GET_STATUS_FROM_DATA(mdata);
 
@@ -279,8 +332,7 @@ static void midi2cv_process(NativePluginHandle handle,
             }
             handlePtr->activeNotes = mdata[1];
             handlePtr->activeVelocity = mdata[2];
-            handlePtr->triggerIndex = (handlePtr->triggerIndex + 1U) % 8U;
-            handlePtr->reTriggerBuffer[handlePtr->triggerIndex] = 1U;
+            handlePtr->retriggerPending = rC;
             handlePtr->reTriggered = mdata[1];
             break;
 
@@ -310,39 +362,12 @@ static void midi2cv_process(NativePluginHandle handle,
                 panic(handlePtr);
             break;
         }
-    }
 
-    int checked_note = 0;
-    bool active_notes_found = false;
-    while (checked_note < NUM_NOTESBUFFER && ! active_notes_found)
-    {
-        if (handlePtr->activeNotesList[checked_note] != 200)
-            active_notes_found = true;
-        checked_note++;
+        update_status(handlePtr);
     }
 
-    if (active_notes_found)
-    {
-        set_status(handlePtr, 1);
-    }
-    else
-    {
-        set_status(handlePtr, 0);
-        handlePtr->activeVelocity = 0;
-    }
-
-    for (uint32_t i=0; i<frames; ++i)
-    {
-        pitch[i]    = (0.0f + (float)((oC) + (sC/12.0f)+(cC/1200.0f)) + ((float)handlePtr->activeNotes * 1/12.0f));
-        velocity[i] = (0.0f + ((float)handlePtr->activeVelocity * 1/12.0f));
-        trigger[i]  = ((handlePtr->triggerState == true) ? 10.0f : 0.0f);
-
-        if (handlePtr->reTriggerBuffer[handlePtr->triggerIndex] == 1 && rC)
-        {
-            handlePtr->reTriggerBuffer[handlePtr->triggerIndex] = 0;
-            trigger[i] = 0.0f;
-        }
-    }
+    update_status(handlePtr);
+    write_outputs(handlePtr, outBuffer, pos, frames - pos, pitchOffset);
 
     return;
 
@@ -47,6 +47,7 @@ struct PluginListManager {
             CARLA_SAFE_ASSERT_BREAK(desc != nullptr);
 
             if (std::strcmp(desc->label, "audiofile"       ) == 0 ||
+                std::strcmp(desc->label, "audiofile8"      ) == 0 ||
                 std::strcmp(desc->label, "audiogain"       ) == 0 ||
                 std::strcmp(desc->label, "audiogain_s"     ) == 0 ||
                 std::strcmp(desc->label, "lfo"             ) == 0 ||
@@ -444,7 +444,7 @@ static void writePluginFile(const NativePluginDescriptor* const pluginDesc,
 
     if (pluginDesc->hints & NATIVE_PLUGIN_NEEDS_UI_OPEN_SAVE)
     {
-        /**/ if (pluginLabel == "audiofile")
+        /**/ if (pluginLabel == "audiofile" || pluginLabel == "audiofile8")
             text += "    patch:writable <http://kxstudio.sf.net/carla/file/audio> ;\n\n";
         else if (pluginLabel == "midifile")
             text += "    patch:writable <http://kxstudio.sf.net/carla/file/midi> ;\n\n";
@@ -288,7 +288,7 @@ public:
 
                             const LV2_URID urid = ((const LV2_Atom_URID*)property)->body;
 
-                            /*  */ if (std::strcmp(fDescriptor->label, "audiofile") == 0) {
+                            /*  */ if (std::strcmp(fDescriptor->label, "audiofile") == 0 || std::strcmp(fDescriptor->label, "audiofile8") == 0) {
                                 CARLA_SAFE_ASSERT_CONTINUE(urid == fURIs.carlaFileAudio);
                             } else if (std::strcmp(fDescriptor->label, "midifile") == 0) {
                                 CARLA_SAFE_ASSERT_CONTINUE(urid == fURIs.carlaFileMIDI);
@@ -367,7 +367,7 @@ public:
 
                     lv2_atom_forge_key(&atomForge, fURIs.patchProperty);
 
-                    /*  */ if (std::strcmp(fDescriptor->label, "audiofile") == 0) {
+                    /*  */ if (std::strcmp(fDescriptor->label, "audiofile") == 0 || std::strcmp(fDescriptor->label, "audiofile8") == 0) {
                         lv2_atom_forge_urid(&atomForge, fURIs.carlaFileAudio);
                     } else if (std::strcmp(fDescriptor->label, "midifile") == 0) {
                         lv2_atom_forge_urid(&atomForge, fURIs.carlaFileMIDI);
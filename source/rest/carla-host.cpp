@@ -206,6 +206,43 @@ void handle_carla_save_project(const std::shared_ptr<Session> session)
     session->close(OK, buf, { { "Content-Length", size_buf(buf) } } );
 }
 
+void handle_carla_render_to_file(const std::shared_ptr<Session> session)
+{
+    const std::shared_ptr<const Request> request = session->get_request();
+
+    const std::string filename = request->get_query_parameter("filename");
+
+    const long int start = std::atol(request->get_query_parameter("start").c_str());
+    CARLA_SAFE_ASSERT_RETURN(start >= 0,)
+
+    const long int end = std::atol(request->get_query_parameter("end").c_str());
+    CARLA_SAFE_ASSERT_RETURN(end > start,)
+
+    // comma separated list of plugin ids
+    std::vector<uint> stems;
+    const std::string stemList = request->get_query_parameter("stems");
+
+    for (const char* s = stemList.c_str(); *s != '\0';)
+    {
+        char* next;
+        const long int pluginId = std::strtol(s, &next, 10);
+        CARLA_SAFE_ASSERT_RETURN(next != s && pluginId >= 0,)
+
+        stems.push_back(static_cast<uint>(pluginId));
+
+        s = next;
+        if (*s == ',')
+            ++s;
+    }
+
+    const char* const buf = str_buf_bool(carla_render_to_file(filename.c_str(),
+                                                              static_cast<uint64_t>(start),
+                                                              static_cast<uint64_t>(end),
+                                                              stems.empty() ? nullptr : &stems[0],
+                                                              static_cast<uint>(stems.size())));
+    session->close(OK, buf, { { "Content-Length", size_buf(buf) } } );
+}
+
 // -------------------------------------------------------------------------------------------------------------------
 
 void handle_carla_patchbay_connect(const std::shared_ptr<Session> session)
@@ -341,6 +341,7 @@ int main(int, const char**)
     make_resource(service, "/load_file", handle_carla_load_file);
     make_resource(service, "/load_project", handle_carla_load_project);
     make_resource(service, "/save_project", handle_carla_save_project);
+    make_resource(service, "/render_to_file", handle_carla_render_to_file);
 
     make_resource(service, "/patchbay_connect", handle_carla_patchbay_connect);
     make_resource(service, "/patchbay_disconnect", handle_carla_patchbay_disconnect);
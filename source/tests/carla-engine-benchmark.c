@@ -0,0 +1,547 @@
+/*
+ * Carla Engine micro-benchmark
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+/*
+ * Builds synthetic sessions of internal plugins on the dummy engine and renders them offline,
+ * reporting the time spent per audio block and the overhead of each extra plugin.
+ * The same session without any plugins is used as baseline, so rendering and file I/O costs cancel out.
+ *
+ * Usage: carla-engine-benchmark [-s seconds] [-m mode] [-p label] [-n count] [-b buffer-size] [-e events-per-second]
+ *                              [-f soundfont] [-c fluidsynth-cpu-cores] [-l ladspa-file | -u]
+ * Every option restricts the default matrix to a single value, modes are "rack", "chain" and "parallel".
+ * With "-f" the given SoundFont is benchmarked instead of internal plugins, at maximum polyphony;
+ * combine it with a high event density to measure voice rendering, and "-c" to compare core counts.
+ * With "-l" the "-p" label is a plugin inside the given LADSPA file, with "-u" it is an LV2 URI.
+ * Such mono plugins are forced to stereo, and each configuration runs once with two instances ("dual")
+ * and once with both channels going through a single instance ("single"),
+ * the latter only taking effect for plugins Carla knows to be stateless.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "CarlaHost.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+#define MAX_GROUPS 256
+#define MAX_PORTS  2048
+
+typedef enum {
+    BENCH_MODE_RACK,
+    BENCH_MODE_PATCHBAY_CHAIN,
+    BENCH_MODE_PATCHBAY_PARALLEL
+} BenchMode;
+
+typedef struct {
+    BenchMode mode;
+    const char* label;
+    uint count;
+    uint bufferSize;
+    uint eventsPerSecond;
+    uint options;
+} BenchConfig;
+
+typedef struct {
+    uint group;
+    int pluginId;
+} BenchGroup;
+
+typedef struct {
+    uint group;
+    uint port;
+    uint hints;
+} BenchPort;
+
+static const char* const kModeNames[] = { "rack", "chain", "parallel" };
+static const char* const kDefaultLabels[] = { "audiogain", "bypass", "midithrough", "lfo" };
+static const uint kDefaultCounts[] = { 1, 8, 32 };
+static const uint kDefaultBufferSizes[] = { 64, 256, 1024 };
+static const uint kDefaultEventDensities[] = { 0, 100, 1000 };
+static const uint kStereoOptions[] = {
+    PLUGIN_OPTION_FORCE_STEREO,
+    PLUGIN_OPTION_FORCE_STEREO|PLUGIN_OPTION_FORCE_STEREO_SINGLE_INSTANCE
+};
+
+static const uint kSampleRate = 48000;
+
+/* FluidSynth parameter index and maximum for polyphony */
+static const uint32_t kFluidSynthPolyphony = 11;
+static const float kFluidSynthMaxPolyphony = 512.0f;
+
+/* internal plugins only need this for their UIs, which are never shown here */
+static const char* const kResourceDir = "../../resources";
+
+static BenchGroup gGroups[MAX_GROUPS];
+static BenchPort gPorts[MAX_PORTS];
+static uint gNumGroups, gNumPorts;
+
+static char gAudioFilename[256];
+static char gMidiFilename[256];
+
+static const char* gSoundFont = NULL;
+static uint gFluidSynthCpuCores = 1;
+
+static PluginType gPluginType = PLUGIN_INTERNAL;
+static const char* gPluginFile = "";
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static void engine_callback(void* ptr, EngineCallbackOpcode action, uint pluginId,
+                            int value1, int value2, int value3, float valuef, const char* valueStr)
+{
+    switch (action)
+    {
+    case ENGINE_CALLBACK_PATCHBAY_CLIENT_ADDED:
+        if (gNumGroups < MAX_GROUPS)
+        {
+            gGroups[gNumGroups].group = pluginId;
+            gGroups[gNumGroups].pluginId = value2;
+            ++gNumGroups;
+        }
+        break;
+
+    case ENGINE_CALLBACK_PATCHBAY_PORT_ADDED:
+        if (gNumPorts < MAX_PORTS)
+        {
+            gPorts[gNumPorts].group = pluginId;
+            gPorts[gNumPorts].port = (uint)value1;
+            gPorts[gNumPorts].hints = (uint)value2;
+            ++gNumPorts;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return;
+
+    /* unused */
+    (void)ptr; (void)value3; (void)valuef; (void)valueStr;
+}
+
+static double get_time_in_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+/* MIDI file with a steady stream of short notes, used as event source */
+
+static void write_var_len(FILE* const f, uint value)
+{
+    unsigned char buf[4];
+    int i = 0;
+
+    buf[i++] = value & 0x7f;
+
+    while ((value >>= 7) != 0)
+        buf[i++] = (unsigned char)(0x80 | (value & 0x7f));
+
+    while (i > 0)
+        fputc(buf[--i], f);
+}
+
+static void write_be(FILE* const f, const uint value, const int bytes)
+{
+    for (int i = bytes - 1; i >= 0; --i)
+        fputc((int)((value >> (i * 8)) & 0xff), f);
+}
+
+static bool write_midi_file(const char* const filename, const uint notesPerSecond, const uint seconds)
+{
+    /* default tempo of 120 BPM at 480 ticks per beat */
+    const uint ticksPerSecond = 960;
+
+    if (notesPerSecond == 0)
+        return false;
+
+    const uint noteCount = notesPerSecond * seconds;
+    const uint interval = ticksPerSecond / notesPerSecond > 1 ? ticksPerSecond / notesPerSecond : 2;
+    FILE* const f = fopen(filename, "wb");
+
+    if (f == NULL)
+        return false;
+
+    fwrite("MThd", 1, 4, f);
+    write_be(f, 6, 4);
+    write_be(f, 0, 2);
+    write_be(f, 1, 2);
+    write_be(f, 480, 2);
+
+    fwrite("MTrk", 1, 4, f);
+    const long sizePos = ftell(f);
+    write_be(f, 0, 4);
+
+    for (uint i = 0; i < noteCount; ++i)
+    {
+        const unsigned char note = (unsigned char)(36 + i % 48);
+
+        write_var_len(f, i == 0 ? 0 : interval - interval / 2);
+        fputc(0x90, f); fputc(note, f); fputc(100, f);
+        write_var_len(f, interval / 2);
+        fputc(0x80, f); fputc(note, f); fputc(0, f);
+    }
+
+    write_var_len(f, 0);
+    fputc(0xff, f); fputc(0x2f, f); fputc(0x00, f);
+
+    const long endPos = ftell(f);
+    fseek(f, sizePos, SEEK_SET);
+    write_be(f, (uint)(endPos - sizePos - 4), 4);
+    fclose(f);
+
+    return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+/* patchbay helpers */
+
+static uint find_io_group(const uint hints)
+{
+    for (uint i = 0; i < gNumGroups; ++i)
+    {
+        if (gGroups[i].pluginId >= 0)
+            continue;
+
+        for (uint j = 0; j < gNumPorts; ++j)
+            if (gPorts[j].group == gGroups[i].group && gPorts[j].hints == hints)
+                return gGroups[i].group;
+    }
+
+    return (uint)-1;
+}
+
+static uint find_plugin_group(const int pluginId)
+{
+    for (uint i = 0; i < gNumGroups; ++i)
+        if (gGroups[i].pluginId == pluginId)
+            return gGroups[i].group;
+
+    return (uint)-1;
+}
+
+/* connect every input of type in groupB to the outputs of the same type in groupA, wrapping around */
+static void connect_groups(const CarlaHostHandle handle, const uint groupA, const uint groupB, const uint type)
+{
+    uint outs[64], numOuts = 0;
+
+    if (groupA == (uint)-1 || groupB == (uint)-1)
+        return;
+
+    for (uint i = 0; i < gNumPorts && numOuts < 64; ++i)
+        if (gPorts[i].group == groupA && gPorts[i].hints == type)
+            outs[numOuts++] = gPorts[i].port;
+
+    if (numOuts == 0)
+        return;
+
+    for (uint i = 0, j = 0; i < gNumPorts; ++i)
+        if (gPorts[i].group == groupB && gPorts[i].hints == (type | PATCHBAY_PORT_IS_INPUT))
+            carla_patchbay_connect(handle, false, groupA, outs[j++ % numOuts], groupB, gPorts[i].port);
+}
+
+static void connect_patchbay(const CarlaHostHandle handle, const BenchConfig* const cfg, const int firstPluginId)
+{
+    const uint audioSource = find_io_group(PATCHBAY_PORT_TYPE_AUDIO);
+    const uint audioSink   = find_io_group(PATCHBAY_PORT_TYPE_AUDIO | PATCHBAY_PORT_IS_INPUT);
+    const uint midiSink    = find_io_group(PATCHBAY_PORT_TYPE_MIDI | PATCHBAY_PORT_IS_INPUT);
+    const uint midiSource  = firstPluginId > 0 ? find_plugin_group(0) : find_io_group(PATCHBAY_PORT_TYPE_MIDI);
+
+    uint prevAudio = audioSource, prevMidi = midiSource;
+
+    for (uint i = 0; i < cfg->count; ++i)
+    {
+        const uint group = find_plugin_group(firstPluginId + (int)i);
+
+        connect_groups(handle, prevAudio, group, PATCHBAY_PORT_TYPE_AUDIO);
+        connect_groups(handle, prevMidi, group, PATCHBAY_PORT_TYPE_MIDI);
+
+        if (cfg->mode == BENCH_MODE_PATCHBAY_PARALLEL)
+        {
+            connect_groups(handle, group, audioSink, PATCHBAY_PORT_TYPE_AUDIO);
+            connect_groups(handle, group, midiSink, PATCHBAY_PORT_TYPE_MIDI);
+        }
+        else
+        {
+            prevAudio = prevMidi = group;
+        }
+    }
+
+    if (cfg->mode == BENCH_MODE_PATCHBAY_CHAIN)
+    {
+        connect_groups(handle, prevAudio, audioSink, PATCHBAY_PORT_TYPE_AUDIO);
+        connect_groups(handle, prevMidi, midiSink, PATCHBAY_PORT_TYPE_MIDI);
+    }
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+/* returns nanoseconds per block, or a negative value on failure (-2 if the engine does not support the mode) */
+static double run_config(const CarlaHostHandle handle, const BenchConfig* const cfg, const uint seconds)
+{
+    const uint64_t numFrames = (uint64_t)kSampleRate * seconds;
+    int firstPluginId = 0;
+    double start, end;
+    bool ok;
+
+    gNumGroups = gNumPorts = 0;
+
+    carla_set_engine_option(handle, ENGINE_OPTION_PROCESS_MODE,
+                            cfg->mode == BENCH_MODE_RACK ? ENGINE_PROCESS_MODE_CONTINUOUS_RACK
+                                                         : ENGINE_PROCESS_MODE_PATCHBAY, NULL);
+    carla_set_engine_option(handle, ENGINE_OPTION_AUDIO_BUFFER_SIZE, (int)cfg->bufferSize, NULL);
+    carla_set_engine_option(handle, ENGINE_OPTION_AUDIO_SAMPLE_RATE, (int)kSampleRate, NULL);
+    carla_set_engine_option(handle, ENGINE_OPTION_TRANSPORT_MODE, ENGINE_TRANSPORT_MODE_INTERNAL, "");
+    carla_set_engine_option(handle, ENGINE_OPTION_PATH_RESOURCES, 0, kResourceDir);
+    carla_set_engine_option(handle, ENGINE_OPTION_FLUIDSYNTH_CPU_CORES, (int)gFluidSynthCpuCores, NULL);
+
+    if (! carla_engine_init(handle, "Dummy", "Carla-Benchmark"))
+    {
+        fprintf(stderr, "carla_engine_init failed: %s\n", carla_get_last_error(handle));
+        return -2.0;
+    }
+
+    if (cfg->eventsPerSecond != 0)
+    {
+        if (! write_midi_file(gMidiFilename, cfg->eventsPerSecond / 2, seconds + 1) ||
+            ! carla_load_file(handle, gMidiFilename))
+        {
+            fprintf(stderr, "failed to set up MIDI file source: %s\n", carla_get_last_error(handle));
+            carla_engine_close(handle);
+            return -1.0;
+        }
+
+        firstPluginId = 1;
+    }
+
+    for (uint i = 0; i < cfg->count; ++i)
+    {
+        const bool added = gSoundFont != NULL
+                         ? carla_add_plugin(handle, BINARY_NATIVE, PLUGIN_SF2, gSoundFont, "", "", 0, NULL, 0x0)
+                         : carla_add_plugin(handle, BINARY_NATIVE, gPluginType, gPluginFile, "", cfg->label,
+                                            0, NULL, cfg->options);
+
+        if (! added)
+        {
+            fprintf(stderr, "failed to add plugin '%s': %s\n", cfg->label, carla_get_last_error(handle));
+            carla_engine_close(handle);
+            return -1.0;
+        }
+
+        if (gSoundFont != NULL)
+            carla_set_parameter_value(handle, (uint)firstPluginId + i, kFluidSynthPolyphony, kFluidSynthMaxPolyphony);
+    }
+
+    if (cfg->mode != BENCH_MODE_RACK)
+        connect_patchbay(handle, cfg, firstPluginId);
+
+    /* warm up caches and plugin state first, only the second pass is measured */
+    ok = carla_render_to_file(handle, gAudioFilename, 0, numFrames / 4, NULL, 0);
+
+    start = get_time_in_ns();
+    ok = ok && carla_render_to_file(handle, gAudioFilename, 0, numFrames, NULL, 0);
+    end = get_time_in_ns();
+
+    if (! ok)
+        fprintf(stderr, "carla_render_to_file failed: %s\n", carla_get_last_error(handle));
+
+    carla_engine_close(handle);
+    unlink(gAudioFilename);
+
+    if (cfg->eventsPerSecond != 0)
+        unlink(gMidiFilename);
+
+    return ok ? (end - start) / (double)((numFrames + cfg->bufferSize - 1) / cfg->bufferSize) : -1.0;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static bool parse_mode(const char* const name, BenchMode* const mode)
+{
+    for (uint i = 0; i < sizeof(kModeNames)/sizeof(kModeNames[0]); ++i)
+    {
+        if (strcmp(name, kModeNames[i]) == 0)
+        {
+            *mode = (BenchMode)i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int main(int argc, char* argv[])
+{
+    BenchMode modes[3] = { BENCH_MODE_RACK, BENCH_MODE_PATCHBAY_CHAIN, BENCH_MODE_PATCHBAY_PARALLEL };
+    const char* labels[4];
+    uint counts[3], bufferSizes[3], densities[3];
+    uint numModes = 3, numLabels = 4, numCounts = 3, numBufferSizes = 3, numDensities = 3;
+    uint seconds = 10;
+    uint numStereoOptions = 1;
+    int opt;
+
+    memcpy(labels, kDefaultLabels, sizeof(labels));
+    memcpy(counts, kDefaultCounts, sizeof(counts));
+    memcpy(bufferSizes, kDefaultBufferSizes, sizeof(bufferSizes));
+    memcpy(densities, kDefaultEventDensities, sizeof(densities));
+
+    while ((opt = getopt(argc, argv, "s:m:p:n:b:e:f:c:l:uh")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            seconds = (uint)atoi(optarg);
+            break;
+        case 'm':
+            if (! parse_mode(optarg, &modes[0]))
+            {
+                fprintf(stderr, "unknown mode '%s'\n", optarg);
+                return 1;
+            }
+            numModes = 1;
+            break;
+        case 'p':
+            labels[0] = optarg;
+            numLabels = 1;
+            break;
+        case 'n':
+            counts[0] = (uint)atoi(optarg);
+            numCounts = 1;
+            break;
+        case 'b':
+            bufferSizes[0] = (uint)atoi(optarg);
+            numBufferSizes = 1;
+            break;
+        case 'e':
+            densities[0] = (uint)atoi(optarg);
+            numDensities = 1;
+            break;
+        case 'f':
+            gSoundFont = optarg;
+            labels[0] = "soundfont";
+            numLabels = 1;
+            break;
+        case 'c':
+            gFluidSynthCpuCores = (uint)atoi(optarg);
+            break;
+        case 'l':
+            gPluginType = PLUGIN_LADSPA;
+            gPluginFile = optarg;
+            numStereoOptions = 2;
+            break;
+        case 'u':
+            gPluginType = PLUGIN_LV2;
+            numStereoOptions = 2;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-s seconds] [-m rack|chain|parallel] [-p label] [-n count] "
+                            "[-b buffer-size] [-e events-per-second] [-f soundfont] [-c fluidsynth-cpu-cores] "
+                            "[-l ladspa-file | -u]\n",
+                    argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (gPluginType != PLUGIN_INTERNAL && (numLabels != 1 || gSoundFont != NULL))
+    {
+        fprintf(stderr, "a plugin label or URI is required with -l and -u, and cannot be combined with -f\n");
+        return 1;
+    }
+
+    if (seconds == 0 || counts[0] == 0 || bufferSizes[0] == 0 || gFluidSynthCpuCores == 0)
+    {
+        fprintf(stderr, "invalid arguments\n");
+        return 1;
+    }
+
+    /* each note is a note-on and note-off pair */
+    if (numDensities == 1 && densities[0] == 1)
+    {
+        fprintf(stderr, "events-per-second must be 0 (no events) or at least 2\n");
+        return 1;
+    }
+
+    snprintf(gAudioFilename, sizeof(gAudioFilename), "/tmp/carla-benchmark-%i.wav", (int)getpid());
+    snprintf(gMidiFilename, sizeof(gMidiFilename), "/tmp/carla-benchmark-%i.mid", (int)getpid());
+
+    const CarlaHostHandle handle = carla_standalone_host_init();
+    carla_set_engine_callback(handle, engine_callback, NULL);
+
+    printf("%-9s %-12s %-6s %5s %6s %8s %14s %16s\n",
+           "mode", "plugin", "stereo", "count", "buffer", "events/s", "ns/block", "ns/block/plugin");
+
+    for (uint m = 0; m < numModes; ++m)
+    {
+        for (uint b = 0; b < numBufferSizes; ++b)
+        {
+            for (uint e = 0; e < numDensities; ++e)
+            {
+                const BenchConfig baseCfg = { modes[m], "", 0, bufferSizes[b], densities[e], 0x0 };
+                const double baseline = run_config(handle, &baseCfg, seconds);
+
+                if (baseline < -1.5)
+                {
+                    printf("%-9s %-12s %-6s %5s %6u %8u %14s %16s\n",
+                           kModeNames[modes[m]], "(none)", "-", "-", bufferSizes[b], densities[e], "unsupported", "-");
+                    continue;
+                }
+
+                if (baseline < 0.0)
+                    return 1;
+
+                printf("%-9s %-12s %-6s %5u %6u %8u %14.0f %16s\n",
+                       kModeNames[modes[m]], "(none)", "-", 0, bufferSizes[b], densities[e], baseline, "-");
+
+                for (uint p = 0; p < numLabels; ++p)
+                {
+                    for (uint c = 0; c < numCounts; ++c)
+                    {
+                        for (uint s = 0; s < numStereoOptions; ++s)
+                        {
+                            const uint options = gPluginType != PLUGIN_INTERNAL ? kStereoOptions[s] : 0x0;
+                            const char* const stereo = gPluginType == PLUGIN_INTERNAL ? "-" : s == 0 ? "dual" : "single";
+                            const BenchConfig cfg = { modes[m], labels[p], counts[c], bufferSizes[b], densities[e],
+                                                      options };
+                            const double result = run_config(handle, &cfg, seconds);
+
+                            if (result < 0.0)
+                                return 1;
+
+                            printf("%-9s %-12s %-6s %5u %6u %8u %14.0f %16.0f\n",
+                                   kModeNames[modes[m]], labels[p], stereo, counts[c], bufferSizes[b], densities[e],
+                                   result, (result - baseline) / counts[c]);
+                            fflush(stdout);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
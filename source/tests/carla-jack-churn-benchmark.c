@@ -0,0 +1,310 @@
+/*
+ * Carla JACK patchbay churn benchmark
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+/*
+ * Starts the JACK engine with an external patchbay, then simulates mass port churn through separate JACK clients:
+ * several clients coming up with many ports and going away again, plus ports that are registered and removed
+ * right away. Reports how many patchbay callbacks each round produced, in how many bursts they arrived,
+ * and how long it took for the patchbay to settle.
+ * Requires a running JACK server, libjack is loaded at runtime so this builds without JACK development files.
+ *
+ * Usage: carla-jack-churn-benchmark [-c clients] [-p ports-per-client] [-t transient-ports] [-r rounds]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "CarlaHost.h"
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+/* minimal libjack API, loaded at runtime */
+
+#define JACK_NO_START_SERVER 0x01
+#define JACK_PORT_IS_OUTPUT  0x02
+#define JACK_AUDIO_TYPE      "32 bit float mono audio"
+
+typedef struct _jack_client jack_client_t;
+typedef struct _jack_port jack_port_t;
+
+typedef jack_client_t* (*jack_client_open_t)(const char*, int, int*, ...);
+typedef int (*jack_client_close_t)(jack_client_t*);
+typedef int (*jack_activate_t)(jack_client_t*);
+typedef jack_port_t* (*jack_port_register_t)(jack_client_t*, const char*, const char*, unsigned long, unsigned long);
+typedef int (*jack_port_unregister_t)(jack_client_t*, jack_port_t*);
+
+static struct {
+    void* lib;
+    jack_client_open_t client_open;
+    jack_client_close_t client_close;
+    jack_activate_t activate;
+    jack_port_register_t port_register;
+    jack_port_unregister_t port_unregister;
+} gJack;
+
+static bool load_jack(void)
+{
+    gJack.lib = dlopen("libjack.so.0", RTLD_NOW|RTLD_LOCAL);
+
+    if (gJack.lib == NULL)
+        return false;
+
+    *(void**)&gJack.client_open = dlsym(gJack.lib, "jack_client_open");
+    *(void**)&gJack.client_close = dlsym(gJack.lib, "jack_client_close");
+    *(void**)&gJack.activate = dlsym(gJack.lib, "jack_activate");
+    *(void**)&gJack.port_register = dlsym(gJack.lib, "jack_port_register");
+    *(void**)&gJack.port_unregister = dlsym(gJack.lib, "jack_port_unregister");
+
+    return gJack.client_open != NULL && gJack.client_close != NULL && gJack.activate != NULL &&
+           gJack.port_register != NULL && gJack.port_unregister != NULL;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+#define MAX_CLIENTS 64
+
+/* a new burst of callbacks starts after this much silence */
+static const double kBurstGap = 5e6;
+
+/* the patchbay is considered settled after this much silence */
+static const double kSettleTime = 1e9;
+static const double kMaxWaitTime = 20e9;
+
+typedef struct {
+    uint clientsAdded, clientsRemoved;
+    uint portsAdded, portsRemoved;
+    uint connections;
+    uint bursts;
+    double lastCallback;
+} ChurnStats;
+
+static ChurnStats gStats;
+
+static double get_time_in_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* called from the engine's jack-events thread, the main thread only reads the stats after settling */
+static void engine_callback(void* ptr, EngineCallbackOpcode action, uint pluginId,
+                            int value1, int value2, int value3, float valuef, const char* valueStr)
+{
+    const double now = get_time_in_ns();
+
+    switch (action)
+    {
+    case ENGINE_CALLBACK_PATCHBAY_CLIENT_ADDED:
+        ++gStats.clientsAdded;
+        break;
+    case ENGINE_CALLBACK_PATCHBAY_CLIENT_REMOVED:
+        ++gStats.clientsRemoved;
+        break;
+    case ENGINE_CALLBACK_PATCHBAY_PORT_ADDED:
+        ++gStats.portsAdded;
+        break;
+    case ENGINE_CALLBACK_PATCHBAY_PORT_REMOVED:
+        ++gStats.portsRemoved;
+        break;
+    case ENGINE_CALLBACK_PATCHBAY_CONNECTION_ADDED:
+    case ENGINE_CALLBACK_PATCHBAY_CONNECTION_REMOVED:
+        ++gStats.connections;
+        break;
+    default:
+        return;
+    }
+
+    if (now - gStats.lastCallback > kBurstGap)
+        ++gStats.bursts;
+
+    __sync_synchronize();
+    gStats.lastCallback = now;
+    return;
+
+    /* unused */
+    (void)ptr; (void)pluginId; (void)value1; (void)value2; (void)value3; (void)valuef; (void)valueStr;
+}
+
+/* returns settle time in nanoseconds relative to start, or a negative value if the patchbay never went quiet */
+static double wait_for_settle(const CarlaHostHandle handle, const double start)
+{
+    for (;;)
+    {
+        const struct timespec delay = { 0, 5000000 };
+
+        carla_engine_idle(handle);
+        nanosleep(&delay, NULL);
+
+        const double now = get_time_in_ns();
+        __sync_synchronize();
+        const double last = gStats.lastCallback;
+
+        if (now - start > kMaxWaitTime)
+            return -1.0;
+        if (last >= start && now - last > kSettleTime)
+            return last - start;
+        if (last < start && now - start > kSettleTime)
+            return 0.0;
+    }
+}
+
+static void print_stats(const char* const name, const double settle, const uint expected)
+{
+    printf("%-10s %6u %6u %7u %7u %6u %7u %10.2f%s\n",
+           name, gStats.clientsAdded, gStats.clientsRemoved, gStats.portsAdded, gStats.portsRemoved,
+           gStats.connections, gStats.bursts, settle / 1e6,
+           gStats.portsAdded + gStats.portsRemoved == expected ? "" : "  (unexpected port count)");
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+static bool run_round(const CarlaHostHandle handle, const uint round,
+                      const uint numClients, const uint numPorts, const uint numTransient)
+{
+    jack_client_t* clients[MAX_CLIENTS];
+    char name[64];
+    double start, settle;
+
+    /* 1: clients coming up with many ports */
+    memset(&gStats, 0, sizeof(gStats));
+    start = get_time_in_ns();
+
+    for (uint i = 0; i < numClients; ++i)
+    {
+        snprintf(name, sizeof(name), "churn-%u-%u", round, i);
+
+        clients[i] = gJack.client_open(name, JACK_NO_START_SERVER, NULL);
+
+        if (clients[i] == NULL)
+        {
+            fprintf(stderr, "failed to open JACK client '%s'\n", name);
+            while (i != 0)
+                gJack.client_close(clients[--i]);
+            return false;
+        }
+
+        for (uint j = 0; j < numPorts; ++j)
+        {
+            snprintf(name, sizeof(name), "out_%u", j + 1);
+            gJack.port_register(clients[i], name, JACK_AUDIO_TYPE, JACK_PORT_IS_OUTPUT, 0);
+        }
+
+        gJack.activate(clients[i]);
+    }
+
+    settle = wait_for_settle(handle, start);
+    print_stats("register", settle, numClients * numPorts);
+
+    /* 2: ports that only exist for a moment, none of them should show up in the patchbay */
+    memset(&gStats, 0, sizeof(gStats));
+    start = get_time_in_ns();
+
+    for (uint i = 0; i < numTransient; ++i)
+    {
+        jack_client_t* const client = clients[i % numClients];
+        jack_port_t* port;
+
+        snprintf(name, sizeof(name), "transient_%u", i + 1);
+
+        if ((port = gJack.port_register(client, name, JACK_AUDIO_TYPE, JACK_PORT_IS_OUTPUT, 0)) != NULL)
+            gJack.port_unregister(client, port);
+    }
+
+    settle = wait_for_settle(handle, start);
+    print_stats("transient", settle, 0);
+
+    /* 3: clients going away again */
+    memset(&gStats, 0, sizeof(gStats));
+    start = get_time_in_ns();
+
+    for (uint i = 0; i < numClients; ++i)
+        gJack.client_close(clients[i]);
+
+    settle = wait_for_settle(handle, start);
+    print_stats("close", settle, numClients * numPorts);
+
+    return true;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
+
+int main(int argc, char* argv[])
+{
+    uint numClients = 8, numPorts = 64, numTransient = 256, numRounds = 3;
+    CarlaHostHandle handle;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:p:t:r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'c': numClients = (uint)atoi(optarg); break;
+        case 'p': numPorts = (uint)atoi(optarg); break;
+        case 't': numTransient = (uint)atoi(optarg); break;
+        case 'r': numRounds = (uint)atoi(optarg); break;
+        default:
+            fprintf(stderr, "Usage: %s [-c clients] [-p ports-per-client] [-t transient-ports] [-r rounds]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (numClients == 0 || numClients > MAX_CLIENTS)
+    {
+        fprintf(stderr, "client count must be between 1 and %u\n", MAX_CLIENTS);
+        return 1;
+    }
+
+    if (! load_jack())
+    {
+        fprintf(stderr, "libjack is not available, nothing to benchmark\n");
+        return 0;
+    }
+
+    handle = carla_standalone_host_init();
+    carla_set_engine_callback(handle, engine_callback, NULL);
+    carla_set_engine_option(handle, ENGINE_OPTION_PROCESS_MODE, ENGINE_PROCESS_MODE_MULTIPLE_CLIENTS, NULL);
+    carla_set_engine_option(handle, ENGINE_OPTION_TRANSPORT_MODE, ENGINE_TRANSPORT_MODE_INTERNAL, "");
+
+    if (! carla_engine_init(handle, "JACK", "Carla-Churn"))
+    {
+        fprintf(stderr, "carla_engine_init failed, is the JACK server running? %s\n", carla_get_last_error(handle));
+        return 0;
+    }
+
+    /* let the initial patchbay state through first */
+    wait_for_settle(handle, get_time_in_ns());
+
+    printf("%u clients x %u ports, %u transient ports per round\n", numClients, numPorts, numTransient);
+    printf("%-10s %6s %6s %7s %7s %6s %7s %10s\n",
+           "phase", "+cli", "-cli", "+ports", "-ports", "conns", "bursts", "settle ms");
+
+    for (uint i = 0; i < numRounds; ++i)
+        if (! run_round(handle, i, numClients, numPorts, numTransient))
+            break;
+
+    carla_engine_close(handle);
+    dlclose(gJack.lib);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------------------------------------------------ */
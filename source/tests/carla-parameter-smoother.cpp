@@ -0,0 +1,101 @@
+/*
+ * Carla parameter smoother test
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+/*
+ * Checks that values set outside of a ramp (UI, OSC, programs and presets) are kept by PluginParameterSmoother,
+ * instead of being overwritten by the ramp that was running at the time.
+ */
+
+#include "CarlaPluginInternal.hpp"
+
+#include <cassert>
+
+CARLA_BACKEND_USE_NAMESPACE
+
+// -----------------------------------------------------------------------
+
+static const uint32_t kRampFrames = 128;
+
+static void startRamp(PluginParameterSmoother& smoother, float* const buffer)
+{
+    buffer[0] = 0.0f;
+
+    const bool smoothed = smoother.setTarget(0, 1.0f);
+    assert(smoothed);
+    smoother.advance(kRampFrames / 2);
+    assert(smoother.isRamping());
+    assert(carla_isEqual(buffer[0], 0.5f));
+}
+
+int main()
+{
+    PluginParameterData param;
+    param.createNew(2, false);
+
+    for (uint32_t i=0; i < param.count; ++i)
+    {
+        param.data[i].type  = PARAMETER_INPUT;
+        param.data[i].hints = PARAMETER_IS_ENABLED|PARAMETER_IS_AUTOMATABLE;
+    }
+
+    float buffer[2] = { 0.0f, 0.0f };
+
+    PluginParameterSmoother smoother;
+    smoother.createNew(param, buffer, kRampFrames);
+    assert(smoother.count == 2);
+
+    // value set mid-ramp sticks
+    startRamp(smoother, buffer);
+    buffer[0] = 0.2f;
+    smoother.cancel(0, 0.2f);
+    smoother.advance(kRampFrames);
+    assert(! smoother.isRamping());
+    assert(carla_isEqual(buffer[0], 0.2f));
+
+    // same, when the audio thread advanced the ramp in between writing the value and cancelling
+    startRamp(smoother, buffer);
+    buffer[0] = 0.3f;
+    smoother.advance(kRampFrames / 4);
+    smoother.cancel(0, 0.3f);
+    smoother.advance(kRampFrames);
+    assert(! smoother.isRamping());
+    assert(carla_isEqual(buffer[0], 0.3f));
+
+    // automation after the value replaces it
+    startRamp(smoother, buffer);
+    smoother.cancel(0, 0.4f);
+    smoother.setTarget(0, 0.0f);
+    smoother.advance(kRampFrames);
+    assert(carla_isEqual(buffer[0], 0.0f));
+
+    // program changes keep the values set by the plugin
+    startRamp(smoother, buffer);
+    buffer[0] = 0.7f;
+    smoother.cancelAll();
+    smoother.advance(kRampFrames);
+    assert(! smoother.isRamping());
+    assert(carla_isEqual(buffer[0], 0.7f));
+
+    // the other parameter is never touched
+    assert(carla_isEqual(buffer[1], 0.0f));
+
+    smoother.clear();
+    param.clear();
+    return 0;
+}
+
+// -----------------------------------------------------------------------
@@ -48,6 +48,8 @@ const char* PluginOption2Str(const uint option) noexcept
         return "PLUGIN_OPTION_SEND_PITCHBEND";
     case PLUGIN_OPTION_SEND_ALL_SOUND_OFF:
         return "PLUGIN_OPTION_SEND_ALL_SOUND_OFF";
+    case PLUGIN_OPTION_FORCE_STEREO_SINGLE_INSTANCE:
+        return "PLUGIN_OPTION_FORCE_STEREO_SINGLE_INSTANCE";
     }
 
     carla_stderr("CarlaBackend::PluginOption2Str(%i) - invalid option", option);
@@ -325,6 +327,10 @@ const char* EngineCallbackOpcode2Str(const EngineCallbackOpcode opcode) noexcept
         return "ENGINE_CALLBACK_PATCHBAY_CLIENT_POSITION_CHANGED";
     case ENGINE_CALLBACK_EMBED_UI_RESIZED:
         return "ENGINE_CALLBACK_EMBED_UI_RESIZED";
+    case ENGINE_CALLBACK_BRIDGE_HEALTH_WARNING:
+        return "ENGINE_CALLBACK_BRIDGE_HEALTH_WARNING";
+    case ENGINE_CALLBACK_RENDER_PROGRESS:
+        return "ENGINE_CALLBACK_RENDER_PROGRESS";
     }
 
     carla_stderr("CarlaBackend::EngineCallbackOpcode2Str(%i) - invalid opcode", opcode);
@@ -414,6 +420,18 @@ const char* EngineOption2Str(const EngineOption option) noexcept
         return "ENGINE_OPTION_CLIENT_NAME_PREFIX";
     case ENGINE_OPTION_PLUGINS_ARE_STANDALONE:
         return "ENGINE_OPTION_PLUGINS_ARE_STANDALONE";
+    case ENGINE_OPTION_RESTART_HUNG_BRIDGES:
+        return "ENGINE_OPTION_RESTART_HUNG_BRIDGES";
+    case ENGINE_OPTION_RESIDENT_JACK_APPS:
+        return "ENGINE_OPTION_RESIDENT_JACK_APPS";
+    case ENGINE_OPTION_OFFLINE_PIPELINE:
+        return "ENGINE_OPTION_OFFLINE_PIPELINE";
+    case ENGINE_OPTION_FLUIDSYNTH_CPU_CORES:
+        return "ENGINE_OPTION_FLUIDSYNTH_CPU_CORES";
+    case ENGINE_OPTION_LOCK_MEMORY:
+        return "ENGINE_OPTION_LOCK_MEMORY";
+    case ENGINE_OPTION_PARAMETER_SMOOTHING_TIME:
+        return "ENGINE_OPTION_PARAMETER_SMOOTHING_TIME";
     }
 
     carla_stderr("CarlaBackend::EngineOption2Str(%i) - invalid option", option);
@@ -24,7 +24,7 @@
 #define CARLA_PLUGIN_BRIDGE_API_VERSION_MINIMUM 6
 
 // current API version, bumped when something is added
-#define CARLA_PLUGIN_BRIDGE_API_VERSION_CURRENT 9
+#define CARLA_PLUGIN_BRIDGE_API_VERSION_CURRENT 11
 
 // -------------------------------------------------------------------------------------------------------------------
 
@@ -81,6 +81,8 @@ enum PluginBridgeNonRtClientOpcode {
     kPluginBridgeNonRtClientSetWindowTitle,                 // uint/size, str[]
     // stuff added in API 9
     kPluginBridgeNonRtClientEmbedUI,                        // ulong
+    // stuff added in API 11
+    kPluginBridgeNonRtClientGetParameterInfo,
 };
 
 // Client sends these to server during non-RT
@@ -120,6 +122,8 @@ enum PluginBridgeNonRtServerOpcode {
     // stuff added in API 9
     kPluginBridgeNonRtServerRespEmbedUI,        // ulong
     kPluginBridgeNonRtServerResizeEmbedUI,      // uint/width, uint/height
+    // stuff added in API 11
+    kPluginBridgeNonRtServerParameterInfoDone,
 };
 
 // used for kPluginBridgeNonRtServerPortName
@@ -164,6 +168,17 @@ struct BridgeTimeInfo {
     double tick, barStartTick, ticksPerBeat, beatsPerMinute;
 };
 
+// written by the client after each processed block, read by the server (added in API 10)
+// NOTE: needs to be 64bit aligned
+struct BridgeRtClientTelemetry {
+    uint64_t blockCount;      // number of processed blocks since the bridge started
+    uint64_t processTime;     // time spent processing the last block, in microseconds
+    uint64_t maxProcessTime;  // worst time spent processing a single block, in microseconds
+    uint64_t missedDeadlines; // number of blocks that took longer to process than their own duration
+    uint64_t minorFaults;     // page faults on the client process thread, accumulated
+    uint64_t majorFaults;
+};
+
 // -------------------------------------------------------------------------------------------------------------------
 
 #endif // CARLA_BRIDGE_DEFINES_HPP_INCLUDED
@@ -129,6 +129,8 @@ const char* PluginBridgeNonRtClientOpcode2str(const PluginBridgeNonRtClientOpcod
         return "kPluginBridgeNonRtClientSetWindowTitle";
     case kPluginBridgeNonRtClientEmbedUI:
         return "kPluginBridgeNonRtClientEmbedUI";
+    case kPluginBridgeNonRtClientGetParameterInfo:
+        return "kPluginBridgeNonRtClientGetParameterInfo";
     }
 
     carla_stderr("CarlaBackend::PluginBridgeNonRtClientOpcode2str(%i) - invalid opcode", opcode);
@@ -206,6 +208,8 @@ const char* PluginBridgeNonRtServerOpcode2str(const PluginBridgeNonRtServerOpcod
         return "kPluginBridgeNonRtServerRespEmbedUI";
     case kPluginBridgeNonRtServerResizeEmbedUI:
         return "kPluginBridgeNonRtServerResizeEmbedUI";
+    case kPluginBridgeNonRtServerParameterInfoDone:
+        return "kPluginBridgeNonRtServerParameterInfoDone";
     }
 
     carla_stderr("CarlaBackend::PluginBridgeNonRtServerOpcode2str%i) - invalid opcode", opcode);
@@ -221,6 +225,7 @@ static const std::size_t kBridgeBaseMidiOutHeaderSize   = 6U /* time, port and s
 struct BridgeRtClientData {
     BridgeSemaphore sem;
     BridgeTimeInfo timeInfo;
+    BridgeRtClientTelemetry telemetry;
     SmallStackBuffer ringBuffer;
     uint8_t midiOut[kBridgeRtClientDataMidiOutSize];
     uint32_t procFlags;
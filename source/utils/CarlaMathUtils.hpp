@@ -23,6 +23,10 @@
 #include <cmath>
 #include <limits>
 
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
 // --------------------------------------------------------------------------------------------------------------------
 // math functions (base)
 
@@ -299,6 +303,177 @@ void carla_multiply(float data[], const float& multiplier, const std::size_t cou
     }
 }
 
+// --------------------------------------------------------------------------------------------------------------------
+// audio buffer conversions, with SSE2 paths for the common cases
+
+/*
+ * Interleave separate channel buffers into a single one.
+ */
+static inline
+void carla_interleaveFloats(float dest[], const float* const src[], const uint numChannels, const std::size_t frames) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(dest != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(src != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(numChannels > 0,);
+
+    // empty buffers are valid, return quietly as these run on realtime threads
+    if (frames == 0)
+        return;
+
+    switch (numChannels)
+    {
+    case 1:
+        std::memcpy(dest, src[0], frames*sizeof(float));
+        return;
+
+    case 2: {
+        const float* const src0 = src[0];
+        const float* const src1 = src[1];
+        std::size_t i = 0;
+
+#ifdef __SSE2__
+        for (; i+4 <= frames; i += 4)
+        {
+            const __m128 l = _mm_loadu_ps(src0 + i);
+            const __m128 r = _mm_loadu_ps(src1 + i);
+            _mm_storeu_ps(dest + i*2,     _mm_unpacklo_ps(l, r));
+            _mm_storeu_ps(dest + i*2 + 4, _mm_unpackhi_ps(l, r));
+        }
+#endif
+
+        for (; i<frames; ++i)
+        {
+            dest[i*2]   = src0[i];
+            dest[i*2+1] = src1[i];
+        }
+        return;
+    }
+    }
+
+    for (uint c=0; c<numChannels; ++c)
+    {
+        const float* const srcc = src[c];
+
+        for (std::size_t i=0; i<frames; ++i)
+            dest[i*numChannels+c] = srcc[i];
+    }
+}
+
+/*
+ * Split an interleaved buffer into separate channel buffers.
+ */
+static inline
+void carla_deinterleaveFloats(float* const dest[], const float src[], const uint numChannels, const std::size_t frames) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(dest != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(src != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(numChannels > 0,);
+
+    if (frames == 0)
+        return;
+
+    switch (numChannels)
+    {
+    case 1:
+        std::memcpy(dest[0], src, frames*sizeof(float));
+        return;
+
+    case 2: {
+        float* const dest0 = dest[0];
+        float* const dest1 = dest[1];
+        std::size_t i = 0;
+
+#ifdef __SSE2__
+        for (; i+4 <= frames; i += 4)
+        {
+            const __m128 a = _mm_loadu_ps(src + i*2);
+            const __m128 b = _mm_loadu_ps(src + i*2 + 4);
+            _mm_storeu_ps(dest0 + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(dest1 + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+#endif
+
+        for (; i<frames; ++i)
+        {
+            dest0[i] = src[i*2];
+            dest1[i] = src[i*2+1];
+        }
+        return;
+    }
+    }
+
+    for (uint c=0; c<numChannels; ++c)
+    {
+        float* const destc = dest[c];
+
+        for (std::size_t i=0; i<frames; ++i)
+            destc[i] = src[i*numChannels+c];
+    }
+}
+
+/*
+ * Convert float samples to signed 16bit integers, clipping to the -1..1 range.
+ */
+static inline
+void carla_convertFloatsToInt16(int16_t dest[], const float src[], const std::size_t count) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(dest != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(src != nullptr,);
+
+    if (count == 0)
+        return;
+
+    std::size_t i = 0;
+
+#ifdef __SSE2__
+    const __m128 vmin  = _mm_set1_ps(-1.0f);
+    const __m128 vmax  = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(32767.0f);
+
+    for (; i+8 <= count; i += 8)
+    {
+        const __m128 a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i),     vmin), vmax), scale);
+        const __m128 b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), vmin), vmax), scale);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+    }
+#endif
+
+    for (; i<count; ++i)
+        dest[i] = static_cast<int16_t>(lrintf(carla_fixedValue(-1.0f, 1.0f, src[i]) * 32767.0f));
+}
+
+/*
+ * Convert signed 16bit integer samples to floats.
+ */
+static inline
+void carla_convertInt16ToFloats(float dest[], const int16_t src[], const std::size_t count) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(dest != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(src != nullptr,);
+
+    if (count == 0)
+        return;
+
+    static const float kScale = 1.0f / 32768.0f;
+    std::size_t i = 0;
+
+#ifdef __SSE2__
+    const __m128 scale = _mm_set1_ps(kScale);
+
+    for (; i+8 <= count; i += 8)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(dest + i,     _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(dest + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+#endif
+
+    for (; i<count; ++i)
+        dest[i] = static_cast<float>(src[i]) * kScale;
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 // Missing functions in old OSX versions.
 
@@ -158,6 +158,17 @@ public:
         return wrap + fBuffer->tail - fBuffer->wrtn;
     }
 
+    uint32_t getReadableDataSize() const noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fBuffer != nullptr, 0);
+
+        const uint32_t head(fBuffer->head);
+        const uint32_t tail(fBuffer->tail);
+        const uint32_t wrap((head >= tail) ? 0 : fBuffer->size);
+
+        return wrap + head - tail;
+    }
+
     // -------------------------------------------------------------------
 
     bool readBool() noexcept
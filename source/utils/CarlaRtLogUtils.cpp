@@ -0,0 +1,342 @@
+/*
+ * Carla realtime-safe logging
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaRtLogUtils.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// -----------------------------------------------------------------------
+// CarlaRtLogger argument capture and formatting
+
+static bool isDigit(const char c) noexcept
+{
+    return c >= '0' && c <= '9';
+}
+
+const char* CarlaRtLogger::parseSpec(const char* c, Spec& spec) noexcept
+{
+    spec.flags = c;
+    while (*c == '-' || *c == '+' || *c == ' ' || *c == '#' || *c == '0')
+        ++c;
+    spec.flagsLen = static_cast<uint>(c - spec.flags);
+
+    spec.width = c;
+    if ((spec.widthArg = (*c == '*')))
+        ++c;
+    else
+        while (isDigit(*c)) ++c;
+    spec.widthLen = static_cast<uint>(c - spec.width);
+
+    spec.precisionArg = false;
+    if ((spec.hasPrecision = (*c == '.')))
+        ++c;
+    spec.precision = c;
+    if (spec.hasPrecision)
+    {
+        if ((spec.precisionArg = (*c == '*')))
+            ++c;
+        else
+            while (isDigit(*c)) ++c;
+    }
+    spec.precisionLen = static_cast<uint>(c - spec.precision);
+
+    switch (*c)
+    {
+    case 'h':
+        spec.length = (c[1] == 'h') ? kLengthHH : kLengthH;
+        c += (c[1] == 'h') ? 2 : 1;
+        break;
+    case 'l':
+        spec.length = (c[1] == 'l') ? kLengthLL : kLengthL;
+        c += (c[1] == 'l') ? 2 : 1;
+        break;
+    case 'q': spec.length = kLengthLL; ++c; break;
+    case 'j': spec.length = kLengthJ; ++c; break;
+    case 'z': spec.length = kLengthZ; ++c; break;
+    case 't': spec.length = kLengthT; ++c; break;
+    case 'L': spec.length = kLengthLongDouble; ++c; break;
+    default:  spec.length = kLengthNone; break;
+    }
+
+    spec.conversion = *c;
+    return *c != '\0' ? c + 1 : c;
+}
+
+const char* CarlaRtLogger::capture(Record& record, const char* const fmt, ::va_list args) noexcept
+{
+    uint32_t argc = 0, stringPos = 0;
+    Spec spec;
+
+    for (const char* c = fmt; *c != '\0';)
+    {
+        if (*c++ != '%')
+            continue;
+        if (*c == '%')
+        {
+            ++c;
+            continue;
+        }
+
+        const char* const start = c - 1;
+        c = parseSpec(c, spec);
+
+        if (argc + (spec.widthArg ? 1 : 0) + (spec.precisionArg ? 1 : 0) + 1 > kMaxArgs)
+            return start;
+
+        if (spec.widthArg)
+            record.args[argc++].i = va_arg(args, int);
+
+        int precision = -1;
+        if (spec.precisionArg)
+        {
+            precision = va_arg(args, int);
+            record.args[argc++].i = precision;
+        }
+        else if (spec.hasPrecision)
+        {
+            precision = 0;
+            for (uint i=0; i < spec.precisionLen && precision < static_cast<int>(kRecordSize); ++i)
+                precision = precision * 10 + (spec.precision[i] - '0');
+        }
+
+        Arg& arg(record.args[argc]);
+
+        switch (spec.conversion)
+        {
+        case 'd':
+        case 'i':
+            switch (spec.length)
+            {
+            case kLengthHH: arg.i = static_cast<signed char>(va_arg(args, int)); break;
+            case kLengthH:  arg.i = static_cast<short>(va_arg(args, int)); break;
+            case kLengthL:  arg.i = va_arg(args, long); break;
+            case kLengthLL: arg.i = va_arg(args, long long); break;
+            case kLengthJ:  arg.i = va_arg(args, std::intmax_t); break;
+            case kLengthZ:  arg.i = static_cast<std::ptrdiff_t>(va_arg(args, std::size_t)); break;
+            case kLengthT:  arg.i = va_arg(args, std::ptrdiff_t); break;
+            case kLengthNone: arg.i = va_arg(args, int); break;
+            default: return start;
+            }
+            break;
+
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            switch (spec.length)
+            {
+            case kLengthHH: arg.u = static_cast<unsigned char>(va_arg(args, uint)); break;
+            case kLengthH:  arg.u = static_cast<unsigned short>(va_arg(args, uint)); break;
+            case kLengthL:  arg.u = va_arg(args, unsigned long); break;
+            case kLengthLL: arg.u = va_arg(args, unsigned long long); break;
+            case kLengthJ:  arg.u = va_arg(args, std::uintmax_t); break;
+            case kLengthZ:  arg.u = va_arg(args, std::size_t); break;
+            case kLengthT:  arg.u = static_cast<std::size_t>(va_arg(args, std::ptrdiff_t)); break;
+            case kLengthNone: arg.u = va_arg(args, uint); break;
+            default: return start;
+            }
+            break;
+
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            if (spec.length == kLengthLongDouble)
+                arg.ld = va_arg(args, long double);
+            else if (spec.length == kLengthNone || spec.length == kLengthL)
+                arg.d = va_arg(args, double);
+            else
+                return start;
+            break;
+
+        case 'c':
+            if (spec.length != kLengthNone)
+                return start;
+            arg.i = va_arg(args, int);
+            break;
+
+        case 's':
+            if (spec.length != kLengthNone)
+                return start;
+            if (const char* const str = va_arg(args, const char*))
+            {
+                if (stringPos + 1 >= kRecordSize)
+                    return start;
+
+                char* const dst = record.strings + stringPos;
+                uint32_t len = 0;
+
+                for (; str[len] != '\0' && stringPos + len + 1 < kRecordSize; ++len)
+                {
+                    if (precision >= 0 && len >= static_cast<uint32_t>(precision))
+                        break;
+                    dst[len] = str[len];
+                }
+
+                dst[len] = '\0';
+                stringPos += len + 1;
+                arg.p = dst;
+            }
+            else
+            {
+                arg.p = "(null)";
+            }
+            break;
+
+        case 'p':
+            arg.p = va_arg(args, const void*);
+            break;
+
+        case 'n':
+            // nothing to write back to, skip it
+            (void)va_arg(args, void*);
+            continue;
+
+        default:
+            return start;
+        }
+
+        ++argc;
+    }
+
+    return nullptr;
+}
+
+#if defined(__clang__)
+# pragma clang diagnostic push
+# pragma clang diagnostic ignored "-Wformat-nonliteral"
+#elif defined(__GNUC__)
+# pragma GCC diagnostic push
+# pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#endif
+void CarlaRtLogger::format(const Record& record, char* const out, const std::size_t outSize) noexcept
+{
+    std::size_t pos = 0;
+    uint32_t argc = 0;
+    Spec spec;
+
+    for (const char* c = record.fmt; *c != '\0' && pos + 1 < outSize;)
+    {
+        if (c == record.stop)
+        {
+            std::snprintf(out + pos, outSize - pos, "%s [...]", c);
+            return;
+        }
+
+        if (*c != '%')
+        {
+            out[pos++] = *c++;
+            continue;
+        }
+        if (*++c == '%')
+        {
+            out[pos++] = *c++;
+            continue;
+        }
+
+        c = parseSpec(c, spec);
+
+        if (spec.conversion == 'n')
+            continue;
+
+        // rebuild the conversion with its arguments inlined and a fixed length modifier
+        char fspec[64];
+        std::size_t flen = 0;
+
+        fspec[flen++] = '%';
+        std::memcpy(fspec + flen, spec.flags, std::min<std::size_t>(spec.flagsLen, 8));
+        flen += std::min<std::size_t>(spec.flagsLen, 8);
+
+        if (spec.widthArg)
+            flen += static_cast<std::size_t>(std::snprintf(fspec + flen, 16, "%lld", record.args[argc++].i));
+        else if (spec.widthLen != 0)
+            flen += static_cast<std::size_t>(std::snprintf(fspec + flen, 16, "%.*s",
+                                                           static_cast<int>(spec.widthLen), spec.width));
+
+        if (spec.precisionArg)
+        {
+            const long long precision = record.args[argc++].i;
+            if (precision >= 0)
+                flen += static_cast<std::size_t>(std::snprintf(fspec + flen, 16, ".%lld", precision));
+        }
+        else if (spec.hasPrecision)
+        {
+            flen += static_cast<std::size_t>(std::snprintf(fspec + flen, 16, ".%.*s",
+                                                           static_cast<int>(spec.precisionLen), spec.precision));
+        }
+
+        const Arg& arg(record.args[argc++]);
+        int ret;
+
+        switch (spec.conversion)
+        {
+        case 'd':
+        case 'i':
+            std::snprintf(fspec + flen, 4, "ll%c", spec.conversion);
+            ret = std::snprintf(out + pos, outSize - pos, fspec, arg.i);
+            break;
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            std::snprintf(fspec + flen, 4, "ll%c", spec.conversion);
+            ret = std::snprintf(out + pos, outSize - pos, fspec, arg.u);
+            break;
+        case 'c':
+            std::snprintf(fspec + flen, 2, "%c", spec.conversion);
+            ret = std::snprintf(out + pos, outSize - pos, fspec, static_cast<int>(arg.i));
+            break;
+        case 's':
+        case 'p':
+            std::snprintf(fspec + flen, 2, "%c", spec.conversion);
+            ret = std::snprintf(out + pos, outSize - pos, fspec, arg.p);
+            break;
+        default:
+            if (spec.length == kLengthLongDouble)
+            {
+                std::snprintf(fspec + flen, 3, "L%c", spec.conversion);
+                ret = std::snprintf(out + pos, outSize - pos, fspec, arg.ld);
+            }
+            else
+            {
+                std::snprintf(fspec + flen, 2, "%c", spec.conversion);
+                ret = std::snprintf(out + pos, outSize - pos, fspec, arg.d);
+            }
+            break;
+        }
+
+        if (ret < 0)
+            break;
+
+        pos = std::min(pos + static_cast<std::size_t>(ret), outSize - 1);
+    }
+
+    out[std::min(pos, outSize - 1)] = '\0';
+}
+
+#if defined(__clang__)
+# pragma clang diagnostic pop
+#elif defined(__GNUC__)
+# pragma GCC diagnostic pop
+#endif
+
+// -----------------------------------------------------------------------
@@ -0,0 +1,318 @@
+/*
+ * Carla realtime-safe logging
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_RT_LOG_UTILS_HPP_INCLUDED
+#define CARLA_RT_LOG_UTILS_HPP_INCLUDED
+
+#include "CarlaThread.hpp"
+
+#include <cstdint>
+
+// -----------------------------------------------------------------------
+// CarlaRtLogger class
+
+/*
+ * Logger for realtime threads.
+ * Messages are queued as fixed-size records of a lock-free ring, which any number of threads may write to.
+ * A record keeps the format string and a copy of its arguments, formatting happens later on a background thread,
+ * which prints messages with the regular stdio functions.
+ * At most kMaxRecordsPerPeriod messages are taken per flush period, the rest are counted and reported as suppressed.
+ */
+class CarlaRtLogger : private CarlaThread
+{
+public:
+    static const uint32_t kRecordCount = 256; // must be power of 2
+    static const uint32_t kRecordSize = 256;
+    static const uint32_t kMaxArgs = 16;
+    static const uint32_t kMaxRecordsPerPeriod = 32;
+    static const uint     kFlushPeriodMs = 100;
+
+    CarlaRtLogger() noexcept
+        : CarlaThread("CarlaRtLogger"),
+          fWritePos(0),
+          fReadPos(0),
+          fTaken(0),
+          fSuppressed(0),
+          fTotalSuppressed(0)
+    {
+        for (uint32_t i=0; i < kRecordCount; ++i)
+        {
+            fRecords[i].sequence = i;
+            fRecords[i].level = 0;
+            fRecords[i].fmt = nullptr;
+            fRecords[i].stop = nullptr;
+        }
+    }
+
+    ~CarlaRtLogger()
+    {
+        stop();
+    }
+
+    void start()
+    {
+        startThread();
+    }
+
+    /*
+     * Stop the background thread, printing any pending messages.
+     */
+    void stop()
+    {
+        stopThread(-1);
+        flush();
+    }
+
+    /*
+     * Total number of messages suppressed or dropped so far.
+     */
+    uint32_t getSuppressedCount() const noexcept
+    {
+        return fTotalSuppressed + fSuppressed;
+    }
+
+    // -------------------------------------------------------------------
+
+    /*
+     * Queue a message. Never blocks or allocates.
+     * The format string is only read again when printing, so it must be a string literal.
+     * String arguments are copied, up to kRecordSize bytes per message.
+     */
+    void log(const int level, const char* const fmt, ::va_list args) noexcept
+    {
+        if (__sync_fetch_and_add(&fTaken, 1) >= kMaxRecordsPerPeriod)
+        {
+            __sync_add_and_fetch(&fSuppressed, 1);
+            return;
+        }
+
+        Record* record;
+        uint32_t pos = fWritePos;
+
+        for (;;)
+        {
+            record = &fRecords[pos & (kRecordCount - 1)];
+
+            const uint32_t sequence = record->sequence;
+            __sync_synchronize();
+
+            const int32_t diff = static_cast<int32_t>(sequence - pos);
+
+            if (diff == 0)
+            {
+                const uint32_t prevPos = __sync_val_compare_and_swap(&fWritePos, pos, pos + 1);
+
+                if (prevPos == pos)
+                    break;
+
+                pos = prevPos;
+            }
+            else if (diff < 0)
+            {
+                // ring is full
+                __sync_add_and_fetch(&fSuppressed, 1);
+                return;
+            }
+            else
+            {
+                pos = fWritePos;
+            }
+        }
+
+        record->level = level;
+        record->fmt = fmt;
+        record->stop = capture(*record, fmt, args);
+
+        __sync_synchronize();
+        record->sequence = pos + 1;
+    }
+
+    /*
+     * Install this logger as log redirection of the current thread, for the lifetime of a scope.
+     */
+    class ScopedRedirect
+    {
+    public:
+        ScopedRedirect(CarlaRtLogger& logger) noexcept
+#ifdef CARLA_RT_LOG_HOOK_AVAILABLE
+            : fPrevHook(carla_rt_log_hook())
+        {
+            CarlaRtLogHook& hook(carla_rt_log_hook());
+            hook.func = _log;
+            hook.ptr  = &logger;
+        }
+#else
+        {
+            // unused
+            (void)logger;
+        }
+#endif
+
+        ~ScopedRedirect() noexcept
+        {
+#ifdef CARLA_RT_LOG_HOOK_AVAILABLE
+            carla_rt_log_hook() = fPrevHook;
+#endif
+        }
+
+    private:
+#ifdef CARLA_RT_LOG_HOOK_AVAILABLE
+        const CarlaRtLogHook fPrevHook;
+#endif
+
+        CARLA_PREVENT_HEAP_ALLOCATION
+        CARLA_DECLARE_NON_COPYABLE(ScopedRedirect)
+    };
+
+protected:
+    void run() override
+    {
+        while (! shouldThreadExit())
+        {
+            flush();
+            carla_msleep(kFlushPeriodMs);
+        }
+    }
+
+private:
+    union Arg {
+        long long i;
+        unsigned long long u;
+        double d;
+        long double ld;
+        const void* p;
+    };
+
+    struct Record {
+        volatile uint32_t sequence;
+        int level;
+        const char* fmt;
+        const char* stop; // where capture gave up, null if all arguments were taken
+        Arg args[kMaxArgs];
+        char strings[kRecordSize];
+    };
+
+    enum Length {
+        kLengthNone,
+        kLengthHH,
+        kLengthH,
+        kLengthL,
+        kLengthLL,
+        kLengthJ,
+        kLengthZ,
+        kLengthT,
+        kLengthLongDouble
+    };
+
+    // a single conversion, parsed the same way when capturing and when formatting
+    struct Spec {
+        const char* flags;
+        uint flagsLen;
+        const char* width;
+        uint widthLen;
+        bool widthArg;
+        bool hasPrecision;
+        const char* precision;
+        uint precisionLen;
+        bool precisionArg;
+        Length length;
+        char conversion;
+    };
+
+    Record fRecords[kRecordCount];
+
+    volatile uint32_t fWritePos;
+    uint32_t fReadPos; // only used by the flushing thread
+    volatile uint32_t fTaken;
+    volatile uint32_t fSuppressed;
+    uint32_t fTotalSuppressed;
+
+    // -------------------------------------------------------------------
+
+    /*
+     * Parse a conversion, starting right after its '%'.
+     * Returns a pointer past the conversion character.
+     */
+    static const char* parseSpec(const char* c, Spec& spec) noexcept;
+
+    /*
+     * Copy the arguments of a message into its record, on the logging thread.
+     * Returns where in the format string capture stopped, null if it went through all of it.
+     */
+    static const char* capture(Record& record, const char* fmt, ::va_list args) noexcept;
+
+    /*
+     * Format a queued message, on the flushing thread.
+     */
+    static void format(const Record& record, char* out, std::size_t outSize) noexcept;
+
+    void flush() noexcept
+    {
+        char message[kRecordSize * 2];
+
+        for (;;)
+        {
+            Record& record(fRecords[fReadPos & (kRecordCount - 1)]);
+
+            const uint32_t sequence = record.sequence;
+            __sync_synchronize();
+
+            if (static_cast<int32_t>(sequence - (fReadPos + 1)) < 0)
+                break;
+
+            format(record, message, sizeof(message));
+
+            switch (record.level)
+            {
+            case 0:
+                carla_stdout("%s", message);
+                break;
+            case 1:
+                carla_stderr("%s", message);
+                break;
+            default:
+                carla_stderr2("%s", message);
+                break;
+            }
+
+            __sync_synchronize();
+            record.sequence = fReadPos + kRecordCount;
+            ++fReadPos;
+        }
+
+        if (const uint32_t suppressed = __sync_fetch_and_and(&fSuppressed, 0))
+        {
+            fTotalSuppressed += suppressed;
+            carla_stderr2("%u realtime log messages suppressed (%u in total)", suppressed, fTotalSuppressed);
+        }
+
+        // start a new period, keeping whatever writers took since reading the counter
+        const uint32_t taken = fTaken;
+        __sync_sub_and_fetch(&fTaken, taken);
+    }
+
+    static void _log(void* const ptr, const int level, const char* const fmt, ::va_list args) noexcept
+    {
+        static_cast<CarlaRtLogger*>(ptr)->log(level, fmt, args);
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(CarlaRtLogger)
+};
+
+// -----------------------------------------------------------------------
+
+#endif // CARLA_RT_LOG_UTILS_HPP_INCLUDED
@@ -0,0 +1,54 @@
+/*
+ * Carla time utils
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_TIME_UTILS_HPP_INCLUDED
+#define CARLA_TIME_UTILS_HPP_INCLUDED
+
+#include "CarlaUtils.hpp"
+
+#include <ctime>
+#include <sys/time.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+
+/*
+ * Get the current time in microseconds, for measuring elapsed time.
+ * Uses a monotonic clock where available, the value has no meaning on its own.
+ */
+static inline
+int64_t carla_gettime_us() noexcept
+{
+#if defined(CARLA_OS_MAC) || defined(CARLA_OS_WIN)
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+
+    return (static_cast<int64_t>(tv.tv_sec) * 1000000) + tv.tv_usec;
+#else
+    struct timespec ts;
+# ifdef CLOCK_MONOTONIC_RAW
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+# else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+# endif
+
+    return (static_cast<int64_t>(ts.tv_sec) * 1000000) + (ts.tv_nsec / 1000);
+#endif
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#endif // CARLA_TIME_UTILS_HPP_INCLUDED
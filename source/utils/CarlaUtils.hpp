@@ -68,6 +68,59 @@ void nullStrBuf(char* const strBuf) noexcept
 static inline
 void pass() noexcept {}
 
+// --------------------------------------------------------------------------------------------------------------------
+// realtime log redirection
+
+/*
+ * Per-thread redirection of carla_stdout, carla_stderr and carla_stderr2 (and thus of safe assertions).
+ * Realtime threads install one while processing so that messages do not block on stdio, see CarlaRtLogUtils.hpp.
+ * The level is 0 for stdout, 1 for stderr and 2 for stderr2.
+ */
+typedef void (*CarlaRtLogFunc)(void* ptr, int level, const char* fmt, ::va_list args);
+
+struct CarlaRtLogHook {
+    CarlaRtLogFunc func;
+    void* ptr;
+};
+
+#if defined(CARLA_OS_MAC) && ! defined(__clang__)
+// old macOS toolchains have no thread-local storage, messages always go to stdio
+#else
+# define CARLA_RT_LOG_HOOK_AVAILABLE
+
+/*
+ * Get the log redirection of the current thread.
+ * Not static on purpose, so all translation units of a binary share it.
+ */
+inline
+CarlaRtLogHook& carla_rt_log_hook() noexcept
+{
+    static __thread CarlaRtLogHook hook = { nullptr, nullptr };
+    return hook;
+}
+#endif
+
+/*
+ * Pass a message to the log redirection of the current thread, if there is one.
+ */
+static inline
+bool carla_rt_log_redirect(const int level, const char* const fmt, ::va_list args) noexcept
+{
+#ifdef CARLA_RT_LOG_HOOK_AVAILABLE
+    const CarlaRtLogHook& hook(carla_rt_log_hook());
+
+    if (hook.func == nullptr)
+        return false;
+
+    hook.func(hook.ptr, level, fmt, args);
+    return true;
+#else
+    return false;
+    // unused
+    (void)level; (void)fmt; (void)args;
+#endif
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 // string print functions
 
@@ -148,6 +201,13 @@ void carla_stdout(const char* const fmt, ...) noexcept
     try {
         ::va_list args;
         ::va_start(args, fmt);
+
+        if (carla_rt_log_redirect(0, fmt, args))
+        {
+            ::va_end(args);
+            return;
+        }
+
         std::fprintf(output, "[carla] ");
         std::vfprintf(output, fmt, args);
         std::fprintf(output, "\n");
@@ -170,6 +230,13 @@ void carla_stderr(const char* const fmt, ...) noexcept
     try {
         ::va_list args;
         ::va_start(args, fmt);
+
+        if (carla_rt_log_redirect(1, fmt, args))
+        {
+            ::va_end(args);
+            return;
+        }
+
         std::fprintf(output, "[carla] ");
         std::vfprintf(output, fmt, args);
         std::fprintf(output, "\n");
@@ -193,6 +260,12 @@ void carla_stderr2(const char* const fmt, ...) noexcept
         ::va_list args;
         ::va_start(args, fmt);
 
+        if (carla_rt_log_redirect(2, fmt, args))
+        {
+            ::va_end(args);
+            return;
+        }
+
         if (output == stderr)
         {
             std::fprintf(output, "\x1b[31m[carla] ");